@@ -78,8 +78,27 @@ static inline bool osmo_amr_is_speech(enum osmo_amr_type ft)
 	}
 }
 
+/*! AMR SID frame types, see osmo_amr_check_sid() */
+enum osmo_amr_sid_type {
+	OSMO_AMR_SID_NONE,	/*!< no SID frame: speech, NO_DATA, ... */
+	OSMO_AMR_SID_FIRST,	/*!< SID_FIRST (STI = 0) */
+	OSMO_AMR_SID_UPDATE,	/*!< SID_UPDATE (STI = 1) */
+};
+
+/*! codecs of osmo_check_sid_batch() */
+enum osmo_sid_codec {
+	OSMO_SID_CODEC_FR,
+	OSMO_SID_CODEC_HR,
+	OSMO_SID_CODEC_EFR,
+	OSMO_SID_CODEC_AMR,
+};
+
 bool osmo_fr_check_sid(const uint8_t *rtp_payload, size_t payload_len);
 bool osmo_hr_check_sid(const uint8_t *rtp_payload, size_t payload_len);
+bool osmo_efr_check_sid(const uint8_t *rtp_payload, size_t payload_len);
+enum osmo_amr_sid_type osmo_amr_check_sid(const uint8_t *rtp_payload, size_t payload_len);
+int osmo_check_sid_batch(enum osmo_sid_codec codec, const uint8_t * const *rtp_payloads,
+			 const size_t *payload_lens, unsigned int num, bool *is_sid);
 int osmo_amr_rtp_enc(uint8_t *payload, uint8_t cmr, enum osmo_amr_type ft,
 		     enum osmo_amr_quality bfi);
 int osmo_amr_rtp_dec(const uint8_t *payload, int payload_len, uint8_t *cmr,
@@ -25,6 +25,9 @@ enum osmo_ecu_codec {
 	_NUM_OSMO_ECU_CODECS
 };
 
+/*! maximum size of a frame generated by the built-in ECUs (AMR 12.2 in RTP) */
+#define OSMO_ECU_MAX_FRAME_BYTES	33
+
 /***********************************************************************
  * Generic ECU abstraction layer below
  ***********************************************************************/
@@ -71,3 +74,22 @@ struct osmo_ecu_ops {
 };
 
 int osmo_ecu_register(const struct osmo_ecu_ops *ops, enum osmo_ecu_codec codec);
+
+/***********************************************************************
+ * Multi-channel ECU, for the built-in FR, EFR and AMR implementations
+ ***********************************************************************/
+
+/* ECU state of many channels of the same codec */
+struct osmo_ecu_batch;
+
+struct osmo_ecu_batch *osmo_ecu_batch_alloc(void *ctx, enum osmo_ecu_codec codec, unsigned int num_chans);
+void osmo_ecu_batch_free(struct osmo_ecu_batch *eb);
+void osmo_ecu_batch_reset(struct osmo_ecu_batch *eb, unsigned int chan);
+
+/* process a received frame of one channel */
+int osmo_ecu_batch_frame_in(struct osmo_ecu_batch *eb, unsigned int chan, bool bfi,
+			    const uint8_t *frame, unsigned int frame_bytes);
+
+/* generate substitute frames for a number of channels */
+unsigned int osmo_ecu_batch_conceal(struct osmo_ecu_batch *eb, const unsigned int *chans, unsigned int num,
+				    uint8_t * const *frames_out, int *lens_out);
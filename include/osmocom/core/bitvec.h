@@ -59,6 +59,7 @@ int bitvec_set_bit(struct bitvec *bv, enum bit_value bit);
 int bitvec_get_bit_high(struct bitvec *bv);
 int bitvec_set_bits(struct bitvec *bv, const enum bit_value *bits, unsigned int count);
 int bitvec_set_u64(struct bitvec *bv, uint64_t v, uint8_t num_bits, bool use_lh);
+int bitvec_get_u64(struct bitvec *bv, uint64_t *v, uint8_t num_bits, bool use_lh);
 int bitvec_set_uint(struct bitvec *bv, unsigned int in, unsigned int count);
 int bitvec_get_uint(struct bitvec *bv, unsigned int num_bits);
 int bitvec_find_bit_pos(const struct bitvec *bv, unsigned int n, enum bit_value val);
@@ -77,7 +77,8 @@ struct osmo_fsm {
 	int (*timer_cb)(struct osmo_fsm_inst *fi);
 	/*! logging sub-system for this FSM */
 	int log_subsys;
-	/*! human-readable names of events */
+	/*! human-readable names of events, indexed by osmo_fsm_register(),
+	 *  so they must not be modified or freed afterwards */
 	const struct value_string *event_names;
 	/*! graceful exit function, called at the beginning of termination */
 	void (*pre_term)(struct osmo_fsm_inst *fi, enum osmo_fsm_term_cause cause);
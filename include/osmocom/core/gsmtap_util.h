@@ -23,11 +23,27 @@ struct msgb *gsmtap_makemsg(uint16_t arfcn, uint8_t ts, uint8_t chan_type,
 			    uint8_t ss, uint32_t fn, int8_t signal_dbm,
 			    uint8_t snr, const uint8_t *data, unsigned int len);
 
+struct gsmtap_ring;
+struct osmo_pcapng_writer;
+
 /*! one gsmtap instance */
 struct gsmtap_inst {
 	int ofd_wq_mode;	/*!< wait queue mode? */
 	struct osmo_wqueue wq;	/*!< the wait queue */
 	struct osmo_fd sink_ofd;/*!< file descriptor */
+	struct gsmtap_ring *ring;	/*!< ring of messages, if any */
+	struct rate_ctr_group *ctrg;	/*!< gsmtap_ring_ctr, if there is a ring */
+	struct osmo_pcapng_writer *pcapng;	/*!< capture file writer, if any */
+};
+
+enum gsmtap_ring_ctr {
+	GSMTAP_RING_CTR_ENQUEUED,
+	GSMTAP_RING_CTR_SENT,
+	GSMTAP_RING_CTR_DROP_FULL,
+	GSMTAP_RING_CTR_DROP_LEN,
+	GSMTAP_RING_CTR_FILTERED,
+	GSMTAP_RING_CTR_SAMPLED,
+	GSMTAP_RING_CTR_TX_ERR,
 };
 
 /*! obtain the file descriptor associated with a gsmtap instance
@@ -47,6 +63,14 @@ struct gsmtap_inst *gsmtap_source_init(const char *host, uint16_t port,
 
 int gsmtap_source_add_sink(struct gsmtap_inst *gti);
 
+struct gsmtap_inst *gsmtap_source_init_ring(const char *host, uint16_t port,
+					     unsigned int num_slots, unsigned int slot_size);
+int gsmtap_ring_add_rule(struct gsmtap_inst *gti, int type, int arfcn, unsigned int one_in_n);
+int gsmtap_ring_flush(struct gsmtap_inst *gti);
+
+struct gsmtap_inst *gsmtap_source_init_pcapng(const char *path, size_t max_file_bytes,
+					       unsigned int max_files);
+
 int gsmtap_sendmsg(struct gsmtap_inst *gti, struct msgb *msg);
 
 int gsmtap_send_ex(struct gsmtap_inst *gti, uint8_t type, uint16_t arfcn, uint8_t ts,
@@ -0,0 +1,86 @@
+/*! \file loop_stats.h
+ * Main loop latency and per-callback profiling.
+ */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*! \defgroup loop_stats Main loop profiling
+ *  @{
+ * \file loop_stats.h */
+
+/*! number of log2 histogram buckets; bucket 0 counts durations below 1us,
+ *  bucket n counts [2^(n-1), 2^n) us and the last bucket everything above */
+#define OSMO_LOOP_STATS_HIST_BUCKETS	20
+/*! maximum number of distinct callbacks tracked */
+#define OSMO_LOOP_STATS_MAX_CBS		128
+
+/*! kind of main loop callback */
+enum osmo_loop_cb_type {
+	OSMO_LOOP_CB_FD,	/*!< \ref osmo_fd call-back */
+	OSMO_LOOP_CB_TIMER,	/*!< \ref osmo_timer_list call-back */
+};
+
+/*! statistics of one fd or timer call-back */
+struct osmo_loop_cb_stats {
+	enum osmo_loop_cb_type type;	/*!< kind of call-back */
+	const void *cb;			/*!< call-back function */
+	int fd;				/*!< file descriptor, -1 for timers */
+	uint64_t count;			/*!< number of invocations */
+	uint64_t total_us;		/*!< accumulated execution time */
+	uint32_t max_us;		/*!< longest execution time */
+	uint32_t slow;			/*!< invocations above the slow threshold */
+	uint32_t hist[OSMO_LOOP_STATS_HIST_BUCKETS];	/*!< execution time histogram */
+};
+
+/*! statistics of the main loop */
+struct osmo_loop_stats {
+	uint64_t iterations;		/*!< number of loop iterations */
+	uint64_t busy_us;		/*!< accumulated time spent outside of select() */
+	uint64_t wait_us;		/*!< accumulated time spent blocking in select() */
+	uint32_t busy_max_us;		/*!< longest busy period of one iteration */
+	uint32_t busy_hist[OSMO_LOOP_STATS_HIST_BUCKETS];	/*!< busy time histogram */
+	uint32_t wait_hist[OSMO_LOOP_STATS_HIST_BUCKETS];	/*!< select() wait time histogram */
+	unsigned int slow_threshold_us;	/*!< warn about call-backs running longer, 0 = never */
+	uint64_t slow;			/*!< call-backs above the slow threshold */
+	uint64_t untracked;		/*!< invocations not recorded, as \a cbs was full */
+	/*! per call-back statistics, unused entries have a \a count of 0 */
+	struct osmo_loop_cb_stats cbs[OSMO_LOOP_STATS_MAX_CBS];
+};
+
+/*! stat items of the main loop, updated once per iteration */
+enum osmo_loop_stat_item {
+	OSMO_LOOP_STAT_BUSY,
+	OSMO_LOOP_STAT_WAIT,
+	OSMO_LOOP_STAT_CB_MAX,
+	OSMO_LOOP_STAT_SLOW,
+};
+
+int osmo_loop_stats_enable(void *ctx, unsigned int slow_threshold_us);
+void osmo_loop_stats_disable(void);
+bool osmo_loop_stats_enabled(void);
+void osmo_loop_stats_reset(void);
+void osmo_loop_stats_set_slow_threshold(unsigned int slow_threshold_us);
+const struct osmo_loop_stats *osmo_loop_stats_get(void);
+unsigned int osmo_loop_stats_hist_bucket_us(unsigned int bucket);
+
+/*! @} */
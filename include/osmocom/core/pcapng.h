@@ -0,0 +1,58 @@
+/*! \file pcapng.h
+ * In-process PCAP-NG capture file writer.
+ */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*! \defgroup pcapng PCAP-NG file writer
+ *  @{
+ * \file pcapng.h */
+
+/*! raw IPv4/IPv6 packets, see http://www.tcpdump.org/linktypes.html */
+#define OSMO_PCAPNG_LINKTYPE_RAW	101
+
+struct sockaddr_in;
+struct osmo_pcapng_writer;
+
+/*! statistics of a PCAP-NG writer */
+struct osmo_pcapng_stats {
+	uint64_t packets;	/*!< packets captured */
+	uint64_t bytes;		/*!< bytes written to files */
+	uint64_t dropped;	/*!< packets dropped, as the writer thread fell behind */
+	uint64_t write_errors;	/*!< failed writes to files */
+	unsigned int files;	/*!< files opened so far */
+};
+
+struct osmo_pcapng_writer *osmo_pcapng_writer_alloc(void *ctx, const char *path,
+						    size_t max_file_bytes, unsigned int max_files);
+void osmo_pcapng_writer_free(struct osmo_pcapng_writer *w);
+int osmo_pcapng_writer_flush(struct osmo_pcapng_writer *w);
+void osmo_pcapng_writer_sync(struct osmo_pcapng_writer *w);
+void osmo_pcapng_writer_get_stats(struct osmo_pcapng_writer *w, struct osmo_pcapng_stats *st);
+
+int osmo_pcapng_write(struct osmo_pcapng_writer *w, uint16_t linktype,
+		      const uint8_t *data, size_t len);
+int osmo_pcapng_write_udp4(struct osmo_pcapng_writer *w, const struct sockaddr_in *src,
+			   const struct sockaddr_in *dst, const uint8_t *data, size_t len);
+
+/*! @} */
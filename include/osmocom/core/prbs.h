@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 #include <osmocom/core/bits.h>
 
 /*! \brief definition of a PRBS sequence */
@@ -15,6 +16,28 @@ struct osmo_prbs_state {
 	uint64_t state;
 };
 
+/*! \brief state of a PRBS bit error rate checker */
+struct osmo_prbs_ber {
+	const struct osmo_prbs *prbs;
+	/*! are we synchronized to the incoming PRBS? */
+	bool locked;
+	/*! last received bits while not locked, most recent bit in bit 0 */
+	uint64_t hist;
+	/*! number of bits in hist / number of correctly predicted bits while not locked */
+	unsigned int hist_len;
+	unsigned int match_count;
+	/*! local generator providing the expected bits while locked */
+	struct osmo_prbs_state gen;
+	/*! bits and bit errors in the current loss-of-sync detection window */
+	unsigned int win_bits;
+	unsigned int win_errors;
+	/*! total number of bits checked / bit errors detected while locked */
+	uint64_t num_bits;
+	uint64_t num_errors;
+	/*! number of times we lost synchronization */
+	unsigned int num_sync_loss;
+};
+
 extern const struct osmo_prbs osmo_prbs7;
 extern const struct osmo_prbs osmo_prbs9;
 extern const struct osmo_prbs osmo_prbs11;
@@ -23,3 +46,9 @@ extern const struct osmo_prbs osmo_prbs15;
 void osmo_prbs_state_init(struct osmo_prbs_state *st, const struct osmo_prbs *prbs);
 ubit_t osmo_prbs_get_ubit(struct osmo_prbs_state *state);
 int osmo_prbs_get_ubits(ubit_t *out, unsigned int out_len, struct osmo_prbs_state *state);
+uint64_t osmo_prbs_get_u64(struct osmo_prbs_state *state);
+int osmo_prbs_get_pbits(pbit_t *out, unsigned int num_bits, struct osmo_prbs_state *state);
+
+void osmo_prbs_ber_init(struct osmo_prbs_ber *ber, const struct osmo_prbs *prbs);
+void osmo_prbs_ber_rx_ubits(struct osmo_prbs_ber *ber, const ubit_t *in, unsigned int num_bits);
+void osmo_prbs_ber_rx_pbits(struct osmo_prbs_ber *ber, const pbit_t *in, unsigned int num_bits);
@@ -35,6 +35,9 @@ struct osmo_fd;
 #define OSMO_SOCK_F_NO_MCAST_ALL  (1 << 4)
 /*! use SO_REUSEADDR on UDP ports (required for multicast) */
 #define OSMO_SOCK_F_UDP_REUSEADDR (1 << 5)
+/*! use SO_REUSEPORT, so that several sockets can be bound to the same address/port;
+ *  applies to all IP socket init functions, unix domain sockets reject it */
+#define OSMO_SOCK_F_REUSEPORT	(1 << 6)
 
 /*! maximum number of local or remote addresses supported by an osmo_sock instance */
 #define OSMO_SOCK_MAX_ADDRS 32
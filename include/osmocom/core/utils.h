@@ -50,6 +50,11 @@ const char *get_value_string_or_null(const struct value_string *vs,
 
 int get_string_value(const struct value_string *vs, const char *str);
 
+/*! Build a lookup index for a value_string array that is never modified or freed */
+int value_string_index(const struct value_string *vs);
+/*! Return whether a value_string array has a lookup index */
+bool value_string_indexed(const struct value_string *vs);
+
 char osmo_bcd2char(uint8_t bcd);
 /* only works for numbers in ASCII */
 uint8_t osmo_char2bcd(char c);
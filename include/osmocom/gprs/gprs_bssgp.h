@@ -139,6 +139,28 @@ struct bssgp_lv {
 	uint16_t len;
 	uint8_t *v;
 };
+
+#define BSSGP_DL_UD_TMPL_MAX	128
+
+/*! per-MS cache of the DL-UNITDATA header in front of the LLC-PDU IE.
+ *  Zero-initialize before the first use. */
+struct bssgp_dl_ud_tmpl {
+	uint8_t hdr[BSSGP_DL_UD_TMPL_MAX];	/*!< encoded header */
+	uint16_t len;				/*!< length of hdr, 0 if invalid */
+
+	/* private: parameters the header was built from */
+	uint32_t tlli;
+	uint16_t pdu_lifetime;
+	uint16_t drx_parms;
+	uint8_t qos_profile[3];
+	bool has_old_tlli;
+	uint32_t old_tlli;
+	char imsi[GSM23003_IMSI_MAX_DIGITS+2];
+	uint16_t ms_ra_cap_len;
+	uint16_t ms_ra_cap_ofs;
+};
+void bssgp_dl_ud_tmpl_invalidate(struct bssgp_dl_ud_tmpl *tmpl);
+
 /* parameters for BSSGP downlink userdata transmission */
 struct bssgp_dl_ud_par {
 	uint32_t *tlli;
@@ -148,6 +170,8 @@ struct bssgp_dl_ud_par {
 	/* FIXME: priority */
 	struct bssgp_lv ms_ra_cap;
 	uint8_t qos_profile[3];
+	/*! header template of the MS, if any */
+	struct bssgp_dl_ud_tmpl *tmpl;
 };
 int bssgp_tx_dl_ud(struct msgb *msg, uint16_t pdu_lifetime,
 		   struct bssgp_dl_ud_par *dup);
@@ -192,6 +216,39 @@ struct bssgp_paging_info {
 int bssgp_tx_paging(uint16_t nsei, uint16_t ns_bvci,
 		    struct bssgp_paging_info *pinfo);
 
+/*! destination of a paging PDU */
+struct bssgp_paging_dest {
+	uint16_t nsei;		/*!< NSEI of the BSS */
+	uint16_t ns_bvci;	/*!< BVCI on which the PDU is sent */
+};
+
+enum bssgp_paging_ctr {
+	BSSGP_PAGING_CTR_REQUESTS,
+	BSSGP_PAGING_CTR_PDUS,
+	BSSGP_PAGING_CTR_COALESCED,
+	BSSGP_PAGING_CTR_RATE_LIMITED,
+	BSSGP_PAGING_CTR_TX_ERRORS,
+};
+
+/*! paging fan-out engine, see bssgp_paging_fanout_tx() */
+struct bssgp_paging_fanout {
+	unsigned int coalesce_ms;	/*!< coalescing window */
+	unsigned int max_pdus_per_nse;	/*!< paging PDUs per second and NSE */
+	struct rate_ctr_group *ctrg;	/*!< bssgp_paging_ctr */
+
+	/* private */
+	struct llist_head recent;
+	struct paging_recent **recent_hash;
+	struct llist_head nses;
+};
+
+struct bssgp_paging_fanout *bssgp_paging_fanout_alloc(void *ctx, unsigned int idx,
+						      unsigned int coalesce_ms,
+						      unsigned int max_pdus_per_nse);
+void bssgp_paging_fanout_free(struct bssgp_paging_fanout *pf);
+int bssgp_paging_fanout_tx(struct bssgp_paging_fanout *pf, const struct bssgp_paging_dest *dest,
+			   unsigned int num_dest, const struct bssgp_paging_info *pinfo);
+
 void bssgp_fc_init(struct bssgp_flow_control *fc,
 		   uint32_t bucket_size_max, uint32_t bucket_leak_rate,
 		   uint32_t max_queue_depth,
@@ -108,6 +108,20 @@ struct gprs_ns_inst {
 	} frgre;
 
 	struct osmo_fsm_inst *bss_sns_fi;
+
+	/*! further NS/UDP sockets sharing the local IP/port of nsip.fd,
+	 *  see gprs_ns_nsip_listen_reuseport() */
+	struct osmo_fd *nsip_extra_fds;
+	unsigned int nsip_num_extra_fds;
+
+	/*! cache of gprs_nsvc_by_rem_addr() results, indexed by a hash
+	 *  of the remote address */
+	struct gprs_nsvc **rem_addr_cache;
+
+	/*! load sharing state of each NSE, see gprs_ns_sendmsg() */
+	struct llist_head lsf_list;
+	/*! changes whenever the load sharing state has to be recomputed */
+	unsigned int lsf_generation;
 };
 
 enum nsvc_timer_mode {
@@ -173,6 +187,7 @@ void gprs_ns_destroy(struct gprs_ns_inst *nsi);
 
 /* Listen for incoming GPRS packets via NS/UDP */
 int gprs_ns_nsip_listen(struct gprs_ns_inst *nsi);
+int gprs_ns_nsip_listen_reuseport(struct gprs_ns_inst *nsi, unsigned int num_socks);
 
 /* Establish a connection (from the BSS) to the SGSN */
 struct gprs_nsvc *gprs_ns_nsip_connect(struct gprs_ns_inst *nsi,
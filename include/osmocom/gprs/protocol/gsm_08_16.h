@@ -26,6 +26,14 @@ struct gprs_ns_ie_ip4_elem {
 	uint8_t data_weight;
 } __attribute__ ((packed));
 
+/*! Section 10.3.2d List of IP6 Elements */
+struct gprs_ns_ie_ip6_elem {
+	uint8_t ip_addr[16];
+	uint16_t udp_port;
+	uint8_t sig_weight;
+	uint8_t data_weight;
+} __attribute__ ((packed));
+
 extern const struct value_string gprs_ns_pdu_strings[];
 
 /*! NS PDU Type (TS 08.16, Section 10.3.7, Table 14) */
@@ -285,10 +285,24 @@ struct osmo_cbsp_decoded {
 
 extern const __thread char *osmo_cbsp_errstr;
 
+/* Pre-encoded cell independent IEs of a WRITE-REPLACE message, to be shared
+ * between the messages for many cells, see osmo_cbsp_write_replace_tmpl_alloc() */
+struct osmo_cbsp_write_replace_tmpl {
+	/* IEs in front of the cell list: message id and serial numbers */
+	struct msgb *head;
+	/* IEs after the cell list: CBS pages or emergency information */
+	struct msgb *tail;
+};
+
 struct msgb *osmo_cbsp_msgb_alloc(void *ctx, const char *name);
 struct msgb *osmo_cbsp_encode(void *ctx, const struct osmo_cbsp_decoded *in);
 struct osmo_cbsp_decoded *osmo_cbsp_decode(void *ctx, struct msgb *in);
 void osmo_cbsp_init_struct(struct osmo_cbsp_decoded *cbsp, enum cbsp_msg_type msg_type);
 struct osmo_cbsp_decoded *osmo_cbsp_decoded_alloc(void *ctx,  enum cbsp_msg_type msg_type);
 
+struct osmo_cbsp_write_replace_tmpl *osmo_cbsp_write_replace_tmpl_alloc(void *ctx,
+									const struct osmo_cbsp_write_replace *in);
+struct msgb *osmo_cbsp_encode_write_replace_tmpl(void *ctx, const struct osmo_cbsp_write_replace_tmpl *tmpl,
+						 const struct osmo_cbsp_cell_list *cell_list);
+
 int osmo_cbsp_recv_buffered(void *ctx, int fd, struct msgb **rmsg, struct msgb **tmp_msg);
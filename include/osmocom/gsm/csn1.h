@@ -0,0 +1,148 @@
+/*! \file csn1.h
+ * Table driven CSN.1 (3GPP TS 24.007 Annex B) encoder + decoder. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <osmocom/core/bitvec.h>
+
+/*! \defgroup csn1 CSN.1 encoder/decoder
+ *  @{
+ *
+ * A CSN.1 structure is described by an array of struct osmo_csn1_insn,
+ * terminated by OSMO_CSN1_END.  Each instruction maps a piece of the CSN.1
+ * syntax to a member of a C struct, identified by its offset and size, so
+ * that the same description is used to decode bits into the struct and to
+ * encode the struct into bits.  Descriptions are built at compile time with
+ * the OSMO_CSN1_*() macros below, e.g. for
+ *
+ *   { L | H < CBQ : bit > < CELL_RESELECT_OFFSET : bit (6) > }
+ *
+ * \code
+ * const struct osmo_csn1_insn sel_par_descr[] = {
+ *	OSMO_CSN1_NEXT_EXIST_LH(struct sel_par, present, 2),
+ *	OSMO_CSN1_UINT(struct sel_par, cbq, 1),
+ *	OSMO_CSN1_UINT(struct sel_par, cell_resel_off, 6),
+ *	OSMO_CSN1_END
+ * };
+ * \endcode
+ *
+ * Integer members may be 1, 2, 4 or 8 bytes wide; bit-fields cannot be
+ * addressed.  Nesting (OSMO_CSN1_TYPE) is limited to OSMO_CSN1_MAX_DEPTH
+ * levels, no memory is allocated. */
+
+/*! maximum nesting depth of CSN.1 descriptions */
+#define OSMO_CSN1_MAX_DEPTH	8
+
+enum osmo_csn1_op {
+	OSMO_CSN1_OP_END,		/*!< end of description */
+	OSMO_CSN1_OP_UINT,		/*!< bit (n) */
+	OSMO_CSN1_OP_UINT_LH,		/*!< bit (n), coded as L/H */
+	OSMO_CSN1_OP_UINT_ARRAY,	/*!< bit (n) * count */
+	OSMO_CSN1_OP_NEXT_EXIST,	/*!< { 0 | 1 < next count instructions > } */
+	OSMO_CSN1_OP_NEXT_EXIST_LH,	/*!< { L | H < next count instructions > } */
+	OSMO_CSN1_OP_REC_ARRAY,		/*!< { 1 < bit (n) > } ** 0 */
+	OSMO_CSN1_OP_REC_TYPE_ARRAY,	/*!< { 1 < type > } ** 0 */
+	OSMO_CSN1_OP_UNION,		/*!< bit (n) selecting one of the next count instructions */
+	OSMO_CSN1_OP_TYPE,		/*!< nested description */
+	OSMO_CSN1_OP_FIXED,		/*!< fixed bit (n) pattern, not stored */
+	OSMO_CSN1_OP_NULL,		/*!< no bits, e.g. an empty union alternative */
+	OSMO_CSN1_OP_PADDING,		/*!< spare padding (L) up to the end of the bit vector */
+};
+
+/*! One instruction of a CSN.1 description */
+struct osmo_csn1_insn {
+	/*! enum osmo_csn1_op */
+	uint8_t op;
+	/*! number of bits of the element */
+	uint8_t num_bits;
+	/*! size of the struct member in bytes, of one array element for arrays */
+	uint8_t size;
+	/*! NEXT_EXIST: instructions to skip if absent; UNION: number of alternatives;
+	 *  arrays: maximum number of elements */
+	uint8_t count;
+	/*! offset of the struct member */
+	uint16_t offset;
+	/*! REC_ARRAY, REC_TYPE_ARRAY: offset of the uint8_t element counter; FIXED: the bit pattern */
+	uint16_t aux;
+	/*! TYPE, REC_TYPE_ARRAY: nested description */
+	const struct osmo_csn1_insn *type;
+};
+
+#define _OSMO_CSN1_MEMBER_SIZE(_type, _member) \
+	sizeof(((_type *)0)->_member)
+#define _OSMO_CSN1_ELEM_SIZE(_type, _member) \
+	sizeof(((_type *)0)->_member[0])
+#define _OSMO_CSN1_ARRAY_LEN(_type, _member) \
+	(_OSMO_CSN1_MEMBER_SIZE(_type, _member) / _OSMO_CSN1_ELEM_SIZE(_type, _member))
+
+/*! < _member : bit (_bits) > */
+#define OSMO_CSN1_UINT(_type, _member, _bits) \
+	{ .op = OSMO_CSN1_OP_UINT, .num_bits = _bits, .size = _OSMO_CSN1_MEMBER_SIZE(_type, _member), \
+	  .offset = offsetof(_type, _member) }
+/*! < _member : bit (_bits) >, coded as L/H relative to the 0x2b padding */
+#define OSMO_CSN1_UINT_LH(_type, _member, _bits) \
+	{ .op = OSMO_CSN1_OP_UINT_LH, .num_bits = _bits, .size = _OSMO_CSN1_MEMBER_SIZE(_type, _member), \
+	  .offset = offsetof(_type, _member) }
+/*! < _member : bit (_bits) > * ARRAY_SIZE(_member) */
+#define OSMO_CSN1_UINT_ARRAY(_type, _member, _bits) \
+	{ .op = OSMO_CSN1_OP_UINT_ARRAY, .num_bits = _bits, .size = _OSMO_CSN1_ELEM_SIZE(_type, _member), \
+	  .count = _OSMO_CSN1_ARRAY_LEN(_type, _member), .offset = offsetof(_type, _member) }
+/*! { 0 | 1 < next _skip instructions > }, presence stored in _member */
+#define OSMO_CSN1_NEXT_EXIST(_type, _member, _skip) \
+	{ .op = OSMO_CSN1_OP_NEXT_EXIST, .num_bits = 1, .size = _OSMO_CSN1_MEMBER_SIZE(_type, _member), \
+	  .count = _skip, .offset = offsetof(_type, _member) }
+/*! { L | H < next _skip instructions > }, presence stored in _member */
+#define OSMO_CSN1_NEXT_EXIST_LH(_type, _member, _skip) \
+	{ .op = OSMO_CSN1_OP_NEXT_EXIST_LH, .num_bits = 1, .size = _OSMO_CSN1_MEMBER_SIZE(_type, _member), \
+	  .count = _skip, .offset = offsetof(_type, _member) }
+/*! { 1 < _member : bit (_bits) > } ** 0, number of elements stored in the uint8_t _count_member */
+#define OSMO_CSN1_REC_ARRAY(_type, _member, _count_member, _bits) \
+	{ .op = OSMO_CSN1_OP_REC_ARRAY, .num_bits = _bits, .size = _OSMO_CSN1_ELEM_SIZE(_type, _member), \
+	  .count = _OSMO_CSN1_ARRAY_LEN(_type, _member), .offset = offsetof(_type, _member), \
+	  .aux = offsetof(_type, _count_member) }
+/*! { 1 < _member : _descr > } ** 0, number of elements stored in the uint8_t _count_member */
+#define OSMO_CSN1_REC_TYPE_ARRAY(_type, _member, _count_member, _descr) \
+	{ .op = OSMO_CSN1_OP_REC_TYPE_ARRAY, .size = _OSMO_CSN1_ELEM_SIZE(_type, _member), \
+	  .count = _OSMO_CSN1_ARRAY_LEN(_type, _member), .offset = offsetof(_type, _member), \
+	  .aux = offsetof(_type, _count_member), .type = _descr }
+/*! < _member : bit (_bits) > selecting one of the _num instructions following this one */
+#define OSMO_CSN1_UNION(_type, _member, _bits, _num) \
+	{ .op = OSMO_CSN1_OP_UNION, .num_bits = _bits, .size = _OSMO_CSN1_MEMBER_SIZE(_type, _member), \
+	  .count = _num, .offset = offsetof(_type, _member) }
+/*! < _member : _descr > */
+#define OSMO_CSN1_TYPE(_type, _member, _descr) \
+	{ .op = OSMO_CSN1_OP_TYPE, .offset = offsetof(_type, _member), .type = _descr }
+/*! fixed bit (_bits) pattern _val, checked when decoding */
+#define OSMO_CSN1_FIXED(_bits, _val) \
+	{ .op = OSMO_CSN1_OP_FIXED, .num_bits = _bits, .aux = _val }
+/*! null, no bits */
+#define OSMO_CSN1_NULL \
+	{ .op = OSMO_CSN1_OP_NULL }
+/*! < spare padding > */
+#define OSMO_CSN1_PADDING \
+	{ .op = OSMO_CSN1_OP_PADDING }
+/*! end of description */
+#define OSMO_CSN1_END \
+	{ .op = OSMO_CSN1_OP_END }
+
+int osmo_csn1_decode(const struct osmo_csn1_insn *descr, struct bitvec *bv, void *data);
+int osmo_csn1_encode(const struct osmo_csn1_insn *descr, struct bitvec *bv, const void *data);
+
+/*! @} */
@@ -23,3 +23,19 @@ int osmo_gsm48_range_enc_128(uint8_t *chan_list, int f0, int *w);
 int osmo_gsm48_range_enc_256(uint8_t *chan_list, int f0, int *w);
 int osmo_gsm48_range_enc_512(uint8_t *chan_list, int f0, int *w);
 int osmo_gsm48_range_enc_1024(uint8_t *chan_list, int f0, int f0_incl, int *w);
+
+int osmo_gsm48_range_enc_freq_list(uint8_t *chan_list, const int *arfcns, int size);
+
+/*! One ARFCN list to be encoded by osmo_gsm48_range_enc_freq_lists() */
+struct osmo_gsm48_range_enc_list {
+	/*! input: ARFCNs to encode */
+	const int *arfcns;
+	/*! input: number of ARFCNs */
+	int size;
+	/*! output: encoded Frequency List / Neighbour Cell Description */
+	uint8_t chan_list[16];
+	/*! output: used range (enum osmo_gsm48_range) or negative errno */
+	int rc;
+};
+
+unsigned int osmo_gsm48_range_enc_freq_lists(struct osmo_gsm48_range_enc_list *lists, unsigned int num);
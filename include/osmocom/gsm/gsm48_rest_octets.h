@@ -125,3 +125,66 @@ int osmo_gsm48_rest_octets_si13_encode(uint8_t *data, const struct osmo_gsm48_si
 
 /* Parse SI3 Rest Octets */
 void osmo_gsm48_rest_octets_si3_decode(struct osmo_gsm48_si_ro_info *si3, const uint8_t *data);
+
+/* parts of the SI rest octets cached in struct osmo_gsm48_si_ro_cache */
+enum osmo_gsm48_si_ro_part {
+	OSMO_GSM48_SI_RO_SI2QUATER,
+	OSMO_GSM48_SI_RO_SI3,
+	OSMO_GSM48_SI_RO_SI4,
+	OSMO_GSM48_SI_RO_SI6,
+	OSMO_GSM48_SI_RO_SI13,
+	_NUM_OSMO_GSM48_SI_RO_PART
+};
+
+/* Encoded rest octets of the System Information messages of one cell.  The input
+ * parameters are set via osmo_gsm48_si_ro_cache_set_*(), which mark the affected
+ * part as dirty if anything changed.  osmo_gsm48_si_ro_cache_encode() then only
+ * re-encodes the dirty parts. */
+struct osmo_gsm48_si_ro_cache {
+	/* bit-mask of (1 << enum osmo_gsm48_si_ro_part) which need to be re-encoded */
+	uint32_t dirty;
+
+	struct {
+		/* neighbour lists, owned by the caller; see osmo_gsm48_rest_octets_si2quater_encode() */
+		const uint16_t *uarfcn_list;
+		uint16_t *scramble_list;
+		size_t uarfcn_length;
+		struct osmo_earfcn_si2q *earfcn_list;
+		/* number of SI2quater messages required for all neighbours */
+		uint8_t count;
+		uint8_t ro[SI2Q_MAX_NUM][20];
+	} si2quater;
+
+	struct {
+		struct osmo_gsm48_si_ro_info info;
+		uint8_t ro[4];
+	} si3;
+
+	struct {
+		struct osmo_gsm48_si_ro_info info;
+		int len;
+		uint8_t ro[GSM_MACBLOCK_LEN];
+	} si4;
+
+	struct {
+		struct osmo_gsm48_si6_ro_info info;
+		uint8_t ro[1];
+	} si6;
+
+	struct {
+		struct osmo_gsm48_si13_info info;
+		uint8_t ro[20];
+	} si13;
+};
+
+void osmo_gsm48_si_ro_cache_init(struct osmo_gsm48_si_ro_cache *cache);
+void osmo_gsm48_si_ro_cache_set_si2quater(struct osmo_gsm48_si_ro_cache *cache,
+					  const uint16_t *uarfcn_list, uint16_t *scramble_list,
+					  size_t uarfcn_length, struct osmo_earfcn_si2q *earfcn_list);
+void osmo_gsm48_si_ro_cache_set_si3(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si_ro_info *si3);
+void osmo_gsm48_si_ro_cache_set_si4(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si_ro_info *si4,
+				    int len);
+void osmo_gsm48_si_ro_cache_set_si6(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si6_ro_info *si6);
+void osmo_gsm48_si_ro_cache_set_si13(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si13_info *si13);
+int osmo_gsm48_si_ro_cache_encode(struct osmo_gsm48_si_ro_cache *cache);
+int osmo_gsm48_si_ro_cache_encode_bulk(struct osmo_gsm48_si_ro_cache **caches, unsigned int num_caches);
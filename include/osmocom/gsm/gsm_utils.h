@@ -64,6 +64,7 @@ const char *gsm_band_name(enum gsm_band band);
 enum gsm_band gsm_band_parse(const char *mhz);
 
 int osmo_get_rand_id(uint8_t *out, size_t len);
+int osmo_get_rand(uint8_t *out, size_t len);
 
 /*!
  * Decode a sequence of GSM 03.38 encoded 7 bit characters.
@@ -115,6 +116,10 @@ int gsm_septet_encode(uint8_t *result, const char *data);
 uint8_t gsm_get_octet_len(const uint8_t sept_len);
 int gsm_7bit_decode_n_hdr(char *decoded, size_t n, const uint8_t *user_data, uint8_t length, uint8_t ud_hdr_ind);
 
+int gsm_septet_count(const char *data);
+int gsm_ucs2_encode_n(uint8_t *result, size_t n, const char *data);
+int gsm_ucs2_decode_n(char *text, size_t n, const uint8_t *ucs2, size_t len);
+
 int ms_class_gmsk_dbm(enum gsm_band band, int ms_class);
 int ms_pwr_ctl_lvl(enum gsm_band band, unsigned int dbm);
 int ms_pwr_dbm(enum gsm_band band, uint8_t lvl);
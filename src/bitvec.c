@@ -73,6 +73,68 @@ static uint8_t bitval2mask(enum bit_value bit, uint8_t bitnum)
 	}
 }
 
+/* 0x2b padding pattern relative to which L/H bits are defined, repeated for every octet */
+#define BITVEC_PAD_PATTERN_U64	0x2b2b2b2b2b2b2b2bULL
+
+/* L/H pattern for num_bits (1..64) bits starting at bit number bitnr, right aligned */
+static inline uint64_t lh_pattern(unsigned int bitnr, unsigned int num_bits)
+{
+	unsigned int rot = bitnr % 8;
+	uint64_t pat = BITVEC_PAD_PATTERN_U64;
+
+	if (rot)
+		pat = (pat << rot) | (pat >> (64 - rot));
+	return pat >> (64 - num_bits);
+}
+
+/* check that num_bits bits starting at bit number bitnr are within the vector */
+static inline bool bits_in_range(const struct bitvec *bv, unsigned int bitnr, unsigned int num_bits)
+{
+	return (uint64_t)bitnr + num_bits <= (uint64_t)bv->data_len * 8;
+}
+
+/* read num_bits (1..64) bits starting at bitnr, the caller has checked the range */
+static uint64_t read_bits(const struct bitvec *bv, unsigned int bitnr, unsigned int num_bits)
+{
+	const uint8_t *p = bv->data + bytenum_from_bitnum(bitnr);
+	unsigned int offs = bitnr % 8;
+	uint64_t acc;
+
+	if (offs + num_bits > 64) {
+		/* spans nine octets, read the head first */
+		unsigned int head = num_bits - 32;
+		return (read_bits(bv, bitnr, head) << 32) | read_bits(bv, bitnr + head, 32);
+	}
+
+	acc = osmo_load64be_ext(p, (offs + num_bits + 7) / 8);
+	return (acc << offs) >> (64 - num_bits);
+}
+
+/* write the num_bits (1..64) lowest bits of val starting at bitnr, the caller has checked the range */
+static void write_bits(struct bitvec *bv, unsigned int bitnr, uint64_t val, unsigned int num_bits)
+{
+	uint8_t *p = bv->data + bytenum_from_bitnum(bitnr);
+	unsigned int offs = bitnr % 8;
+	unsigned int num_bytes, shift;
+	uint64_t acc, mask;
+
+	if (offs + num_bits > 64) {
+		/* spans nine octets, write the head first */
+		unsigned int head = num_bits - 32;
+		write_bits(bv, bitnr, val >> 32, head);
+		write_bits(bv, bitnr + head, val, 32);
+		return;
+	}
+
+	num_bytes = (offs + num_bits + 7) / 8;
+	shift = 64 - offs - num_bits;
+	mask = (~0ULL >> (64 - num_bits)) << shift;
+
+	acc = osmo_load64be_ext(p, num_bytes);
+	acc = (acc & ~mask) | ((val << shift) & mask);
+	osmo_store64be_ext(acc >> (64 - 8 * num_bytes), p, num_bytes);
+}
+
 /*! check if the bit is 0 or 1 for a given position inside a bitvec
  *  \param[in] bv the bit vector on which to check
  *  \param[in] bitnr the bit number inside the bit vector to check
@@ -225,6 +287,19 @@ int bitvec_set_u64(struct bitvec *bv, uint64_t v, uint8_t num_bits, bool use_lh)
 	if (num_bits > 64)
 		return -E2BIG;
 
+	if (num_bits == 0)
+		return 0;
+
+	/* fast path: write all bits at once, L/H is 0/1 relative to the padding pattern */
+	if (bits_in_range(bv, bv->cur_bit, num_bits)) {
+		if (use_lh)
+			v ^= lh_pattern(bv->cur_bit, num_bits);
+		write_bits(bv, bv->cur_bit, v, num_bits);
+		bv->cur_bit += num_bits;
+		return 0;
+	}
+
+	/* slow path: write bit by bit up to the end of the vector */
 	for (i = 0; i < num_bits; i++) {
 		int rc;
 		enum bit_value bit = use_lh ? L : 0;
@@ -240,6 +315,33 @@ int bitvec_set_u64(struct bitvec *bv, uint64_t v, uint8_t num_bits, bool use_lh)
 	return 0;
 }
 
+/*! get multiple bits (as numeric value) from current pos.
+ *  \param[in] bv bit vector.
+ *  \param[out] v the bits read, the first one as most significant of num_bits.
+ *  \param[in] num_bits number of bits to read.
+ *  \param[in] use_lh whether to interpret the bits as L/H values or as 0/1.
+ *  \return 0 on success; negative in case of error, leaving the position unchanged. */
+int bitvec_get_u64(struct bitvec *bv, uint64_t *v, uint8_t num_bits, bool use_lh)
+{
+	if (num_bits > 64)
+		return -E2BIG;
+
+	if (!bits_in_range(bv, bv->cur_bit, num_bits))
+		return -EINVAL;
+
+	if (num_bits == 0) {
+		*v = 0;
+		return 0;
+	}
+
+	/* L/H is 0/1 relative to the padding pattern, as in bitvec_set_u64() */
+	*v = read_bits(bv, bv->cur_bit, num_bits);
+	if (use_lh)
+		*v ^= lh_pattern(bv->cur_bit, num_bits);
+	bv->cur_bit += num_bits;
+	return 0;
+}
+
 /*! set multiple bits (based on numeric value) at current pos.
  *  \return 0 in case of success; negative in case of error. */
 int bitvec_set_uint(struct bitvec *bv, unsigned int ui, unsigned int num_bits)
@@ -267,6 +369,12 @@ int bitvec_get_uint(struct bitvec *bv, unsigned int num_bits)
 	int i;
 	unsigned int ui = 0;
 
+	if (num_bits > 0 && num_bits <= 32 && bits_in_range(bv, bv->cur_bit, num_bits)) {
+		ui = read_bits(bv, bv->cur_bit, num_bits);
+		bv->cur_bit += num_bits;
+		return ui;
+	}
+
 	for (i = 0; i < num_bits; i++) {
 		int bit = bitvec_get_bit_pos(bv, bv->cur_bit);
 		if (bit < 0)
@@ -285,6 +393,21 @@ int bitvec_get_uint(struct bitvec *bv, unsigned int num_bits)
 int bitvec_fill(struct bitvec *bv, unsigned int num_bits, enum bit_value fill)
 {
 	unsigned i, stop = bv->cur_bit + num_bits;
+
+	if (fill <= H) {
+		uint64_t v = (fill == ONE || fill == H) ? ~0ULL : 0;
+		bool use_lh = (fill == L || fill == H);
+
+		/* fill up to 64 bits at a time */
+		while (num_bits > 0) {
+			unsigned int n = OSMO_MIN(num_bits, 64);
+			if (bitvec_set_u64(bv, v, n, use_lh) < 0)
+				return -EINVAL;
+			num_bits -= n;
+		}
+		return 0;
+	}
+
 	for (i = bv->cur_bit; i < stop; i++)
 		if (bitvec_set_bit(bv, fill) < 0)
 			return -EINVAL;
@@ -480,6 +603,13 @@ uint64_t bitvec_read_field(struct bitvec *bv, unsigned int *read_index, unsigned
 	uint64_t ui = 0;
 	bv->cur_bit = *read_index;
 
+	if (len > 0 && len <= 64 && bits_in_range(bv, bv->cur_bit, len)) {
+		ui = read_bits(bv, bv->cur_bit, len);
+		bv->cur_bit += len;
+		*read_index += len;
+		return ui;
+	}
+
 	for (i = 0; i < len; i++) {
 		int bit = bitvec_get_bit_pos((const struct bitvec *)bv, bv->cur_bit);
 		if (bit < 0)
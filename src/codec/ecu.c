@@ -40,8 +40,17 @@
 #include <osmocom/codec/ecu.h>
 #include <osmocom/core/talloc.h>
 
+#include "ecu_internal.h"
+
 static const struct osmo_ecu_ops *g_ecu_ops[_NUM_OSMO_ECU_CODECS];
 
+/* frame level implementations of the built-in ECUs */
+static const struct ecu_kernel *g_ecu_kernels[_NUM_OSMO_ECU_CODECS] = {
+	[OSMO_ECU_CODEC_FR] = &ecu_kernel_fr,
+	[OSMO_ECU_CODEC_EFR] = &ecu_kernel_efr,
+	[OSMO_ECU_CODEC_AMR] = &ecu_kernel_amr,
+};
+
 /***********************************************************************
  * high-level API for users
  ***********************************************************************/
@@ -116,3 +125,216 @@ int osmo_ecu_register(const struct osmo_ecu_ops *ops, enum osmo_ecu_codec codec)
 
 	return 0;
 }
+
+/***********************************************************************
+ * multi-channel API
+ ***********************************************************************/
+
+/* ECU state of many channels, kept in contiguous arrays indexed by the
+ * channel number rather than in one allocation per channel */
+struct osmo_ecu_batch {
+	const struct ecu_kernel *kernel;
+	unsigned int num_chans;
+	/* last good frame of each channel, kernel->max_frame_bytes apart */
+	uint8_t *frames;
+	/* length of the last good frame, 0 if none was received yet */
+	uint8_t *frame_len;
+	/* number of consecutive lost frames */
+	uint16_t *lost;
+};
+
+/*! allocate the ECU state for a number of channels of the same codec.
+ *  \param[in] ctx talloc context from which to allocate
+ *  \param[in] codec codec of all channels, only the built-in FR, EFR and AMR ECUs are supported
+ *  \param[in] num_chans number of channels, numbered from 0 to num_chans - 1
+ *  \returns allocated ECU state; NULL on error */
+struct osmo_ecu_batch *osmo_ecu_batch_alloc(void *ctx, enum osmo_ecu_codec codec, unsigned int num_chans)
+{
+	struct osmo_ecu_batch *eb;
+
+	if (codec >= ARRAY_SIZE(g_ecu_kernels) || !g_ecu_kernels[codec] || !num_chans)
+		return NULL;
+
+	eb = talloc_zero(ctx, struct osmo_ecu_batch);
+	if (!eb)
+		return NULL;
+	eb->kernel = g_ecu_kernels[codec];
+	eb->num_chans = num_chans;
+	eb->frames = talloc_zero_array(eb, uint8_t, num_chans * eb->kernel->max_frame_bytes);
+	eb->frame_len = talloc_zero_array(eb, uint8_t, num_chans);
+	eb->lost = talloc_zero_array(eb, uint16_t, num_chans);
+	if (!eb->frames || !eb->frame_len || !eb->lost) {
+		talloc_free(eb);
+		return NULL;
+	}
+
+	return eb;
+}
+
+/*! free the ECU state of all channels */
+void osmo_ecu_batch_free(struct osmo_ecu_batch *eb)
+{
+	talloc_free(eb);
+}
+
+/*! reset the ECU state of one channel, e.g. for a new call.
+ *  \param[in] eb ECU state on which to operate
+ *  \param[in] chan channel number */
+void osmo_ecu_batch_reset(struct osmo_ecu_batch *eb, unsigned int chan)
+{
+	if (chan >= eb->num_chans)
+		return;
+	eb->frame_len[chan] = 0;
+	eb->lost[chan] = 0;
+}
+
+/*! process a received frame of one channel, like osmo_ecu_frame_in().
+ *  \param[in] eb ECU state on which to operate
+ *  \param[in] chan channel number
+ *  \param[in] bfi Bad Frame Indication
+ *  \param[in] frame received codec frame to be processed
+ *  \param[in] frame_bytes number of bytes available in frame
+ *  \returns 0 on success; negative on error */
+int osmo_ecu_batch_frame_in(struct osmo_ecu_batch *eb, unsigned int chan, bool bfi,
+			    const uint8_t *frame, unsigned int frame_bytes)
+{
+	int rc;
+
+	if (chan >= eb->num_chans)
+		return -EINVAL;
+	if (bfi)
+		return 0;
+
+	rc = eb->kernel->frame_in(frame, frame_bytes);
+	if (rc < 0)
+		return rc;
+
+	memcpy(eb->frames + chan * eb->kernel->max_frame_bytes, frame, rc);
+	eb->frame_len[chan] = rc;
+	eb->lost[chan] = 0;
+	return 0;
+}
+
+/*! generate substitute frames for a number of channels, e.g. for all
+ *  channels which lost their frame in the current 20 ms period.
+ *  \param[in] eb ECU state on which to operate
+ *  \param[in] chans channel numbers, num entries
+ *  \param[in] num number of channels to conceal
+ *  \param[out] frames_out output buffers of at least OSMO_ECU_MAX_FRAME_BYTES each, num entries
+ *  \param[out] lens_out number of bytes written to each output buffer; negative on error, num entries
+ *  \returns number of generated substitute frames */
+unsigned int osmo_ecu_batch_conceal(struct osmo_ecu_batch *eb, const unsigned int *chans, unsigned int num,
+				    uint8_t * const *frames_out, int *lens_out)
+{
+	const struct ecu_kernel *kernel = eb->kernel;
+	unsigned int i, chan, ok = 0;
+	uint8_t *frame;
+	int rc;
+
+	for (i = 0; i < num; i++) {
+		chan = chans[i];
+		if (chan >= eb->num_chans) {
+			lens_out[i] = -EINVAL;
+			continue;
+		}
+		if (!eb->frame_len[chan]) {
+			lens_out[i] = -ENODATA;
+			continue;
+		}
+
+		if (eb->lost[chan] < UINT16_MAX)
+			eb->lost[chan]++;
+
+		frame = eb->frames + chan * kernel->max_frame_bytes;
+		rc = kernel->conceal(frame, eb->frame_len[chan], eb->lost[chan]);
+		lens_out[i] = rc;
+		if (rc < 0)
+			continue;
+
+		eb->frame_len[chan] = rc;
+		memcpy(frames_out[i], frame, rc);
+		ok++;
+	}
+
+	return ok;
+}
+
+/***********************************************************************
+ * single channel ECUs for the built-in frame level implementations
+ ***********************************************************************/
+
+struct ecu_kernel_state {
+	const struct ecu_kernel *kernel;
+	unsigned int lost;
+	int frame_len;
+	uint8_t frame[OSMO_ECU_MAX_FRAME_BYTES];
+};
+
+static struct osmo_ecu_state *ecu_kernel_init(void *ctx, enum osmo_ecu_codec codec)
+{
+	struct osmo_ecu_state *st;
+	struct ecu_kernel_state *ks;
+	size_t size = sizeof(*st) + sizeof(*ks);
+
+	st = talloc_named_const(ctx, size, "ecu_state");
+	if (!st)
+		return NULL;
+
+	memset(st, 0, size);
+	st->codec = codec;
+	ks = (struct ecu_kernel_state *) &st->data;
+	ks->kernel = g_ecu_kernels[codec];
+
+	return st;
+}
+
+static int ecu_kernel_frame_in(struct osmo_ecu_state *st, bool bfi, const uint8_t *frame,
+			       unsigned int frame_bytes)
+{
+	struct ecu_kernel_state *ks = (struct ecu_kernel_state *) &st->data;
+	int rc;
+
+	if (bfi)
+		return 0;
+
+	rc = ks->kernel->frame_in(frame, frame_bytes);
+	if (rc < 0)
+		return rc;
+
+	memcpy(ks->frame, frame, rc);
+	ks->frame_len = rc;
+	ks->lost = 0;
+	return 0;
+}
+
+static int ecu_kernel_frame_out(struct osmo_ecu_state *st, uint8_t *frame_out)
+{
+	struct ecu_kernel_state *ks = (struct ecu_kernel_state *) &st->data;
+	int rc;
+
+	if (!ks->frame_len)
+		return -ENODATA;
+
+	if (ks->lost < UINT16_MAX)
+		ks->lost++;
+
+	rc = ks->kernel->conceal(ks->frame, ks->frame_len, ks->lost);
+	if (rc < 0)
+		return rc;
+
+	ks->frame_len = rc;
+	memcpy(frame_out, ks->frame, rc);
+	return rc;
+}
+
+static const struct osmo_ecu_ops osmo_ecu_ops_kernel = {
+	.init = ecu_kernel_init,
+	.frame_in = ecu_kernel_frame_in,
+	.frame_out = ecu_kernel_frame_out,
+};
+
+static __attribute__((constructor)) void on_dso_load_ecu(void)
+{
+	osmo_ecu_register(&osmo_ecu_ops_kernel, OSMO_ECU_CODEC_EFR);
+	osmo_ecu_register(&osmo_ecu_ops_kernel, OSMO_ECU_CODEC_AMR);
+}
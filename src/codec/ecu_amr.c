@@ -0,0 +1,74 @@
+/*! \file ecu_amr.c
+ * Simple error concealment for AMR in RTP (RFC 4867, octet-aligned). */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <osmocom/codec/codec.h>
+#include <osmocom/codec/ecu.h>
+
+#include "ecu_internal.h"
+
+/* AMR decoders implement their own substitution and muting of lost frames
+ * (3GPP TS 26.091), driven by the parameters of the previous good frame.  So
+ * the last good frame is repeated once as is, then it is passed on with the
+ * Q bit cleared, which makes the decoder treat it as a damaged frame.  After
+ * AMR_ECU_MAX_LOST lost frames, there is nothing left to conceal and NO_DATA
+ * frames are generated. */
+#define AMR_ECU_MAX_LOST	16
+
+/* octet-aligned payload header: CMR(4) R(4) | F(1) FT(4) Q(1) P(2) */
+#define AMR_TOC_Q		0x04
+
+static int kernel_amr_frame_in(const uint8_t *frame, unsigned int frame_bytes)
+{
+	enum osmo_amr_type ft;
+	enum osmo_amr_quality bfi;
+	int rc;
+
+	rc = osmo_amr_rtp_dec(frame, frame_bytes, NULL, NULL, &ft, &bfi, NULL);
+	if (rc < 0)
+		return rc;
+	if (bfi == AMR_BAD || ft == AMR_NO_DATA)
+		return -EINVAL;
+
+	return rc;
+}
+
+static int kernel_amr_conceal(uint8_t *frame, unsigned int frame_bytes, unsigned int lost)
+{
+	enum osmo_amr_type ft = (frame[1] >> 3) & 0xf;
+
+	/* comfort noise (SID) is simply repeated */
+	if (lost < 2 || !osmo_amr_is_speech(ft))
+		return frame_bytes;
+
+	if (lost <= AMR_ECU_MAX_LOST) {
+		frame[1] &= ~AMR_TOC_Q;
+		return frame_bytes;
+	}
+
+	return osmo_amr_rtp_enc(frame, frame[0] >> 4, AMR_NO_DATA, AMR_GOOD);
+}
+
+const struct ecu_kernel ecu_kernel_amr = {
+	.max_frame_bytes = 2 + 31,
+	.frame_in = kernel_amr_frame_in,
+	.conceal = kernel_amr_conceal,
+};
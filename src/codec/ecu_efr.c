@@ -0,0 +1,85 @@
+/*! \file ecu_efr.c
+ * Simple error concealment for GSM EFR. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <osmocom/codec/codec.h>
+#include <osmocom/codec/ecu.h>
+
+#include "ecu_internal.h"
+
+/* Like the FR ECU (see GSM 06.11), the last good frame is repeated and its
+ * gains are reduced for each further lost frame.  Both the adaptive (pitch)
+ * and the fixed codebook gain indices of GSM 06.60 are quantised in
+ * ascending order, so that decreasing them attenuates the signal. */
+#define GSM660_GAIN_PITCH_LEN		4
+#define GSM660_GAIN_PITCH_REDUCE	1
+#define GSM660_GAIN_CODE_LEN		5
+#define GSM660_GAIN_CODE_REDUCE		2
+
+/* RTP bit positions (after the 4 bit signature) of the gains of the four
+ * subframes, see the bit allocation in GSM 06.60 Table 6 */
+static const struct {
+	uint16_t pitch;
+	uint16_t code;
+} gain_pos[4] = {
+	{ 4 + 38 + 9, 4 + 38 + 9 + 4 + 35 },
+	{ 4 + 91 + 6, 4 + 91 + 6 + 4 + 35 },
+	{ 4 + 141 + 9, 4 + 141 + 9 + 4 + 35 },
+	{ 4 + 194 + 6, 4 + 194 + 6 + 4 + 35 },
+};
+
+static uint8_t reduce(uint8_t field, uint8_t by)
+{
+	return field > by ? field - by : 0;
+}
+
+static int kernel_efr_frame_in(const uint8_t *frame, unsigned int frame_bytes)
+{
+	if (frame_bytes < GSM_EFR_BYTES || (frame[0] >> 4) != 0xc)
+		return -EINVAL;
+	return GSM_EFR_BYTES;
+}
+
+static int kernel_efr_conceal(uint8_t *frame, unsigned int frame_bytes, unsigned int lost)
+{
+	unsigned int i;
+
+	/* the first lost frame is a plain repetition */
+	if (lost < 2)
+		return GSM_EFR_BYTES;
+
+	for (i = 0; i < ARRAY_SIZE(gain_pos); i++) {
+		ecu_set_field(frame, gain_pos[i].pitch, GSM660_GAIN_PITCH_LEN,
+			      reduce(ecu_get_field(frame, gain_pos[i].pitch, GSM660_GAIN_PITCH_LEN),
+				     GSM660_GAIN_PITCH_REDUCE));
+		ecu_set_field(frame, gain_pos[i].code, GSM660_GAIN_CODE_LEN,
+			      reduce(ecu_get_field(frame, gain_pos[i].code, GSM660_GAIN_CODE_LEN),
+				     GSM660_GAIN_CODE_REDUCE));
+	}
+
+	return GSM_EFR_BYTES;
+}
+
+const struct ecu_kernel ecu_kernel_efr = {
+	.max_frame_bytes = GSM_EFR_BYTES,
+	.frame_in = kernel_efr_frame_in,
+	.conceal = kernel_efr_conceal,
+};
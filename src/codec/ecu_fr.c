@@ -25,51 +25,43 @@
 #include <stdint.h>
 #include <errno.h>
 
-#include <osmocom/core/bitvec.h>
-
 #include <osmocom/codec/gsm610_bits.h>
 #include <osmocom/codec/codec.h>
 #include <osmocom/codec/ecu.h>
 
+#include "ecu_internal.h"
+
 /* See also GSM 06.11, chapter 6 Example solution */
 #define GSM610_XMAXC_REDUCE	4
 #define GSM610_XMAXC_LEN	6
 
-/**
- * Reduce the XMAXC field. When the XMAXC field reaches
- * zero the function will return true.
- */
-static bool reduce_xmaxcr(struct bitvec *frame_bitvec,
-	const unsigned int index)
-{
-	unsigned int field_index;
-	uint64_t field;
-
-	field_index = index;
-	field = bitvec_read_field(frame_bitvec, &field_index, GSM610_XMAXC_LEN);
-	if (field > GSM610_XMAXC_REDUCE)
-		field -= GSM610_XMAXC_REDUCE;
-	else
-		field = 0;
-
-	field_index = index;
-	bitvec_write_field(frame_bitvec, &field_index, field, GSM610_XMAXC_LEN);
-
-	return field == 0;
-}
+/* RTP bit positions of the four XMAXC fields */
+static const uint16_t xmaxc_pos[4] = {
+	GSM610_RTP_XMAXC00,
+	GSM610_RTP_XMAXC10,
+	GSM610_RTP_XMAXC20,
+	GSM610_RTP_XMAXC30,
+};
 
 /**
  * Reduce all XMAXC fields in the frame. When all XMAXC fields
  * reach zero, then the function will return true.
  */
-static bool reduce_xmaxcr_all(struct bitvec *frame_bitvec)
+static bool reduce_xmaxcr_all(uint8_t *frame)
 {
 	bool silent = true;
-
-	silent &= reduce_xmaxcr(frame_bitvec, GSM610_RTP_XMAXC00);
-	silent &= reduce_xmaxcr(frame_bitvec, GSM610_RTP_XMAXC10);
-	silent &= reduce_xmaxcr(frame_bitvec, GSM610_RTP_XMAXC20);
-	silent &= reduce_xmaxcr(frame_bitvec, GSM610_RTP_XMAXC30);
+	unsigned int i;
+	uint8_t field;
+
+	for (i = 0; i < ARRAY_SIZE(xmaxc_pos); i++) {
+		field = ecu_get_field(frame, xmaxc_pos[i], GSM610_XMAXC_LEN);
+		if (field > GSM610_XMAXC_REDUCE)
+			field -= GSM610_XMAXC_REDUCE;
+		else
+			field = 0;
+		ecu_set_field(frame, xmaxc_pos[i], GSM610_XMAXC_LEN, field);
+		silent &= field == 0;
+	}
 
 	return silent;
 }
@@ -77,50 +69,19 @@ static bool reduce_xmaxcr_all(struct bitvec *frame_bitvec)
 /* Use certain modifications to conceal the errors in a full rate frame */
 static int conceal_frame(uint8_t *frame)
 {
-	struct bitvec *frame_bitvec;
-	unsigned int len;
-	bool silent;
-	int rc = 0;
-
 	/* In case we already deal with a silent frame,
 	 * there is nothing to, we just abort immediately */
 	if (osmo_fr_check_sid(frame, GSM_FR_BYTES))
 		return 0;
 
-	/* Attempt to allocate memory for bitvec */
-	frame_bitvec = bitvec_alloc(GSM_FR_BYTES, NULL);
-	if (!frame_bitvec)
-		return -ENOMEM;
-
-	/* Convert a frame to bitvec */
-	len = bitvec_unpack(frame_bitvec, frame);
-	if (len != GSM_FR_BYTES) {
-		rc = -EIO;
-		goto leave;
-	}
-
-	/* Fudge frame parameters */
-	silent = reduce_xmaxcr_all(frame_bitvec);
-
-	/* If we reached silence level, mute the frame
-	 * completely, this also means that we can
-	 * save the bitvec_pack operation */
-	if (silent) {
+	/* Fudge frame parameters, the XMAXC fields are modified in place */
+	if (reduce_xmaxcr_all(frame)) {
+		/* If we reached silence level, mute the frame completely */
 		memset(frame, 0x00, GSM_FR_BYTES);
 		frame[0] = 0xd0;
-		goto leave;
 	}
 
-	/* Convert back to packed byte form */
-	len = bitvec_pack(frame_bitvec, frame);
-	if (len != GSM_FR_BYTES) {
-		rc = -EIO;
-		goto leave;
-	}
-
-leave:
-	bitvec_free(frame_bitvec);
-	return rc;
+	return 0;
 }
 
 /*!
@@ -205,6 +166,33 @@ static int ecu_fr_frame_out(struct osmo_ecu_state *st, uint8_t *frame_out)
 		return -1;
 }
 
+static int kernel_fr_frame_in(const uint8_t *frame, unsigned int frame_bytes)
+{
+	if (frame_bytes < GSM_FR_BYTES)
+		return -EINVAL;
+	return GSM_FR_BYTES;
+}
+
+static int kernel_fr_conceal(uint8_t *frame, unsigned int frame_bytes, unsigned int lost)
+{
+	int rc;
+
+	/* the first lost frame is a plain repetition */
+	if (lost > 1) {
+		rc = conceal_frame(frame);
+		if (rc)
+			return rc;
+	}
+
+	return GSM_FR_BYTES;
+}
+
+const struct ecu_kernel ecu_kernel_fr = {
+	.max_frame_bytes = GSM_FR_BYTES,
+	.frame_in = kernel_fr_frame_in,
+	.conceal = kernel_fr_conceal,
+};
+
 static const struct osmo_ecu_ops osmo_ecu_ops_fr = {
 	.init = ecu_fr_init,
 	.frame_in = ecu_fr_frame_in,
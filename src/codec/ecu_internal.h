@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <osmocom/codec/ecu.h>
+
+/* Frame level part of the built-in ECU implementations, shared by the
+ * single channel osmo_ecu_ops and the multi-channel osmo_ecu_batch */
+struct ecu_kernel {
+	/* maximum size of a frame in bytes */
+	unsigned int max_frame_bytes;
+	/* validate a good frame, return the number of bytes to back up or negative */
+	int (*frame_in)(const uint8_t *frame, unsigned int frame_bytes);
+	/* turn the backed up frame into the substitute for the 'lost'th consecutive
+	 * lost frame (1 for the first one) in place, return its length or negative */
+	int (*conceal)(uint8_t *frame, unsigned int frame_bytes, unsigned int lost);
+};
+
+/* ecu_fr.c */
+extern const struct ecu_kernel ecu_kernel_fr;
+/* ecu_efr.c */
+extern const struct ecu_kernel ecu_kernel_efr;
+/* ecu_amr.c */
+extern const struct ecu_kernel ecu_kernel_amr;
+
+/* read a MSB first field of len (1..8) bits starting at bit pos */
+static inline uint8_t ecu_get_field(const uint8_t *frame, unsigned int pos, unsigned int len)
+{
+	unsigned int shift = 16 - (pos & 7) - len;
+	uint16_t w = frame[pos >> 3] << 8;
+
+	if (shift < 8)
+		w |= frame[(pos >> 3) + 1];
+	return (w >> shift) & ((1 << len) - 1);
+}
+
+/* write a MSB first field of len (1..8) bits starting at bit pos */
+static inline void ecu_set_field(uint8_t *frame, unsigned int pos, unsigned int len, uint8_t val)
+{
+	unsigned int shift = 16 - (pos & 7) - len;
+	uint16_t mask = ((1 << len) - 1) << shift;
+	uint16_t w = (uint16_t)val << shift;
+
+	frame[pos >> 3] = (frame[pos >> 3] & ~(mask >> 8)) | (w >> 8);
+	if (shift < 8)
+		frame[(pos >> 3) + 1] = (frame[(pos >> 3) + 1] & ~mask) | (w & 0xff);
+}
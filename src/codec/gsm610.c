@@ -26,7 +26,6 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#include <osmocom/core/bitvec.h>
 #include <osmocom/core/utils.h>
 #include <osmocom/codec/codec.h>
 
@@ -300,6 +299,30 @@ const uint16_t gsm610_bitorder[260] = {
 	29,	/* LARc5:0 */
 };
 
+/* Bits of the FR SID code word, which are all 0 in a SID frame */
+static const uint16_t fr_sid_z_bits[] = {
+	57, 58, 60, 61, 63, 64, 66, 67, 69, 70, 72, 73,
+	75, 76, 78, 79, 81, 82, 84, 85, 87, 88, 90, 91,
+	93, 94, 113, 114, 116, 117, 119, 120, 122, 123,
+	125, 126, 128, 129, 131, 132, 134, 135, 137,
+	138, 140, 141, 143, 144, 146, 147, 149, 150,
+	169, 170, 172, 173, 175, 176, 178, 179, 181,
+	182, 184, 185, 187, 188, 190, 191, 193, 194,
+	196, 197, 199, 200, 202, 203, 205, 206, 225,
+	226, 228, 229, 231, 232, 234, 235, 237, 240,
+	243, 246, 249, 252, 255, 258, 261 };
+
+/* fr_sid_z_bits as a mask over the packed RTP payload */
+static uint8_t fr_sid_mask[GSM_FR_BYTES];
+
+static __attribute__((constructor)) void on_dso_load_gsm610(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(fr_sid_z_bits); i++)
+		fr_sid_mask[fr_sid_z_bits[i] >> 3] |= 0x80 >> (fr_sid_z_bits[i] & 7);
+}
+
 /*! Check whether RTP frame contains FR SID code word according to
  *  TS 101 318 §5.1.2
  *  \param[in] rtp_payload Buffer with RTP payload
@@ -308,29 +331,19 @@ const uint16_t gsm610_bitorder[260] = {
  */
 bool osmo_fr_check_sid(const uint8_t *rtp_payload, size_t payload_len)
 {
-	struct bitvec bv;
-	uint16_t i, z_bits[] = { 57, 58, 60, 61, 63, 64, 66, 67, 69, 70, 72, 73,
-				 75, 76, 78, 79, 81, 82, 84, 85, 87, 88, 90, 91,
-				 93, 94, 113, 114, 116, 117, 119, 120, 122, 123,
-				 125, 126, 128, 129, 131, 132, 134, 135, 137,
-				 138, 140, 141, 143, 144, 146, 147, 149, 150,
-				 169, 170, 172, 173, 175, 176, 178, 179, 181,
-				 182, 184, 185, 187, 188, 190, 191, 193, 194,
-				 196, 197, 199, 200, 202, 203, 205, 206, 225,
-				 226, 228, 229, 231, 232, 234, 235, 237, 240,
-				 243, 246, 249, 252, 255, 258, 261 };
+	uint8_t set = 0;
+	unsigned int i;
 
 	/* signature does not match Full Rate SID */
 	if ((rtp_payload[0] >> 4) != 0xD)
 		return false;
 
-	bv.data = (uint8_t *) rtp_payload;
-	bv.data_len = payload_len;
+	if (payload_len < GSM_FR_BYTES)
+		return false;
 
 	/* code word is all 0 at given bits, numbered from 1 */
-	for (i = 0; i < ARRAY_SIZE(z_bits); i++)
-		if (bitvec_get_bit_pos(&bv, z_bits[i]) != ZERO)
-			return false;
+	for (i = 0; i < GSM_FR_BYTES; i++)
+		set |= rtp_payload[i] & fr_sid_mask[i];
 
-	return true;
+	return set == 0;
 }
@@ -26,7 +26,6 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#include <osmocom/core/bitvec.h>
 #include <osmocom/core/utils.h>
 #include <osmocom/codec/codec.h>
 
@@ -268,11 +267,11 @@ const uint16_t gsm620_voiced_bitorder[112] = {
 	81,	/* Code 3:7 */
 };
 
-static inline uint16_t mask(const uint8_t msb)
-{
-	const uint16_t m = (uint16_t)1  << (msb - 1);
-	return (m - 1) ^ m;
-}
+/* INT_LPC, MODE (always 3 for SID) and the HR SID code word, which are all 1
+ * in a SID frame: bit 33 (after R0 and LPC1..3) up to the end of the frame */
+static const uint8_t hr_sid_mask[GSM_HR_BYTES] = {
+	0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
 
 /*! Check whether RTP frame contains HR SID code word according to
  *  TS 101 318 §5.2.2
@@ -282,16 +281,15 @@ static inline uint16_t mask(const uint8_t msb)
  */
 bool osmo_hr_check_sid(const uint8_t *rtp_payload, size_t payload_len)
 {
-	uint8_t i, bits[] = { 1, 2, 8, 9, 5, 4, 9, 5, 4, 9, 5, 4, 9, 5 };
-	struct bitvec bv;
-	bv.data = (uint8_t *) rtp_payload;
-	bv.data_len = payload_len;
-	bv.cur_bit = 33;
+	uint8_t unset = 0;
+	unsigned int i;
+
+	if (payload_len < GSM_HR_BYTES)
+		return false;
 
-	/* code word is all 1 at given bits, numbered from 1, MODE is always 3 */
-	for (i = 0; i < ARRAY_SIZE(bits); i++)
-		if (bitvec_get_uint(&bv, bits[i]) != mask(bits[i]))
-			return false;
+	/* code word is all 1 at given bits */
+	for (i = 0; i < GSM_HR_BYTES; i++)
+		unset |= ~rtp_payload[i] & hr_sid_mask[i];
 
-	return true;
+	return unset == 0;
 }
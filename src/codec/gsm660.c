@@ -24,6 +24,9 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include <osmocom/core/utils.h>
 #include <osmocom/codec/codec.h>
 
 /* GSM EFR - subjective importance bit ordering */
@@ -257,3 +260,53 @@ const uint16_t gsm660_bitorder[260] = {
 	243,					/* 258 -> PULSE 4_9: b0     */
 	246,					/* 259 -> PULSE 4_10: b0    */
 };
+
+/* Bits of the EFR SID code word (GSM 06.62 §5.3), which are all 1 in a SID
+ * frame, numbered from the beginning of the 244 bit frame */
+static const uint16_t efr_sid_code_word_bits[95] = {
+	45, 46, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61,
+	62, 63, 64, 65, 66, 67, 68, 94, 95, 96, 98, 99, 100, 101, 102,
+	103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115,
+	116, 117, 118, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157,
+	158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170,
+	171, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+	208, 209, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221 };
+
+/* efr_sid_code_word_bits as a mask over the packed RTP payload */
+static uint8_t efr_sid_mask[GSM_EFR_BYTES];
+
+static __attribute__((constructor)) void on_dso_load_gsm660(void)
+{
+	unsigned int i, bit;
+
+	for (i = 0; i < ARRAY_SIZE(efr_sid_code_word_bits); i++) {
+		/* skip the 4 bit signature */
+		bit = efr_sid_code_word_bits[i] + 4;
+		efr_sid_mask[bit >> 3] |= 0x80 >> (bit & 7);
+	}
+}
+
+/*! Check whether RTP frame contains EFR SID code word according to
+ *  TS 101 318 §5.3.2
+ *  \param[in] rtp_payload Buffer with RTP payload
+ *  \param[in] payload_len Length of payload
+ *  \returns true if code word is found, false otherwise
+ */
+bool osmo_efr_check_sid(const uint8_t *rtp_payload, size_t payload_len)
+{
+	uint8_t unset = 0;
+	unsigned int i;
+
+	/* signature does not match EFR */
+	if ((rtp_payload[0] >> 4) != 0xC)
+		return false;
+
+	if (payload_len < GSM_EFR_BYTES)
+		return false;
+
+	/* code word is all 1 at given bits */
+	for (i = 0; i < GSM_EFR_BYTES; i++)
+		unset |= ~rtp_payload[i] & efr_sid_mask[i];
+
+	return unset == 0;
+}
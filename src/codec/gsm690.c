@@ -397,6 +397,22 @@ int osmo_amr_rtp_dec(const uint8_t *rtppayload, int payload_len, uint8_t *cmr,
 	return 2 + amr_len_by_ft[type];
 }
 
+/*! Check whether RTP payload (RFC 4867, octet-aligned) contains an AMR SID
+ *  frame and tell SID_FIRST from SID_UPDATE according to 3GPP TS 26.101
+ *  \param[in] rtp_payload Buffer with RTP payload
+ *  \param[in] payload_len Length of payload
+ *  \returns OSMO_AMR_SID_FIRST or OSMO_AMR_SID_UPDATE for a SID frame, OSMO_AMR_SID_NONE otherwise
+ */
+enum osmo_amr_sid_type osmo_amr_check_sid(const uint8_t *rtp_payload, size_t payload_len)
+{
+	/* F = 0, FT = AMR_SID, the quality bit is not considered */
+	if (payload_len < 2 + 5 || (rtp_payload[1] & 0xf8) != (AMR_SID << 3))
+		return OSMO_AMR_SID_NONE;
+
+	/* STI, following the 35 comfort noise bits */
+	return (rtp_payload[6] & 0x10) ? OSMO_AMR_SID_UPDATE : OSMO_AMR_SID_FIRST;
+}
+
 /*! Encode various AMR parameters from RTP payload (RFC 4867)
  *  \param[out] payload Payload for RTP packet, contains speech data (if any)
  *              except for have 2 first bytes where header will be built
@@ -0,0 +1,70 @@
+/*! \file sid.c
+ * SID frame detection on many RTP payloads at once. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <osmocom/codec/codec.h>
+
+static bool amr_check_sid(const uint8_t *rtp_payload, size_t payload_len)
+{
+	return osmo_amr_check_sid(rtp_payload, payload_len) != OSMO_AMR_SID_NONE;
+}
+
+/*! Check many RTP payloads of the same codec for SID frames, e.g. all uplink
+ *  frames of one 20 ms period, see osmo_fr_check_sid() and friends.
+ *  \param[in] codec codec of all payloads
+ *  \param[in] rtp_payloads RTP payloads, num entries
+ *  \param[in] payload_lens lengths of the RTP payloads, num entries
+ *  \param[in] num number of payloads
+ *  \param[out] is_sid whether each payload is a SID frame (AMR: SID_FIRST or SID_UPDATE), num entries
+ *  \returns number of SID frames; negative on error */
+int osmo_check_sid_batch(enum osmo_sid_codec codec, const uint8_t * const *rtp_payloads,
+			 const size_t *payload_lens, unsigned int num, bool *is_sid)
+{
+	bool (*check_sid)(const uint8_t *rtp_payload, size_t payload_len);
+	unsigned int i;
+	int count = 0;
+
+	switch (codec) {
+	case OSMO_SID_CODEC_FR:
+		check_sid = osmo_fr_check_sid;
+		break;
+	case OSMO_SID_CODEC_HR:
+		check_sid = osmo_hr_check_sid;
+		break;
+	case OSMO_SID_CODEC_EFR:
+		check_sid = osmo_efr_check_sid;
+		break;
+	case OSMO_SID_CODEC_AMR:
+		check_sid = amr_check_sid;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	for (i = 0; i < num; i++) {
+		is_sid[i] = check_sid(rtp_payloads[i], payload_lens[i]);
+		count += is_sid[i];
+	}
+
+	return count;
+}
@@ -1513,127 +1513,269 @@ int gsm0503_pdtch_encode(ubit_t *bursts, const uint8_t *l2_data, uint8_t l2_len)
  * GSM TCH/F FR/EFR transcoding
  */
 
-/*! assemble a FR codec frame in format as used inside RTP
- *  \param[out] tch_data Codec frame in RTP format
- *  \param[in] b_bits Codec frame in 'native' format
- *  \param[in] net_order FIXME */
-static void tch_fr_reassemble(uint8_t *tch_data,
-	const ubit_t *b_bits, int net_order)
+/* pack n ubits MSB first into bytes */
+static void tch_pack_bits(uint8_t *out, const ubit_t *in, int n)
 {
-	int i, j, k, l, o;
+	int i;
+
+	for (; n >= 8; n -= 8, in += 8) {
+		*out++ = (in[0] << 7) | (in[1] << 6) | (in[2] << 5) | (in[3] << 4)
+		       | (in[4] << 3) | (in[5] << 2) | (in[6] << 1) | in[7];
+	}
 
-	tch_data[0] = 0xd << 4;
-	memset(tch_data + 1, 0, 32);
+	if (n) {
+		*out = 0;
+		for (i = 0; i < n; i++)
+			*out |= in[i] << (7 - i);
+	}
+}
 
-	if (net_order) {
-		for (i = 0, j = 4; i < 260; i++, j++)
-			tch_data[j >> 3] |= (b_bits[i] << (7 - (j & 7)));
+/* unpack n ubits MSB first from bytes */
+static void tch_unpack_bits(ubit_t *out, const uint8_t *in, int n)
+{
+	int i;
 
-		return;
+	for (; n >= 8; n -= 8, out += 8) {
+		uint8_t byte = *in++;
+		out[0] = byte >> 7;
+		out[1] = (byte >> 6) & 1;
+		out[2] = (byte >> 5) & 1;
+		out[3] = (byte >> 4) & 1;
+		out[4] = (byte >> 3) & 1;
+		out[5] = (byte >> 2) & 1;
+		out[6] = (byte >> 1) & 1;
+		out[7] = byte & 1;
 	}
 
-	/* reassemble d-bits */
-	i = 0; /* counts bits */
-	j = 4; /* counts output bits */
-	k = gsm0503_gsm_fr_map[0]-1; /* current number bit in element */
-	l = 0; /* counts element bits */
-	o = 0; /* offset input bits */
-	while (i < 260) {
-		tch_data[j >> 3] |= (b_bits[k + o] << (7 - (j & 7)));
-		if (--k < 0) {
-			o += gsm0503_gsm_fr_map[l];
-			k = gsm0503_gsm_fr_map[++l]-1;
-		}
-		i++;
-		j++;
+	for (i = 0; i < n; i++)
+		out[i] = (*in >> (7 - i)) & 1;
+}
+
+/* unpack n ubits MSB first from bytes, starting at bit offset of in */
+static void tch_unpack_bits_at(ubit_t *out, const uint8_t *in, int offset, int n)
+{
+	in += offset >> 3;
+	offset &= 7;
+
+	if (offset) {
+		for (; offset < 8 && n > 0; offset++, n--)
+			*out++ = (*in >> (7 - offset)) & 1;
+		in++;
 	}
+
+	if (n > 0)
+		tch_unpack_bits(out, in, n);
 }
 
-static void tch_fr_disassemble(ubit_t *b_bits,
-	const uint8_t *tch_data, int net_order)
+/* pack n ubits MSB first into bytes, starting at bit offset of out; a partially
+ * filled byte at offset must have its remaining (low) bits cleared, as left by
+ * tch_pack_bits() */
+static void tch_pack_bits_at(uint8_t *out, int offset, const ubit_t *in, int n)
 {
-	int i, j, k, l, o;
+	out += offset >> 3;
+	offset &= 7;
+
+	if (offset) {
+		for (; offset < 8 && n > 0; offset++, n--)
+			*out |= *in++ << (7 - offset);
+		out++;
+	}
+
+	if (n > 0)
+		tch_pack_bits(out, in, n);
+}
+
+/* The FR and EFR d-bits are reached from the RTP payload through several
+ * consecutive permutations (RTP bit order, TS 05.03 Table 2 / Table 6, EFR
+ * bit repetition).  They are fused into single lookup tables at load time, so
+ * that each frame only needs one gather pass in either direction. */
 
-	if (net_order) {
-		for (i = 0, j = 4; i < 260; i++, j++)
-			b_bits[i] = (tch_data[j >> 3] >> (7 - (j & 7))) & 1;
+/* FR: RTP bit number (including the 4 bit signature) of each d-bit, indexed by net_order */
+static uint16_t fr_d_to_rtp[2][260];
+/* FR: d-bit carried by each RTP bit after the 4 bit signature, indexed by net_order */
+static uint16_t fr_rtp_to_d[2][260];
 
-		return;
+/* EFR: the four s-bits that are transmitted twice more in w (TS 05.03 3.1.1.2) */
+static const struct {
+	uint8_t s;	/* s-bit, position of the first copy in w is s + 2 * index */
+	uint8_t min;	/* minimum number of set copies for the majority decision */
+} efr_rep_bits[4] = {
+	{ 69, 2 },
+	{ 119, 2 },
+	{ 172, 3 },
+	{ 222, 2 },
+};
+/* EFR: index into s[244] + p[8] of each d-bit */
+static uint8_t efr_d_to_sp[260];
+/* EFR: d-bit carrying each bit of s[244] + p[8] */
+static uint16_t efr_sp_to_d[252];
+/* EFR: d-bits carrying the two repetitions of efr_rep_bits[] */
+static uint16_t efr_rep_to_d[4][2];
+
+static __attribute__((constructor)) void on_dso_load_gsm0503_coding(void)
+{
+	uint16_t rtp_to_b[260], b_to_rtp[260], w_to_sp[260], w_to_d[260];
+	int i, k, l, o, n;
+
+	/* FR, RTP bit order as in tch_fr_{re,dis}assemble() of TS 05.03 Table 2 */
+	for (n = 0; n < 2; n++) {
+		if (n) {
+			for (i = 0; i < 260; i++)
+				rtp_to_b[i] = i;
+		} else {
+			k = gsm0503_gsm_fr_map[0] - 1; /* current number bit in element */
+			l = 0; /* counts element bits */
+			o = 0; /* offset output bits */
+			for (i = 0; i < 260; i++) {
+				rtp_to_b[i] = k + o;
+				if (--k < 0) {
+					o += gsm0503_gsm_fr_map[l];
+					k = gsm0503_gsm_fr_map[++l] - 1;
+				}
+			}
+		}
+
+		for (i = 0; i < 260; i++)
+			b_to_rtp[rtp_to_b[i]] = i;
+
+		for (i = 0; i < 260; i++) {
+			fr_d_to_rtp[n][i] = b_to_rtp[gsm610_bitorder[i]] + 4;
+			fr_rtp_to_d[n][b_to_rtp[gsm610_bitorder[i]]] = i;
+		}
 	}
 
-	i = 0; /* counts bits */
-	j = 4; /* counts input bits */
-	k = gsm0503_gsm_fr_map[0] - 1; /* current number bit in element */
-	l = 0; /* counts element bits */
-	o = 0; /* offset output bits */
-	while (i < 260) {
-		b_bits[k + o] = (tch_data[j >> 3] >> (7 - (j & 7))) & 1;
-		if (--k < 0) {
-			o += gsm0503_gsm_fr_map[l];
-			k = gsm0503_gsm_fr_map[++l] - 1;
+	/* EFR, s[] + p[] -> w[] (with repetitions) -> d[] */
+	for (i = 0, n = 0, k = 0; i < 260; i++) {
+		if (k < ARRAY_SIZE(efr_rep_bits) && i == efr_rep_bits[k].s + 2 * k + 2) {
+			/* both copies follow the s-bit after the repeated one */
+			w_to_sp[i] = w_to_sp[i + 1] = efr_rep_bits[k].s;
+			i++;
+			k++;
+			continue;
+		}
+		w_to_sp[i] = n++;
+	}
+
+	for (i = 0; i < 260; i++)
+		w_to_d[gsm660_bitorder[i]] = i;
+
+	for (i = 0; i < 260; i++)
+		efr_d_to_sp[i] = w_to_sp[gsm660_bitorder[i]];
+
+	for (i = 0, k = 0; i < 260; i++) {
+		if (k < ARRAY_SIZE(efr_rep_bits) && i == efr_rep_bits[k].s + 2 * k + 2) {
+			efr_rep_to_d[k][0] = w_to_d[i];
+			efr_rep_to_d[k][1] = w_to_d[i + 1];
+			i++;
+			k++;
+			continue;
 		}
-		i++;
-		j++;
+		efr_sp_to_d[w_to_sp[i]] = w_to_d[i];
 	}
 }
 
-/* assemble a HR codec frame in format as used inside RTP */
-static void tch_hr_reassemble(uint8_t *tch_data, const ubit_t *b_bits)
+/*! assemble a FR codec frame in format as used inside RTP
+ *  \param[out] tch_data Codec frame in RTP format
+ *  \param[in] d_bits Codec frame as d-bits of TS 05.03 Table 2
+ *  \param[in] net_order FIXME */
+static void tch_fr_reassemble(uint8_t *tch_data,
+	const ubit_t *d_bits, int net_order)
 {
-	int i, j;
+	const uint16_t *map = fr_rtp_to_d[!!net_order];
+	int i;
 
-	tch_data[0] = 0x00; /* F = 0, FT = 000 */
-	memset(tch_data + 1, 0, 14);
+	tch_data[0] = (0xd << 4) | (d_bits[map[0]] << 3) | (d_bits[map[1]] << 2)
+		    | (d_bits[map[2]] << 1) | d_bits[map[3]];
 
-	for (i = 0, j = 8; i < 112; i++, j++)
-		tch_data[j >> 3] |= (b_bits[i] << (7 - (j & 7)));
+	for (i = 1, map += 4; i < 33; i++, map += 8) {
+		tch_data[i] = (d_bits[map[0]] << 7) | (d_bits[map[1]] << 6)
+			    | (d_bits[map[2]] << 5) | (d_bits[map[3]] << 4)
+			    | (d_bits[map[4]] << 3) | (d_bits[map[5]] << 2)
+			    | (d_bits[map[6]] << 1) | d_bits[map[7]];
+	}
 }
 
-static void tch_hr_disassemble(ubit_t *b_bits, const uint8_t *tch_data)
+static void tch_fr_disassemble(ubit_t *d_bits,
+	const uint8_t *tch_data, int net_order)
 {
-	int i, j;
+	const uint16_t *map = fr_d_to_rtp[!!net_order];
+	int i;
 
-	for (i = 0, j = 8; i < 112; i++, j++)
-		b_bits[i] = (tch_data[j >> 3] >> (7 - (j & 7))) & 1;
+	for (i = 0; i < 260; i++)
+		d_bits[i] = (tch_data[map[i] >> 3] >> (7 - (map[i] & 7))) & 1;
 }
 
-/* assemble a EFR codec frame in format as used inside RTP */
-static void tch_efr_reassemble(uint8_t *tch_data, const ubit_t *b_bits)
+/* assemble a HR codec frame in format as used inside RTP */
+static void tch_hr_reassemble(uint8_t *tch_data, const ubit_t *b_bits)
 {
-	int i, j;
-
-	tch_data[0] = 0xc << 4;
-	memset(tch_data + 1, 0, 30);
+	tch_data[0] = 0x00; /* F = 0, FT = 000 */
+	tch_pack_bits(tch_data + 1, b_bits, 112);
+}
 
-	for (i = 0, j = 4; i < 244; i++, j++)
-		tch_data[j >> 3] |= (b_bits[i] << (7 - (j & 7)));
+static void tch_hr_disassemble(ubit_t *b_bits, const uint8_t *tch_data)
+{
+	tch_unpack_bits(b_bits, tch_data + 1, 112);
 }
 
-static void tch_efr_disassemble(ubit_t *b_bits, const uint8_t *tch_data)
+/* extract the 65 protected class1a+1b bits */
+static void tch_efr_protected(const ubit_t *s_bits, ubit_t *b_bits)
 {
-	int i, j;
+	int i;
 
-	for (i = 0, j = 4; i < 244; i++, j++)
-		b_bits[i] = (tch_data[j >> 3] >> (7 - (j & 7))) & 1;
+	for (i = 0; i < 65; i++)
+		b_bits[i] = s_bits[gsm0503_gsm_efr_protected_bits[i] - 1];
 }
 
-/* assemble a AMR codec frame in format as used inside RTP */
-static void tch_amr_reassemble(uint8_t *tch_data, const ubit_t *d_bits, int len)
+/*! assemble a EFR codec frame in format as used inside RTP
+ *  \param[out] tch_data Codec frame in RTP format
+ *  \param[in] d_bits Coded frame as d-bits of TS 05.03 Table 6
+ *  \returns 0 on success; negative if the CRC-8 over the protected bits fails */
+static int tch_efr_reassemble(uint8_t *tch_data, const ubit_t *d_bits)
 {
-	int i, j;
+	ubit_t sp[252], b[65];
+	int i, sum;
+
+	for (i = 0; i < 252; i++)
+		sp[i] = d_bits[efr_sp_to_d[i]];
+
+	/* majority decision over the repeated bits */
+	for (i = 0; i < ARRAY_SIZE(efr_rep_bits); i++) {
+		sum = sp[efr_rep_bits[i].s] + d_bits[efr_rep_to_d[i][0]] + d_bits[efr_rep_to_d[i][1]];
+		sp[efr_rep_bits[i].s] = (sum >= efr_rep_bits[i].min);
+	}
+
+	/* extract the 65 most important bits according TS 05.03 3.1.1.1 and
+	 * perform CRC-8 on them (50 bits of class 1a + 15 bits of class 1b) */
+	tch_efr_protected(sp, b);
+	if (osmo_crc8gen_check_bits(&gsm0503_tch_efr_crc8, b, 65, sp + 244))
+		return -1;
 
-	memset(tch_data, 0, (len + 7) >> 3);
+	tch_data[0] = (0xc << 4) | (sp[0] << 3) | (sp[1] << 2) | (sp[2] << 1) | sp[3];
+	tch_pack_bits(tch_data + 1, sp + 4, 240);
 
-	for (i = 0, j = 0; i < len; i++, j++)
-		tch_data[j >> 3] |= (d_bits[i] << (7 - (j & 7)));
+	return 0;
 }
 
-static void tch_amr_disassemble(ubit_t *d_bits, const uint8_t *tch_data, int len)
+static void tch_efr_disassemble(ubit_t *d_bits, const uint8_t *tch_data)
 {
-	int i, j;
+	ubit_t sp[252], b[65];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		sp[i] = (tch_data[0] >> (3 - i)) & 1;
+	tch_unpack_bits(sp + 4, tch_data + 1, 240);
 
-	for (i = 0, j = 0; i < len; i++, j++)
-		d_bits[i] = (tch_data[j >> 3] >> (7 - (j & 7))) & 1;
+	tch_efr_protected(sp, b);
+	osmo_crc8gen_set_bits(&gsm0503_tch_efr_crc8, b, 65, sp + 244);
+
+	for (i = 0; i < 260; i++)
+		d_bits[i] = sp[efr_d_to_sp[i]];
+}
+
+/* assemble a AMR codec frame in format as used inside RTP */
+static void tch_amr_reassemble(uint8_t *tch_data, const ubit_t *d_bits, int len)
+{
+	tch_pack_bits(tch_data, d_bits, len);
 }
 
 /* Append STI and MI bits to the SID_UPDATE frame, see also
@@ -1669,24 +1811,6 @@ static void extract_afs_sid_update(sbit_t *sid_update, const sbit_t *sbits)
 
 }
 
-/* re-arrange according to TS 05.03 Table 2 (receiver) */
-static void tch_fr_d_to_b(ubit_t *b_bits, const ubit_t *d_bits)
-{
-	int i;
-
-	for (i = 0; i < 260; i++)
-		b_bits[gsm610_bitorder[i]] = d_bits[i];
-}
-
-/* re-arrange according to TS 05.03 Table 2 (transmitter) */
-static void tch_fr_b_to_d(ubit_t *d_bits, const ubit_t *b_bits)
-{
-	int i;
-
-	for (i = 0; i < 260; i++)
-		d_bits[i] = b_bits[gsm610_bitorder[i]];
-}
-
 /* re-arrange according to TS 05.03 Table 3a (receiver) */
 static void tch_hr_d_to_b(ubit_t *b_bits, const ubit_t *d_bits)
 {
@@ -1718,33 +1842,6 @@ static void tch_hr_b_to_d(ubit_t *d_bits, const ubit_t *b_bits)
 		d_bits[i] = b_bits[map[i]];
 }
 
-/* re-arrange according to TS 05.03 Table 6 (receiver) */
-static void tch_efr_d_to_w(ubit_t *b_bits, const ubit_t *d_bits)
-{
-	int i;
-
-	for (i = 0; i < 260; i++)
-		b_bits[gsm660_bitorder[i]] = d_bits[i];
-}
-
-/* re-arrange according to TS 05.03 Table 6 (transmitter) */
-static void tch_efr_w_to_d(ubit_t *d_bits, const ubit_t *b_bits)
-{
-	int i;
-
-	for (i = 0; i < 260; i++)
-		d_bits[i] = b_bits[gsm660_bitorder[i]];
-}
-
-/* extract the 65 protected class1a+1b bits */
-static void tch_efr_protected(const ubit_t *s_bits, ubit_t *b_bits)
-{
-	int i;
-
-	for (i = 0; i < 65; i++)
-		b_bits[i] = s_bits[gsm0503_gsm_efr_protected_bits[i] - 1];
-}
-
 static void tch_fr_unreorder(ubit_t *d, ubit_t *p, const ubit_t *u)
 {
 	int i;
@@ -1783,52 +1880,20 @@ static void tch_hr_reorder(ubit_t *u, const ubit_t *d, const ubit_t *p)
 	memcpy(u + 95, p, 3);
 }
 
-static void tch_efr_reorder(ubit_t *w, const ubit_t *s, const ubit_t *p)
-{
-	memcpy(w, s, 71);
-	w[71] = w[72] = s[69];
-	memcpy(w + 73, s + 71, 50);
-	w[123] = w[124] = s[119];
-	memcpy(w + 125, s + 121, 53);
-	w[178] = w[179] = s[172];
-	memcpy(w + 180, s + 174, 50);
-	w[230] = w[231] = s[222];
-	memcpy(w + 232, s + 224, 20);
-	memcpy(w + 252, p, 8);
-}
-
-static void tch_efr_unreorder(ubit_t *s, ubit_t *p, const ubit_t *w)
-{
-	int sum;
-
-	memcpy(s, w, 71);
-	sum = s[69] + w[71] + w[72];
-	s[69] = (sum >= 2);
-	memcpy(s + 71, w + 73, 50);
-	sum = s[119] + w[123] + w[124];
-	s[119] = (sum >= 2);
-	memcpy(s + 121, w + 125, 53);
-	sum = s[172] + w[178] + w[179];
-	s[172] = (sum > 2);
-	memcpy(s + 174, w + 180, 50);
-	sum = s[222] + w[230] + w[231];
-	s[222] = (sum >= 2);
-	memcpy(s + 224, w + 232, 20);
-	memcpy(p, w + 252, 8);
-}
-
-static void tch_amr_merge(ubit_t *u, const ubit_t *d, const ubit_t *p, int len, int prot)
+/* Unpack the len d-bits of an AMR payload straight into the channel coder input u:
+ * the first prot d-bits, their 6 bit CRC (TS 45.003 3.9.4.3) and the remaining d-bits. */
+static void tch_amr_unpack_merge(ubit_t *u, const uint8_t *tch_data, int len, int prot)
 {
-	memcpy(u, d, prot);
-	memcpy(u + prot, p, 6);
-	memcpy(u + prot + 6, d + prot, len - prot);
+	tch_unpack_bits_at(u, tch_data, 0, prot);
+	osmo_crc8gen_set_bits(&gsm0503_amr_crc6, u, prot, u + prot);
+	tch_unpack_bits_at(u + prot + 6, tch_data, prot, len - prot);
 }
 
-static void tch_amr_unmerge(ubit_t *d, ubit_t *p, const ubit_t *u, int len, int prot)
+/* Pack the len d-bits of the channel decoder output u into an AMR payload, skipping the CRC */
+static void tch_amr_unmerge_pack(uint8_t *tch_data, const ubit_t *u, int len, int prot)
 {
-	memcpy(d, u, prot);
-	memcpy(p, u + prot, 6);
-	memcpy(d + prot, u + prot + 6, len - prot);
+	tch_pack_bits(tch_data, u, prot);
+	tch_pack_bits_at(tch_data, prot, u + prot + 6, len - prot);
 }
 
 /*! Perform channel decoding of a FR/EFR channel according TS 05.03
@@ -1843,7 +1908,7 @@ int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
 	int net_order, int efr, int *n_errors, int *n_bits_total)
 {
 	sbit_t iB[912], cB[456], h;
-	ubit_t conv[185], s[244], w[260], b[65], d[260], p[8];
+	ubit_t conv[185], d[260], p[3];
 	int i, rv, len, steal = 0;
 
 	/* map from 8 bursts to interleaved data bits (iB) */
@@ -1885,31 +1950,17 @@ int gsm0503_tch_fr_decode(uint8_t *tch_data, const sbit_t *bursts,
 	}
 
 	if (efr) {
-		tch_efr_d_to_w(w, d);
-		/* we now have the preliminary-coded bits w(k) */
-
-		tch_efr_unreorder(s, p, w);
-		/* we now have the data delivered to the preliminary
-		 * channel encoding unit s(k) */
-
-		/* extract the 65 most important bits according TS 05.03 3.1.1.1 */
-		tch_efr_protected(s, b);
-
-		/* perform CRC-8 on 65 most important bits (50 bits of
-		 * class 1a + 15 bits of class 1b) */
-		rv = osmo_crc8gen_check_bits(&gsm0503_tch_efr_crc8, b, 65, p);
+		/* undo the preliminary channel coding of TS 05.03 3.1.1 and
+		 * check the CRC-8 over the 65 most important bits */
+		rv = tch_efr_reassemble(tch_data, d);
 		if (rv) {
 			/* Error checking CRC8 for the EFR part of an EFR frame */
 			return -1;
 		}
 
-		tch_efr_reassemble(tch_data, s);
-
 		len = GSM_EFR_BYTES;
 	} else {
-		tch_fr_d_to_b(w, d);
-
-		tch_fr_reassemble(tch_data, w, net_order);
+		tch_fr_reassemble(tch_data, d, net_order);
 
 		len = GSM_FR_BYTES;
 	}
@@ -1927,27 +1978,16 @@ int gsm0503_tch_fr_encode(ubit_t *bursts, const uint8_t *tch_data,
 	int len, int net_order)
 {
 	ubit_t iB[912], cB[456], h;
-	ubit_t conv[185], w[260], b[65], s[244], d[260], p[8];
+	ubit_t conv[185], d[260], p[3];
 	int i;
 
 	switch (len) {
 	case GSM_EFR_BYTES: /* TCH EFR */
-
-		tch_efr_disassemble(s, tch_data);
-
-		tch_efr_protected(s, b);
-
-		osmo_crc8gen_set_bits(&gsm0503_tch_efr_crc8, b, 65, p);
-
-		tch_efr_reorder(w, s, p);
-
-		tch_efr_w_to_d(d, w);
+		tch_efr_disassemble(d, tch_data);
 
 		goto coding_efr_fr;
 	case GSM_FR_BYTES: /* TCH FR */
-		tch_fr_disassemble(w, tch_data, net_order);
-
-		tch_fr_b_to_d(d, w);
+		tch_fr_disassemble(d, tch_data, net_order);
 
 coding_efr_fr:
 		osmo_crc8gen_set_bits(&gsm0503_tch_fr_crc3, d, 50, p);
@@ -2159,7 +2199,7 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 	uint8_t *cmr, int *n_errors, int *n_bits_total, uint8_t *dtx)
 {
 	sbit_t iB[912], cB[456], h;
-	ubit_t d[244], p[6], conv[250];
+	ubit_t conv[250];
 	int i, j, k, best = 0, rv, len, steal = 0, id = 0;
 	ubit_t cBd[456];
 	*n_errors = 0; *n_bits_total = 0;
@@ -2249,15 +2289,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_12_2, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 244, 81);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 81, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 81, conv + 81);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 12.2 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 244);
+		tch_amr_unmerge_pack(tch_data, conv, 244, 81);
 
 		len = 31;
 
@@ -2266,15 +2304,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_10_2, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 204, 65);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 65, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 65, conv + 65);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 10.2 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 204);
+		tch_amr_unmerge_pack(tch_data, conv, 204, 65);
 
 		len = 26;
 
@@ -2283,15 +2319,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_7_95, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 159, 75);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 75, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 75, conv + 75);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 7.95 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 159);
+		tch_amr_unmerge_pack(tch_data, conv, 159, 75);
 
 		len = 20;
 
@@ -2300,15 +2334,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_7_4, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 148, 61);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 61, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 61, conv + 61);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 7.4 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 148);
+		tch_amr_unmerge_pack(tch_data, conv, 148, 61);
 
 		len = 19;
 
@@ -2317,15 +2349,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_6_7, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 134, 55);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 55, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 55, conv + 55);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 6.7 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 134);
+		tch_amr_unmerge_pack(tch_data, conv, 134, 55);
 
 		len = 17;
 
@@ -2334,15 +2364,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_5_9, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 118, 55);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 55, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 55, conv + 55);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 5.9 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 118);
+		tch_amr_unmerge_pack(tch_data, conv, 118, 55);
 
 		len = 15;
 
@@ -2351,15 +2379,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_5_15, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 103, 49);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 49, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 49, conv + 49);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 5.15 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 103);
+		tch_amr_unmerge_pack(tch_data, conv, 103, 49);
 
 		len = 13;
 
@@ -2368,15 +2394,13 @@ int gsm0503_tch_afs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts,
 		osmo_conv_decode_ber(&gsm0503_tch_afs_4_75, cB + 8,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 95, 39);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 39, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 39, conv + 39);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 4.75 frame */
 			return -1;
 		}
 
-		tch_amr_reassemble(tch_data, d, 95);
+		tch_amr_unmerge_pack(tch_data, conv, 95, 39);
 
 		len = 12;
 
@@ -2413,7 +2437,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 	uint8_t cmr)
 {
 	ubit_t iB[912], cB[456], h;
-	ubit_t d[244], p[6], conv[250];
+	ubit_t conv[250];
 	int i;
 	uint8_t id;
 
@@ -2446,11 +2470,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 31)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 244);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 81, p);
-
-		tch_amr_merge(conv, d, p, 244, 81);
+		tch_amr_unpack_merge(conv, tch_data, 244, 81);
 
 		osmo_conv_encode(&gsm0503_tch_afs_12_2, conv, cB + 8);
 
@@ -2459,11 +2479,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 26)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 204);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 65, p);
-
-		tch_amr_merge(conv, d, p, 204, 65);
+		tch_amr_unpack_merge(conv, tch_data, 204, 65);
 
 		osmo_conv_encode(&gsm0503_tch_afs_10_2, conv, cB + 8);
 
@@ -2472,11 +2488,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 20)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 159);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 75, p);
-
-		tch_amr_merge(conv, d, p, 159, 75);
+		tch_amr_unpack_merge(conv, tch_data, 159, 75);
 
 		osmo_conv_encode(&gsm0503_tch_afs_7_95, conv, cB + 8);
 
@@ -2485,11 +2497,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 19)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 148);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 61, p);
-
-		tch_amr_merge(conv, d, p, 148, 61);
+		tch_amr_unpack_merge(conv, tch_data, 148, 61);
 
 		osmo_conv_encode(&gsm0503_tch_afs_7_4, conv, cB + 8);
 
@@ -2498,11 +2506,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 17)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 134);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 55, p);
-
-		tch_amr_merge(conv, d, p, 134, 55);
+		tch_amr_unpack_merge(conv, tch_data, 134, 55);
 
 		osmo_conv_encode(&gsm0503_tch_afs_6_7, conv, cB + 8);
 
@@ -2511,11 +2515,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 15)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 118);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 55, p);
-
-		tch_amr_merge(conv, d, p, 118, 55);
+		tch_amr_unpack_merge(conv, tch_data, 118, 55);
 
 		osmo_conv_encode(&gsm0503_tch_afs_5_9, conv, cB + 8);
 
@@ -2524,11 +2524,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 13)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 103);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 49, p);
-
-		tch_amr_merge(conv, d, p, 103, 49);
+		tch_amr_unpack_merge(conv, tch_data, 103, 49);
 
 		osmo_conv_encode(&gsm0503_tch_afs_5_15, conv, cB + 8);
 
@@ -2537,11 +2533,7 @@ int gsm0503_tch_afs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 12)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 95);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 39, p);
-
-		tch_amr_merge(conv, d, p, 95, 39);
+		tch_amr_unpack_merge(conv, tch_data, 95, 39);
 
 		osmo_conv_encode(&gsm0503_tch_afs_4_75, conv, cB + 8);
 
@@ -2611,7 +2603,7 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 	uint8_t *cmr, int *n_errors, int *n_bits_total, uint8_t *dtx)
 {
 	sbit_t iB[912], cB[456], h;
-	ubit_t d[244], p[6], conv[135];
+	ubit_t conv[165];
 	int i, j, k, best = 0, rv, len, steal = 0, id = 0;
 	ubit_t cBd[456];
 	static ubit_t sid_first_dummy[64] = { 0 };
@@ -2726,18 +2718,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_7_95, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 123, 67);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 67, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 67, conv + 67);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 7.95 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 36; i++)
-			d[i + 123] = (cB[i + 192] < 0) ? 1 : 0;
+			conv[i + 129] = (cB[i + 192] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 159);
+		tch_amr_unmerge_pack(tch_data, conv, 159, 67);
 
 		len = 20;
 
@@ -2746,18 +2736,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_7_4, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 120, 61);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 61, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 61, conv + 61);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 7.4 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 28; i++)
-			d[i + 120] = (cB[i + 200] < 0) ? 1 : 0;
+			conv[i + 126] = (cB[i + 200] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 148);
+		tch_amr_unmerge_pack(tch_data, conv, 148, 61);
 
 		len = 19;
 
@@ -2766,18 +2754,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_6_7, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 110, 55);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 55, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 55, conv + 55);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 6.7 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 24; i++)
-			d[i + 110] = (cB[i + 204] < 0) ? 1 : 0;
+			conv[i + 116] = (cB[i + 204] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 134);
+		tch_amr_unmerge_pack(tch_data, conv, 134, 55);
 
 		len = 17;
 
@@ -2786,18 +2772,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_5_9, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 102, 55);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 55, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 55, conv + 55);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 5.9 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 16; i++)
-			d[i + 102] = (cB[i + 212] < 0) ? 1 : 0;
+			conv[i + 108] = (cB[i + 212] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 118);
+		tch_amr_unmerge_pack(tch_data, conv, 118, 55);
 
 		len = 15;
 
@@ -2806,18 +2790,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_5_15, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 91, 49);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 49, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 49, conv + 49);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 5.15 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 12; i++)
-			d[i + 91] = (cB[i + 216] < 0) ? 1 : 0;
+			conv[i + 97] = (cB[i + 216] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 103);
+		tch_amr_unmerge_pack(tch_data, conv, 103, 49);
 
 		len = 13;
 
@@ -2826,18 +2808,16 @@ int gsm0503_tch_ahs_decode_dtx(uint8_t *tch_data, const sbit_t *bursts, int odd,
 		osmo_conv_decode_ber(&gsm0503_tch_ahs_4_75, cB + 4,
 			conv, n_errors, n_bits_total);
 
-		tch_amr_unmerge(d, p, conv, 83, 39);
-
-		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, d, 39, p);
+		rv = osmo_crc8gen_check_bits(&gsm0503_amr_crc6, conv, 39, conv + 39);
 		if (rv) {
 			/* Error checking CRC8 for an AMR 4.75 frame */
 			return -1;
 		}
 
 		for (i = 0; i < 12; i++)
-			d[i + 83] = (cB[i + 216] < 0) ? 1 : 0;
+			conv[i + 89] = (cB[i + 216] < 0) ? 1 : 0;
 
-		tch_amr_reassemble(tch_data, d, 95);
+		tch_amr_unmerge_pack(tch_data, conv, 95, 39);
 
 		len = 12;
 
@@ -2874,7 +2854,7 @@ int gsm0503_tch_ahs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 	uint8_t cmr)
 {
 	ubit_t iB[912], cB[456], h;
-	ubit_t d[244], p[6], conv[135];
+	ubit_t conv[165];
 	int i;
 	uint8_t id;
 
@@ -2916,90 +2896,66 @@ int gsm0503_tch_ahs_encode(ubit_t *bursts, const uint8_t *tch_data, int len,
 		if (len != 20)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 159);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 67, p);
-
-		tch_amr_merge(conv, d, p, 123, 67);
+		tch_amr_unpack_merge(conv, tch_data, 159, 67);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_7_95, conv, cB + 4);
 
-		memcpy(cB + 192, d + 123, 36);
+		memcpy(cB + 192, conv + 129, 36);
 
 		break;
 	case 4: /* TCH/AHS7.4 */
 		if (len != 19)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 148);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 61, p);
-
-		tch_amr_merge(conv, d, p, 120, 61);
+		tch_amr_unpack_merge(conv, tch_data, 148, 61);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_7_4, conv, cB + 4);
 
-		memcpy(cB + 200, d + 120, 28);
+		memcpy(cB + 200, conv + 126, 28);
 
 		break;
 	case 3: /* TCH/AHS6.7 */
 		if (len != 17)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 134);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 55, p);
-
-		tch_amr_merge(conv, d, p, 110, 55);
+		tch_amr_unpack_merge(conv, tch_data, 134, 55);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_6_7, conv, cB + 4);
 
-		memcpy(cB + 204, d + 110, 24);
+		memcpy(cB + 204, conv + 116, 24);
 
 		break;
 	case 2: /* TCH/AHS5.9 */
 		if (len != 15)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 118);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 55, p);
-
-		tch_amr_merge(conv, d, p, 102, 55);
+		tch_amr_unpack_merge(conv, tch_data, 118, 55);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_5_9, conv, cB + 4);
 
-		memcpy(cB + 212, d + 102, 16);
+		memcpy(cB + 212, conv + 108, 16);
 
 		break;
 	case 1: /* TCH/AHS5.15 */
 		if (len != 13)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 103);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 49, p);
-
-		tch_amr_merge(conv, d, p, 91, 49);
+		tch_amr_unpack_merge(conv, tch_data, 103, 49);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_5_15, conv, cB + 4);
 
-		memcpy(cB + 216, d + 91, 12);
+		memcpy(cB + 216, conv + 97, 12);
 
 		break;
 	case 0: /* TCH/AHS4.75 */
 		if (len != 12)
 			goto invalid_length;
 
-		tch_amr_disassemble(d, tch_data, 95);
-
-		osmo_crc8gen_set_bits(&gsm0503_amr_crc6, d, 39, p);
-
-		tch_amr_merge(conv, d, p, 83, 39);
+		tch_amr_unpack_merge(conv, tch_data, 95, 39);
 
 		osmo_conv_encode(&gsm0503_tch_ahs_4_75, conv, cB + 4);
 
-		memcpy(cB + 216, d + 83, 12);
+		memcpy(cB + 216, conv + 89, 12);
 
 		break;
 	default:
@@ -31,6 +31,8 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/utils.h>
 
+#include "usdt.h"
+
 /*! \addtogroup fsm
  *  @{
  *  Finite State Machine abstraction
@@ -279,7 +281,8 @@ struct osmo_fsm_inst *osmo_fsm_inst_find_by_id(const struct osmo_fsm *fsm,
 /*! register a FSM with the core
  *
  *  A FSM descriptor needs to be registered with the core before any
- *  instances can be created for it.
+ *  instances can be created for it.  Its event names get a lookup index, see
+ *  value_string_index().
  *
  *  \param[in] fsm Descriptor of Finite State Machine to be registered
  *  \returns 0 on success; negative on error
@@ -294,6 +297,8 @@ int osmo_fsm_register(struct osmo_fsm *fsm)
 		return -EEXIST;
 	if (fsm->event_names == NULL)
 		LOGP(DLGLOBAL, LOGL_ERROR, "FSM '%s' has no event names! Please fix!\n", fsm->name);
+	else
+		value_string_index(fsm->event_names);
 	llist_add_tail(&fsm->list, &osmo_g_fsms);
 	INIT_LLIST_HEAD(&fsm->instances);
 
@@ -684,6 +689,7 @@ static int state_chg(struct osmo_fsm_inst *fi, uint32_t new_state,
 			   osmo_fsm_state_name(fsm, new_state));
 	}
 
+	OSMO_TRACE4(fsm_state_chg, fi, fsm->name, old_state, new_state);
 	fi->state = new_state;
 	st = &fsm->states[new_state];
 
@@ -862,7 +868,9 @@ int _osmo_fsm_inst_dispatch(struct osmo_fsm_inst *fi, uint32_t event, void *data
 		   "Received Event %s\n", osmo_fsm_event_name(fsm, event));
 
 	if (((1 << event) & fsm->allstate_event_mask) && fsm->allstate_action) {
+		OSMO_TRACE4(fsm_dispatch_enter, fi, fsm->name, fi->state, event);
 		fsm->allstate_action(fi, event, data);
+		OSMO_TRACE2(fsm_dispatch_return, fi, event);
 		return 0;
 	}
 
@@ -873,8 +881,12 @@ int _osmo_fsm_inst_dispatch(struct osmo_fsm_inst *fi, uint32_t event, void *data
 		return -1;
 	}
 
-	if (fs->action)
+	if (fs->action) {
+		OSMO_TRACE4(fsm_dispatch_enter, fi, fsm->name, fi->state, event);
 		fs->action(fi, event, data);
+		/* fi may have been free'd by now, it is only passed as identifier */
+		OSMO_TRACE2(fsm_dispatch_return, fi, event);
+	}
 
 	return 0;
 }
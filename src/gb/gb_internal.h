@@ -13,10 +13,14 @@ int gprs_sns_bss_fsm_start(struct gprs_ns_inst *nsi);
 int gprs_sns_init(void);
 
 /* gprs_ns.c */
+void gprs_ns_rem_addr_cache_flush(struct gprs_ns_inst *nsi);
+void gprs_ns_rem_addr_cache_add(struct gprs_ns_inst *nsi, struct gprs_nsvc *nsvc);
+void gprs_ns_lsf_invalidate(struct gprs_ns_inst *nsi);
 void gprs_nsvc_start_test(struct gprs_nsvc *nsvc);
 void gprs_start_alive_all_nsvcs(struct gprs_ns_inst *nsi);
 int gprs_ns_tx_sns_ack(struct gprs_nsvc *nsvc, uint8_t trans_id, uint8_t *cause,
-		       const struct gprs_ns_ie_ip4_elem *ip4_elems,unsigned int num_ip4_elems);
+		       const struct gprs_ns_ie_ip4_elem *ip4_elems, unsigned int num_ip4_elems,
+		       const struct gprs_ns_ie_ip6_elem *ip6_elems, unsigned int num_ip6_elems);
 
 int gprs_ns_tx_sns_config(struct gprs_nsvc *nsvc, bool end_flag,
 			  const struct gprs_ns_ie_ip4_elem *ip4_elems,
@@ -35,12 +35,14 @@
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/rate_ctr.h>
 #include <osmocom/core/stats.h>
+#include <osmocom/core/timer.h>
 
 #include <osmocom/gprs/gprs_bssgp.h>
 #include <osmocom/gprs/gprs_bssgp_bss.h>
 #include <osmocom/gprs/gprs_ns.h>
 
 #include "common_vty.h"
+#include "../usdt.h"
 
 void *bssgp_tall_ctx = NULL;
 
@@ -1055,6 +1057,7 @@ int bssgp_rcvmsg(struct msgb *msg)
 	int rc = 0;
 
 	/* Identifiers from DOWN: NSEI, BVCI (both in msg->cb) */
+	OSMO_TRACE4(bssgp_rx, nsei, ns_bvci, pdu_type, msgb_bssgp_len(msg));
 
 	/* UNITDATA BSSGP headers have TLLI in front */
 	if (pdu_type != BSSGP_PDUT_UL_UNITDATA &&
@@ -1115,57 +1118,20 @@ int bssgp_rcvmsg(struct msgb *msg)
 	return rc;
 }
 
-int bssgp_tx_dl_ud(struct msgb *msg, uint16_t pdu_lifetime,
-		   struct bssgp_dl_ud_par *dup)
+/* Push the DL-UNITDATA header and all IEs preceding the LLC-PDU IE */
+static void dl_ud_push_hdr(struct msgb *msg, uint32_t tlli, uint16_t pdu_lifetime,
+			   const struct bssgp_dl_ud_par *dup)
 {
-	struct bssgp_bvc_ctx *bctx;
 	struct bssgp_ud_hdr *budh;
-	uint8_t llc_pdu_tlv_hdr_len = 2;
-	uint8_t *llc_pdu_tlv;
-	uint16_t msg_len = msg->len;
-	uint16_t bvci = msgb_bvci(msg);
-	uint16_t nsei = msgb_nsei(msg);
 	uint16_t _pdu_lifetime = osmo_htons(pdu_lifetime); /* centi-seconds */
 	uint16_t drx_params;
 
-	OSMO_ASSERT(dup != NULL);
-
-	/* Identifiers from UP: TLLI, BVCI, NSEI (all in msgb->cb) */
-	if (bvci <= BVCI_PTM ) {
-		LOGP(DBSSGP, LOGL_ERROR, "Cannot send DL-UD to BVCI %u\n",
-			bvci);
-		msgb_free(msg);
-		return -EINVAL;
-	}
-
-	bctx = btsctx_by_bvci_nsei(bvci, nsei);
-	if (!bctx) {
-		LOGP(DBSSGP, LOGL_ERROR, "Cannot send DL-UD to unknown BVCI %u\n",
-			bvci);
-		msgb_free(msg);
-		return -ENODEV;
-	}
-
-	if (msg->len > TVLV_MAX_ONEBYTE)
-		llc_pdu_tlv_hdr_len += 1;
-
-	/* prepend the tag and length of the LLC-PDU TLV */
-	llc_pdu_tlv = msgb_push(msg, llc_pdu_tlv_hdr_len);
-	llc_pdu_tlv[0] = BSSGP_IE_LLC_PDU;
-	if (llc_pdu_tlv_hdr_len > 2) {
-		llc_pdu_tlv[1] = msg_len >> 8;
-		llc_pdu_tlv[2] = msg_len & 0xff;
-	} else {
-		llc_pdu_tlv[1] = msg_len & 0x7f;
-		llc_pdu_tlv[1] |= 0x80;
-	}
-
 	/* FIXME: optional elements: Alignment, UTRAN CCO, LSA, PFI */
 
 	/* Old TLLI to help BSS map from old->new */
 	if (dup->tlli) {
-		uint32_t tlli = osmo_htonl(*dup->tlli);
-		msgb_tvlv_push(msg, BSSGP_IE_TLLI, 4, (uint8_t *) &tlli);
+		uint32_t old_tlli = osmo_htonl(*dup->tlli);
+		msgb_tvlv_push(msg, BSSGP_IE_TLLI, 4, (uint8_t *) &old_tlli);
 	}
 
 	/* IMSI */
@@ -1203,8 +1169,138 @@ int bssgp_tx_dl_ud(struct msgb *msg, uint16_t pdu_lifetime,
 	/* prepend the QoS profile, TLLI and pdu type */
 	budh = (struct bssgp_ud_hdr *) msgb_push(msg, sizeof(*budh));
 	memcpy(budh->qos_profile, dup->qos_profile, sizeof(budh->qos_profile));
-	budh->tlli = osmo_htonl(msgb_tlli(msg));
+	budh->tlli = osmo_htonl(tlli);
 	budh->pdu_type = BSSGP_PDUT_DL_UNITDATA;
+}
+
+/* Does the header template match the parameters of a DL-UNITDATA? */
+static bool dl_ud_tmpl_match(const struct bssgp_dl_ud_tmpl *tmpl, uint32_t tlli,
+			     uint16_t pdu_lifetime, const struct bssgp_dl_ud_par *dup)
+{
+	if (!tmpl->len || tmpl->tlli != tlli || tmpl->pdu_lifetime != pdu_lifetime ||
+	    tmpl->drx_parms != dup->drx_parms ||
+	    memcmp(tmpl->qos_profile, dup->qos_profile, sizeof(tmpl->qos_profile)))
+		return false;
+
+	if (tmpl->has_old_tlli != !!dup->tlli ||
+	    (dup->tlli && tmpl->old_tlli != *dup->tlli))
+		return false;
+
+	if (strcmp(tmpl->imsi, dup->imsi ? dup->imsi : ""))
+		return false;
+
+	/* the MS RA capability is only stored in the encoded header */
+	if (tmpl->ms_ra_cap_len != dup->ms_ra_cap.len ||
+	    (dup->ms_ra_cap.len &&
+	     memcmp(tmpl->hdr + tmpl->ms_ra_cap_ofs, dup->ms_ra_cap.v, dup->ms_ra_cap.len)))
+		return false;
+
+	return true;
+}
+
+/* Rebuild the header template, returns false if it cannot hold the header */
+static bool dl_ud_tmpl_build(struct bssgp_dl_ud_tmpl *tmpl, uint32_t tlli,
+			     uint16_t pdu_lifetime, const struct bssgp_dl_ud_par *dup)
+{
+	uint8_t buf[BSSGP_DL_UD_TMPL_MAX];
+	struct msgb msg = {
+		.head = buf,
+		.data = buf + sizeof(buf),
+		.tail = buf + sizeof(buf),
+		.data_len = sizeof(buf),
+	};
+
+	tmpl->len = 0;
+	/* header, PDU lifetime, DRX parameters, IMSI and old TLLI take up to 33
+	 * bytes, see dl_ud_push_hdr() */
+	if (dup->ms_ra_cap.len > sizeof(buf) - 33 - 3 ||
+	    (dup->imsi && strlen(dup->imsi) >= sizeof(tmpl->imsi)))
+		return false;
+
+	dl_ud_push_hdr(&msg, tlli, pdu_lifetime, dup);
+
+	memcpy(tmpl->hdr, msg.data, msg.len);
+	tmpl->len = msg.len;
+	tmpl->tlli = tlli;
+	tmpl->pdu_lifetime = pdu_lifetime;
+	tmpl->drx_parms = dup->drx_parms;
+	memcpy(tmpl->qos_profile, dup->qos_profile, sizeof(tmpl->qos_profile));
+	tmpl->has_old_tlli = !!dup->tlli;
+	tmpl->old_tlli = dup->tlli ? *dup->tlli : 0;
+	OSMO_STRLCPY_ARRAY(tmpl->imsi, dup->imsi ? dup->imsi : "");
+	tmpl->ms_ra_cap_len = dup->ms_ra_cap.len;
+	tmpl->ms_ra_cap_ofs = 0;
+	if (dup->ms_ra_cap.len) {
+		/* right behind the header and the PDU lifetime IE */
+		tmpl->ms_ra_cap_ofs = sizeof(struct bssgp_ud_hdr) + TVLV_GROSS_LEN(2) +
+				      TVLV_GROSS_LEN(dup->ms_ra_cap.len) - dup->ms_ra_cap.len;
+	}
+	return true;
+}
+
+/*! Invalidate a DL-UNITDATA header template
+ *  \param[in] tmpl template to invalidate
+ *
+ * A template is rebuilt automatically when any of the parameters passed to
+ * bssgp_tx_dl_ud() differs from the ones it was built from.  This is only
+ * needed to release the cached header, e.g. before reusing the memory of
+ * the template for another MS. */
+void bssgp_dl_ud_tmpl_invalidate(struct bssgp_dl_ud_tmpl *tmpl)
+{
+	tmpl->len = 0;
+}
+
+int bssgp_tx_dl_ud(struct msgb *msg, uint16_t pdu_lifetime,
+		   struct bssgp_dl_ud_par *dup)
+{
+	struct bssgp_bvc_ctx *bctx;
+	struct bssgp_dl_ud_tmpl *tmpl;
+	uint8_t llc_pdu_tlv_hdr_len = 2;
+	uint8_t *llc_pdu_tlv;
+	uint16_t msg_len = msg->len;
+	uint16_t bvci = msgb_bvci(msg);
+	uint16_t nsei = msgb_nsei(msg);
+	uint32_t tlli = msgb_tlli(msg);
+
+	OSMO_ASSERT(dup != NULL);
+
+	/* Identifiers from UP: TLLI, BVCI, NSEI (all in msgb->cb) */
+	if (bvci <= BVCI_PTM ) {
+		LOGP(DBSSGP, LOGL_ERROR, "Cannot send DL-UD to BVCI %u\n",
+			bvci);
+		msgb_free(msg);
+		return -EINVAL;
+	}
+
+	bctx = btsctx_by_bvci_nsei(bvci, nsei);
+	if (!bctx) {
+		LOGP(DBSSGP, LOGL_ERROR, "Cannot send DL-UD to unknown BVCI %u\n",
+			bvci);
+		msgb_free(msg);
+		return -ENODEV;
+	}
+
+	if (msg->len > TVLV_MAX_ONEBYTE)
+		llc_pdu_tlv_hdr_len += 1;
+
+	/* prepend the tag and length of the LLC-PDU TLV */
+	llc_pdu_tlv = msgb_push(msg, llc_pdu_tlv_hdr_len);
+	llc_pdu_tlv[0] = BSSGP_IE_LLC_PDU;
+	if (llc_pdu_tlv_hdr_len > 2) {
+		llc_pdu_tlv[1] = msg_len >> 8;
+		llc_pdu_tlv[2] = msg_len & 0xff;
+	} else {
+		llc_pdu_tlv[1] = msg_len & 0x7f;
+		llc_pdu_tlv[1] |= 0x80;
+	}
+
+	/* prepend everything else, from the per-MS template if possible */
+	tmpl = dup->tmpl;
+	if (tmpl && (dl_ud_tmpl_match(tmpl, tlli, pdu_lifetime, dup) ||
+		     dl_ud_tmpl_build(tmpl, tlli, pdu_lifetime, dup)))
+		memcpy(msgb_push(msg, tmpl->len), tmpl->hdr, tmpl->len);
+	else
+		dl_ud_push_hdr(msg, tlli, pdu_lifetime, dup);
 
 	rate_ctr_inc(&bctx->ctrg->ctr[BSSGP_CTR_PKTS_OUT]);
 	rate_ctr_add(&bctx->ctrg->ctr[BSSGP_CTR_BYTES_OUT], msg->len);
@@ -1219,23 +1315,24 @@ int bssgp_tx_dl_ud(struct msgb *msg, uint16_t pdu_lifetime,
 		return bssgp_fc_in(bctx->fc, msg, msg_len, NULL);
 }
 
-/* Send a single GMM-PAGING.req to a given NSEI/NS-BVCI */
-int bssgp_tx_paging(uint16_t nsei, uint16_t ns_bvci,
-		     struct bssgp_paging_info *pinfo)
+/* Encode a GMM-PAGING.req.  If ofs_bvci is given, it is set to the offset of
+ * the value of the BVCI IE in the message, or to -1 if there is none. */
+static struct msgb *bssgp_enc_paging(const struct bssgp_paging_info *pinfo, int *ofs_bvci)
 {
-	struct msgb *msg = bssgp_msgb_alloc();
-	struct bssgp_normal_hdr *bgph =
-			(struct bssgp_normal_hdr *) msgb_put(msg, sizeof(*bgph));
+	struct msgb *msg;
+	struct bssgp_normal_hdr *bgph;
 	uint16_t drx_params = osmo_htons(pinfo->drx_params);
 	uint8_t mi[GSM48_MID_MAX_SIZE];
 	int imsi_len = gsm48_generate_mid_from_imsi(mi, pinfo->imsi);
 	struct gsm48_ra_id ra;
 
 	if (imsi_len < 2)
-		return -EINVAL;
+		return NULL;
 
-	msgb_nsei(msg) = nsei;
-	msgb_bvci(msg) = ns_bvci;
+	msg = bssgp_msgb_alloc();
+	bgph = (struct bssgp_normal_hdr *) msgb_put(msg, sizeof(*bgph));
+	if (ofs_bvci)
+		*ofs_bvci = -1;
 
 	if (pinfo->mode == BSSGP_PAGING_PS)
 		bgph->pdu_type = BSSGP_PDUT_PAGING_PS;
@@ -1273,6 +1370,8 @@ int bssgp_tx_paging(uint16_t nsei, uint16_t ns_bvci,
 		{
 			uint16_t bvci = osmo_htons(pinfo->bvci);
 			msgb_tvlv_put(msg, BSSGP_IE_BVCI, 2, (uint8_t *)&bvci);
+			if (ofs_bvci)
+				*ofs_bvci = msg->len - 2;
 		}
 		break;
 	}
@@ -1286,9 +1385,277 @@ int bssgp_tx_paging(uint16_t nsei, uint16_t ns_bvci,
 		msgb_tvlv_put(msg, BSSGP_IE_TMSI, 4, (uint8_t *) &ptmsi);
 	}
 
+	return msg;
+}
+
+/* Send a single GMM-PAGING.req to a given NSEI/NS-BVCI */
+int bssgp_tx_paging(uint16_t nsei, uint16_t ns_bvci,
+		     struct bssgp_paging_info *pinfo)
+{
+	struct msgb *msg = bssgp_enc_paging(pinfo, NULL);
+
+	if (!msg)
+		return -EINVAL;
+
+	msgb_nsei(msg) = nsei;
+	msgb_bvci(msg) = ns_bvci;
+
 	return gprs_ns_sendmsg(bssgp_nsi, msg);
 }
 
+static const struct rate_ctr_desc bssgp_paging_ctr_description[] = {
+	[BSSGP_PAGING_CTR_REQUESTS]	= { "requests",		"Paging fan-out requests" },
+	[BSSGP_PAGING_CTR_PDUS]		= { "pdus",		"Paging PDUs sent" },
+	[BSSGP_PAGING_CTR_COALESCED]	= { "coalesced",	"Paging PDUs suppressed as duplicates" },
+	[BSSGP_PAGING_CTR_RATE_LIMITED]	= { "rate_limited",	"Paging PDUs dropped by the NSE rate limit" },
+	[BSSGP_PAGING_CTR_TX_ERRORS]	= { "tx_errors",	"Paging PDUs failed to send" },
+};
+
+static const struct rate_ctr_group_desc bssgp_paging_ctrg_desc = {
+	.group_name_prefix = "bssgp:paging",
+	.group_description = "BSSGP Paging Fan-out Statistics",
+	.num_ctr = ARRAY_SIZE(bssgp_paging_ctr_description),
+	.ctr_desc = bssgp_paging_ctr_description,
+	.class_id = OSMO_STATS_CLASS_GLOBAL,
+};
+
+#define PAGING_RECENT_HASH_SIZE		256
+/* longer pages are never coalesced */
+#define PAGING_RECENT_MAX_LEN		48
+
+/* a page sent within the coalescing window */
+struct paging_recent {
+	/* entry in bssgp_paging_fanout.recent, oldest first */
+	struct llist_head list;
+	/* next entry in the same bucket of bssgp_paging_fanout.recent_hash */
+	struct paging_recent *hash_next;
+	unsigned int hash;
+	struct timespec sent;
+	uint16_t nsei;
+	uint16_t ns_bvci;
+	uint8_t len;
+	uint8_t pdu[PAGING_RECENT_MAX_LEN];
+};
+
+/* token bucket for the paging PDUs of one NSE */
+struct paging_nse {
+	struct llist_head list;
+	uint16_t nsei;
+	/* in 1/1000 PDU */
+	uint64_t tokens;
+	struct timespec updated;
+};
+
+static uint64_t timespec_ms(const struct timespec *ts)
+{
+	return (uint64_t)ts->tv_sec * 1000 + ts->tv_nsec / 1000000;
+}
+
+/*! Allocate a paging fan-out engine
+ *  \param[in] ctx talloc context
+ *  \param[in] idx index of the rate counter group
+ *  \param[in] coalesce_ms pages identical to one sent to the same destination less
+ *		than coalesce_ms ago are suppressed, 0 to disable
+ *  \param[in] max_pdus_per_nse maximum number of paging PDUs per second and NSE,
+ *		0 for no limit
+ *  \returns newly allocated engine; NULL on error */
+struct bssgp_paging_fanout *bssgp_paging_fanout_alloc(void *ctx, unsigned int idx,
+						      unsigned int coalesce_ms,
+						      unsigned int max_pdus_per_nse)
+{
+	struct bssgp_paging_fanout *pf = talloc_zero(ctx, struct bssgp_paging_fanout);
+
+	if (!pf)
+		return NULL;
+	pf->coalesce_ms = coalesce_ms;
+	pf->max_pdus_per_nse = max_pdus_per_nse;
+	INIT_LLIST_HEAD(&pf->recent);
+	INIT_LLIST_HEAD(&pf->nses);
+	pf->recent_hash = talloc_zero_array(pf, struct paging_recent *, PAGING_RECENT_HASH_SIZE);
+	pf->ctrg = rate_ctr_group_alloc(pf, &bssgp_paging_ctrg_desc, idx);
+	if (!pf->recent_hash || !pf->ctrg) {
+		talloc_free(pf);
+		return NULL;
+	}
+	return pf;
+}
+
+/*! Free a paging fan-out engine */
+void bssgp_paging_fanout_free(struct bssgp_paging_fanout *pf)
+{
+	if (!pf)
+		return;
+	rate_ctr_group_free(pf->ctrg);
+	talloc_free(pf);
+}
+
+static void paging_recent_expire(struct bssgp_paging_fanout *pf, uint64_t now_ms)
+{
+	struct paging_recent *r, *r2, **pp;
+
+	llist_for_each_entry_safe(r, r2, &pf->recent, list) {
+		if (now_ms - timespec_ms(&r->sent) < pf->coalesce_ms)
+			break;
+		for (pp = &pf->recent_hash[r->hash]; *pp != r; pp = &(*pp)->hash_next)
+			;
+		*pp = r->hash_next;
+		llist_del(&r->list);
+		talloc_free(r);
+	}
+}
+
+static uint32_t paging_recent_hash(uint16_t nsei, uint16_t ns_bvci, const uint8_t *pdu, unsigned int len)
+{
+	uint32_t h = 0x811c9dc5 ^ nsei ^ ((uint32_t)ns_bvci << 16);
+	unsigned int i;
+
+	for (i = 0; i < len; i++)
+		h = (h ^ pdu[i]) * 0x01000193;
+	return (h ^ (h >> 16)) & (PAGING_RECENT_HASH_SIZE - 1);
+}
+
+/* returns true if the page was sent to the same destination recently */
+static bool paging_recent_check(struct bssgp_paging_fanout *pf, uint16_t nsei, uint16_t ns_bvci,
+				const uint8_t *pdu, unsigned int len)
+{
+	struct paging_recent *r;
+
+	if (!pf->coalesce_ms || len > PAGING_RECENT_MAX_LEN)
+		return false;
+
+	for (r = pf->recent_hash[paging_recent_hash(nsei, ns_bvci, pdu, len)]; r; r = r->hash_next) {
+		if (r->nsei == nsei && r->ns_bvci == ns_bvci && r->len == len &&
+		    !memcmp(r->pdu, pdu, len))
+			return true;
+	}
+	return false;
+}
+
+/* record a page which was sent, to coalesce repetitions of it */
+static void paging_recent_add(struct bssgp_paging_fanout *pf, const struct timespec *now,
+			      uint16_t nsei, uint16_t ns_bvci, const uint8_t *pdu, unsigned int len)
+{
+	struct paging_recent *r;
+
+	if (!pf->coalesce_ms || len > PAGING_RECENT_MAX_LEN)
+		return;
+
+	r = talloc(pf, struct paging_recent);
+	if (!r)
+		return;
+	r->hash = paging_recent_hash(nsei, ns_bvci, pdu, len);
+	r->sent = *now;
+	r->nsei = nsei;
+	r->ns_bvci = ns_bvci;
+	r->len = len;
+	memcpy(r->pdu, pdu, len);
+	r->hash_next = pf->recent_hash[r->hash];
+	pf->recent_hash[r->hash] = r;
+	llist_add_tail(&r->list, &pf->recent);
+}
+
+/* returns true if the NSE may take one more paging PDU now */
+static bool paging_nse_admit(struct bssgp_paging_fanout *pf, const struct timespec *now, uint16_t nsei)
+{
+	uint64_t burst = (uint64_t)pf->max_pdus_per_nse * 1000;
+	struct paging_nse *nse;
+
+	if (!pf->max_pdus_per_nse)
+		return true;
+
+	llist_for_each_entry(nse, &pf->nses, list) {
+		if (nse->nsei == nsei)
+			break;
+	}
+	if (&nse->list == &pf->nses) {
+		nse = talloc_zero(pf, struct paging_nse);
+		if (!nse)
+			return true;
+		nse->nsei = nsei;
+		nse->tokens = burst;
+		nse->updated = *now;
+		llist_add(&nse->list, &pf->nses);
+	}
+
+	/* refill max_pdus_per_nse tokens per second, up to one second's worth */
+	nse->tokens += (timespec_ms(now) - timespec_ms(&nse->updated)) * pf->max_pdus_per_nse;
+	if (nse->tokens > burst)
+		nse->tokens = burst;
+	nse->updated = *now;
+
+	if (nse->tokens < 1000)
+		return false;
+	nse->tokens -= 1000;
+	return true;
+}
+
+/*! Send a GMM-PAGING.req to a number of NSEI/NS-BVCI destinations
+ *  \param[in] pf paging fan-out engine
+ *  \param[in] dest array of destinations
+ *  \param[in] num_dest number of destinations
+ *  \param[in] pinfo paging information
+ *  \returns number of PDUs sent; negative in case of error
+ *
+ * The paging PDU is encoded only once and copied for each destination.  If
+ * the scope is BSSGP_PAGING_BVCI, the BVCI IE of the copies for PTP BVCs is
+ * set to the NS-BVCI of the destination, so that a list of cells can be
+ * paged with one call.  Pages identical to one sent to the same destination
+ * within the coalescing window and pages exceeding the rate limit of the
+ * NSE are not sent. */
+int bssgp_paging_fanout_tx(struct bssgp_paging_fanout *pf, const struct bssgp_paging_dest *dest,
+			   unsigned int num_dest, const struct bssgp_paging_info *pinfo)
+{
+	struct timespec now;
+	struct msgb *tmpl;
+	int ofs_bvci, sent = 0;
+	uint16_t tmpl_bvci = 0;
+	unsigned int i;
+
+	tmpl = bssgp_enc_paging(pinfo, &ofs_bvci);
+	if (!tmpl)
+		return -EINVAL;
+	if (ofs_bvci >= 0)
+		tmpl_bvci = osmo_load16be(tmpl->data + ofs_bvci);
+
+	rate_ctr_inc(&pf->ctrg->ctr[BSSGP_PAGING_CTR_REQUESTS]);
+	osmo_clock_gettime(CLOCK_MONOTONIC, &now);
+	if (pf->coalesce_ms)
+		paging_recent_expire(pf, timespec_ms(&now));
+
+	for (i = 0; i < num_dest; i++) {
+		struct msgb *msg;
+
+		/* PTP BVCs get their own BVCI, all others the one of pinfo */
+		if (ofs_bvci >= 0)
+			osmo_store16be(dest[i].ns_bvci > BVCI_PTM ? dest[i].ns_bvci : tmpl_bvci,
+				       tmpl->data + ofs_bvci);
+
+		if (paging_recent_check(pf, dest[i].nsei, dest[i].ns_bvci, tmpl->data, tmpl->len)) {
+			rate_ctr_inc(&pf->ctrg->ctr[BSSGP_PAGING_CTR_COALESCED]);
+			continue;
+		}
+		if (!paging_nse_admit(pf, &now, dest[i].nsei)) {
+			rate_ctr_inc(&pf->ctrg->ctr[BSSGP_PAGING_CTR_RATE_LIMITED]);
+			continue;
+		}
+
+		msg = bssgp_msgb_alloc();
+		memcpy(msgb_put(msg, tmpl->len), tmpl->data, tmpl->len);
+		msgb_nsei(msg) = dest[i].nsei;
+		msgb_bvci(msg) = dest[i].ns_bvci;
+		if (gprs_ns_sendmsg(bssgp_nsi, msg) < 0) {
+			rate_ctr_inc(&pf->ctrg->ctr[BSSGP_PAGING_CTR_TX_ERRORS]);
+			continue;
+		}
+		paging_recent_add(pf, &now, dest[i].nsei, dest[i].ns_bvci, tmpl->data, tmpl->len);
+		rate_ctr_inc(&pf->ctrg->ctr[BSSGP_PAGING_CTR_PDUS]);
+		sent++;
+	}
+
+	msgb_free(tmpl);
+	return sent;
+}
+
 void bssgp_set_log_ss(int ss)
 {
 	DBSSGP = ss;
@@ -250,3 +250,9 @@ int bssgp_tx_status(uint8_t cause, uint16_t *bvci, struct msgb *orig_msg)
 
 	return gprs_ns_sendmsg(bssgp_nsi, msg);
 }
+
+static __attribute__((constructor)) void on_dso_load_bssgp_util(void)
+{
+	value_string_index(bssgp_cause_strings);
+	value_string_index(bssgp_pdu_strings);
+}
@@ -88,6 +88,7 @@
 
 #include "common_vty.h"
 #include "gb_internal.h"
+#include "../usdt.h"
 
 #define ns_set_state(ns_, st_) ns_set_state_with_log(ns_, st_, false, __FILE__, __LINE__)
 #define ns_set_remote_state(ns_, st_) ns_set_state_with_log(ns_, st_, true, __FILE__, __LINE__)
@@ -119,8 +120,8 @@ static const struct tlv_definition ns_att_tlvdef = {
 		[NS_IE_IPv4_EP_NR] = { TLV_TYPE_FIXED, 2 },
 		[NS_IE_IPv6_EP_NR] = { TLV_TYPE_FIXED, 2 },
 		[NS_IE_RESET_FLAG] = { TLV_TYPE_TV, 0 },
-		/* TODO: IP_ADDR can be 5 or 17 bytes long, depending on first byte. This
-		 * cannot be expressed in our TLV parser.  However, we don't do IPv6 anyway */
+		/* IP_ADDR can be 5 or 17 bytes long, depending on first byte. This cannot
+		 * be expressed in our TLV parser, see the SNS-DELETE case of gprs_ns_process_msg() */
 		[NS_IE_IP_ADDR] = { TLV_TYPE_FIXED, 5 },
 	},
 };
@@ -225,10 +226,13 @@ static inline void ns_set_state_with_log(struct gprs_nsvc *nsvc, uint32_t state,
 		NS_DESC_A(old_state), NS_DESC_B(old_state), NS_DESC_R(old_state),
 		NS_DESC_A(state), NS_DESC_B(state), NS_DESC_R(state));
 
-	if (is_remote)
+	if (is_remote) {
 		nsvc->remote_state = state;
-	else
+	} else {
 		nsvc->state = state;
+		if (nsvc->nsi)
+			gprs_ns_lsf_invalidate(nsvc->nsi);
+	}
 }
 
 /*! Lookup struct gprs_nsvc based on NSVCI
@@ -261,27 +265,197 @@ struct gprs_nsvc *gprs_nsvc_by_nsei(struct gprs_ns_inst *nsi, uint16_t nsei)
 	return NULL;
 }
 
-/*! Determine active NS-VC for given NSEI + BVCI.
- *  Use this function to determine which of the NS-VCs inside the NS Instance
- *  shall be used to transmit data for given NSEI + BVCI */
-static struct gprs_nsvc *gprs_active_nsvc_by_nsei(struct gprs_ns_inst *nsi,
-						  uint16_t nsei, uint16_t bvci)
+/* Load sharing function (3GPP TS 48.016 Section 4.4.1).
+ *
+ * Each NSE has one table of NS_LSF_SLOTS slots for signalling (BVCI 0) and
+ * one for user data, which assign the slots to the usable NS-VCs of the NSE
+ * in proportion to their signalling or data weight.  A PDU is sent over the
+ * NS-VC owning the slot its Link Selector Parameter hashes to, so that all
+ * PDUs of one LSP take the same NS-VC and keep their order.
+ *
+ * The tables are rebuilt lazily whenever nsi->lsf_generation changed, i.e.
+ * after an NS-VC was blocked, unblocked, created or deleted or its weight or
+ * NSEI changed.  A rebuild only moves the slots that have to move: those of
+ * NS-VCs that are no longer usable and those an NS-VC owns above its share,
+ * so the NS-VC of all other LSPs stays the same. */
+#define NS_LSF_BITS	8
+#define NS_LSF_SLOTS	(1 << NS_LSF_BITS)
+
+struct ns_lsf {
+	struct llist_head list;
+	uint16_t nsei;
+	unsigned int generation;
+	/* [0]: signalling, [1]: user data */
+	struct gprs_nsvc *slot[2][NS_LSF_SLOTS];
+};
+
+struct ns_lsf_member {
+	struct gprs_nsvc *nsvc;
+	unsigned int weight;
+	unsigned int share;
+	unsigned int owned;
+};
+
+static inline bool nsvc_is_usable(const struct gprs_nsvc *nsvc)
+{
+	return !(nsvc->state & NSE_S_BLOCKED) && (nsvc->state & NSE_S_ALIVE);
+}
+
+/* mark all load sharing tables of the instance as out of date */
+void gprs_ns_lsf_invalidate(struct gprs_ns_inst *nsi)
 {
+	nsi->lsf_generation++;
+}
+
+static void lsf_rebuild_table(struct gprs_ns_inst *nsi, uint16_t nsei, struct gprs_nsvc **slot, bool data)
+{
+	struct ns_lsf_member m[NS_LSF_SLOTS];
+	unsigned int num = 0, weight_sum = 0, assigned = 0, i, j, s;
 	struct gprs_nsvc *nsvc;
+
 	llist_for_each_entry(nsvc, &nsi->gprs_nsvcs, list) {
-		/* if signalling BVCI, skip any NSVC with signalling weight == 0 */
-		if (bvci == 0 && nsvc->sig_weight == 0)
+		unsigned int weight = data ? nsvc->data_weight : nsvc->sig_weight;
+		if (nsvc->nsei != nsei || !weight || !nsvc_is_usable(nsvc))
 			continue;
-		/* if point-to-point BVCI, skip any NSVC with data weight == 0 */
-		if (bvci != 0 && nsvc->data_weight == 0)
+		if (num == ARRAY_SIZE(m))
+			break;
+		m[num].nsvc = nsvc;
+		m[num].weight = weight;
+		m[num].owned = 0;
+		weight_sum += weight;
+		num++;
+	}
+
+	if (!num) {
+		memset(slot, 0, sizeof(*slot) * NS_LSF_SLOTS);
+		return;
+	}
+
+	/* share of each NS-VC, the remainder goes to the first NS-VCs */
+	for (i = 0; i < num; i++) {
+		m[i].share = NS_LSF_SLOTS * m[i].weight / weight_sum;
+		assigned += m[i].share;
+	}
+	for (i = 0; assigned < NS_LSF_SLOTS; i = (i + 1) % num, assigned++)
+		m[i].share++;
+
+	/* keep slots whose owner is still usable and within its share */
+	for (s = 0; s < NS_LSF_SLOTS; s++) {
+		for (j = 0; j < num; j++) {
+			if (m[j].nsvc == slot[s])
+				break;
+		}
+		if (j < num && m[j].owned < m[j].share)
+			m[j].owned++;
+		else
+			slot[s] = NULL;
+	}
+
+	/* hand the free slots to the NS-VCs below their share */
+	for (s = 0, j = 0; s < NS_LSF_SLOTS; s++) {
+		if (slot[s])
 			continue;
-		if (nsvc->nsei == nsei) {
-			if (!(nsvc->state & NSE_S_BLOCKED) &&
-			    nsvc->state & NSE_S_ALIVE)
-				return nsvc;
+		while (m[j].owned >= m[j].share)
+			j++;
+		slot[s] = m[j].nsvc;
+		m[j].owned++;
+	}
+}
+
+static struct ns_lsf *lsf_by_nsei(struct gprs_ns_inst *nsi, uint16_t nsei)
+{
+	struct ns_lsf *lsf;
+
+	llist_for_each_entry(lsf, &nsi->lsf_list, list) {
+		if (lsf->nsei == nsei) {
+			/* most recently used first */
+			llist_move(&lsf->list, &nsi->lsf_list);
+			return lsf;
 		}
 	}
-	return NULL;
+
+	lsf = talloc_zero(nsi, struct ns_lsf);
+	if (!lsf)
+		return NULL;
+	lsf->nsei = nsei;
+	lsf->generation = nsi->lsf_generation - 1;
+	llist_add(&lsf->list, &nsi->lsf_list);
+	return lsf;
+}
+
+/*! Determine active NS-VC for given NSEI + BVCI + Link Selector Parameter.
+ *  Use this function to determine which of the NS-VCs inside the NS Instance
+ *  shall be used to transmit data for given NSEI + BVCI */
+static struct gprs_nsvc *gprs_active_nsvc_by_nsei(struct gprs_ns_inst *nsi,
+						  uint16_t nsei, uint16_t bvci, uint32_t lsp)
+{
+	struct ns_lsf *lsf = lsf_by_nsei(nsi, nsei);
+
+	if (!lsf)
+		return NULL;
+
+	if (lsf->generation != nsi->lsf_generation) {
+		if (!gprs_nsvc_by_nsei(nsi, nsei)) {
+			llist_del(&lsf->list);
+			talloc_free(lsf);
+			return NULL;
+		}
+		lsf_rebuild_table(nsi, nsei, lsf->slot[0], false);
+		lsf_rebuild_table(nsi, nsei, lsf->slot[1], true);
+		lsf->generation = nsi->lsf_generation;
+	}
+
+	return lsf->slot[bvci != 0][(lsp * 0x9e3779b1) >> (32 - NS_LSF_BITS)];
+}
+
+/* The NS-VC of each received message is looked up by its source address.
+ * The results are kept in a direct mapped cache indexed by a hash of the
+ * address, which is flushed whenever an NS-VC gets a new address.  A deleted
+ * NS-VC is removed from all slots.  A cached NS-VC is only used if its address
+ * still matches, so that direct modifications of bts_addr by the user are safe
+ * as well. */
+#define NS_REM_ADDR_CACHE_BITS	10
+
+static inline bool nsvc_has_rem_addr(const struct gprs_nsvc *nsvc, const struct sockaddr_in *sin)
+{
+	return nsvc->ip.bts_addr.sin_addr.s_addr == sin->sin_addr.s_addr &&
+	       nsvc->ip.bts_addr.sin_port == sin->sin_port;
+}
+
+static inline unsigned int rem_addr_hash(const struct sockaddr_in *sin)
+{
+	uint32_t h = sin->sin_addr.s_addr ^ ((uint32_t)sin->sin_port << 16);
+	return (h * 0x9e3779b1) >> (32 - NS_REM_ADDR_CACHE_BITS);
+}
+
+void gprs_ns_rem_addr_cache_flush(struct gprs_ns_inst *nsi)
+{
+	if (nsi->rem_addr_cache)
+		memset(nsi->rem_addr_cache, 0, sizeof(*nsi->rem_addr_cache) << NS_REM_ADDR_CACHE_BITS);
+}
+
+/* Enter nsvc into the cache without flushing it.  Only valid if no other NS-VC
+ * with the same address precedes nsvc in nsi->gprs_nsvcs, e.g. right after it
+ * was created. */
+void gprs_ns_rem_addr_cache_add(struct gprs_ns_inst *nsi, struct gprs_nsvc *nsvc)
+{
+	if (nsi->rem_addr_cache)
+		nsi->rem_addr_cache[rem_addr_hash(&nsvc->ip.bts_addr)] = nsvc;
+}
+
+/* Remove nsvc from the cache.  Scan all slots rather than only the one of its
+ * current address: bts_addr may have been modified directly by the user since
+ * nsvc was cached, and a stale entry must never outlive the NS-VC. */
+static void rem_addr_cache_del(struct gprs_ns_inst *nsi, struct gprs_nsvc *nsvc)
+{
+	unsigned int i;
+
+	if (!nsi->rem_addr_cache)
+		return;
+	for (i = 0; i < (1 << NS_REM_ADDR_CACHE_BITS); i++) {
+		if (nsi->rem_addr_cache[i] == nsvc)
+			nsi->rem_addr_cache[i] = NULL;
+	}
 }
 
 /*! Lookup NS-VC based on specified remote peer socket addr.
@@ -290,12 +464,20 @@ static struct gprs_nsvc *gprs_active_nsvc_by_nsei(struct gprs_ns_inst *nsi,
  *  \returns NS-VC matching the given peer; NULL in case of none */
 struct gprs_nsvc *gprs_nsvc_by_rem_addr(struct gprs_ns_inst *nsi, const struct sockaddr_in *sin)
 {
-	struct gprs_nsvc *nsvc;
+	struct gprs_nsvc *nsvc, **cached = NULL;
+
+	if (nsi->rem_addr_cache) {
+		cached = &nsi->rem_addr_cache[rem_addr_hash(sin)];
+		if (*cached && nsvc_has_rem_addr(*cached, sin))
+			return *cached;
+	}
+
 	llist_for_each_entry(nsvc, &nsi->gprs_nsvcs, list) {
-		if (nsvc->ip.bts_addr.sin_addr.s_addr ==
-					sin->sin_addr.s_addr &&
-		    nsvc->ip.bts_addr.sin_port == sin->sin_port)
+		if (nsvc_has_rem_addr(nsvc, sin)) {
+			if (cached)
+				*cached = nsvc;
 			return nsvc;
+		}
 	}
 	return NULL;
 }
@@ -342,7 +524,9 @@ struct gprs_nsvc *gprs_nsvc_create2(struct gprs_ns_inst *nsi, uint16_t nsvci,
 	nsvc->sig_weight = sig_weight;
 	nsvc->data_weight = data_weight;
 
+	/* not entered into the remote address cache yet, as bts_addr is not known */
 	llist_add(&nsvc->list, &nsi->gprs_nsvcs);
+	gprs_ns_lsf_invalidate(nsi);
 
 	return nsvc;
 }
@@ -355,6 +539,8 @@ void gprs_nsvc_delete(struct gprs_nsvc *nsvc)
 	if (osmo_timer_pending(&nsvc->timer))
 		osmo_timer_del(&nsvc->timer);
 	llist_del(&nsvc->list);
+	rem_addr_cache_del(nsvc->nsi, nsvc);
+	gprs_ns_lsf_invalidate(nsvc->nsi);
 	rate_ctr_group_free(nsvc->ctrg);
 	osmo_stat_item_group_free(nsvc->statg);
 	talloc_free(nsvc);
@@ -488,6 +674,7 @@ static int gprs_ns_tx(struct gprs_nsvc *nsvc, struct msgb *msg)
 	/* Increment number of Uplink bytes */
 	rate_ctr_inc(&nsvc->ctrg->ctr[NS_CTR_PKTS_OUT]);
 	rate_ctr_add(&nsvc->ctrg->ctr[NS_CTR_BYTES_OUT], msgb_l2len(msg));
+	OSMO_TRACE3(ns_tx, nsvc->nsei, nsh->pdu_type, msgb_l2len(msg));
 
 	switch (nsvc->ll) {
 	case GPRS_NS_LL_UDP:
@@ -871,10 +1058,14 @@ static int gprs_ns_tx_reset_ack(struct gprs_nsvc *nsvc)
  *  \param[in] cause Pointer to cause value (NULL if no cause to be sent)
  *  \param[in] ip4_elems Array of IPv4 Elements
  *  \param[in] num_ip4_elems number of ip4_elems
+ *  \param[in] ip6_elems Array of IPv6 Elements
+ *  \param[in] num_ip6_elems number of ip6_elems
  *  \returns 0 on success; negative in case of error */
 int gprs_ns_tx_sns_ack(struct gprs_nsvc *nsvc, uint8_t trans_id, uint8_t *cause,
 			const struct gprs_ns_ie_ip4_elem *ip4_elems,
-			unsigned int num_ip4_elems)
+			unsigned int num_ip4_elems,
+			const struct gprs_ns_ie_ip6_elem *ip6_elems,
+			unsigned int num_ip6_elems)
 {
 	struct msgb *msg = gprs_ns_msgb_alloc();
 	struct gprs_ns_hdr *nsh;
@@ -907,7 +1098,12 @@ int gprs_ns_tx_sns_ack(struct gprs_nsvc *nsvc, uint8_t trans_id, uint8_t *cause,
 			      num_ip4_elems*sizeof(struct gprs_ns_ie_ip4_elem),
 			      (const uint8_t *)ip4_elems);
 	}
-	/* FIXME: List of IP6 elements 10.3.2d */
+	if (ip6_elems) {
+		/* List of IP6 Elements 10.3.2d */
+		msgb_tvlv_put(msg, NS_IE_IPv6_LIST,
+			      num_ip6_elems*sizeof(struct gprs_ns_ie_ip6_elem),
+			      (const uint8_t *)ip6_elems);
+	}
 	return gprs_ns_tx(nsvc, msg);
 }
 
@@ -1072,9 +1268,10 @@ int gprs_ns_tx_sns_size_ack(struct gprs_nsvc *nsvc, uint8_t *cause)
  *  \param[in] nsi NS-instance on which we shall transmit
  *  \param[in] msg struct msgb to be trasnmitted
  *
- * This function obtains the NS-VC by the msgb_nsei(msg) and then checks
- * if the NS-VC is ALIVE and not BLOCKED.  After that, it adds a NS
- * header for the NS-UNITDATA message type and sends it off.
+ * This function selects one of the ALIVE and not BLOCKED NS-VCs of the
+ * NSE msgb_nsei(msg) by the load sharing function, using msgb_tlli(msg)
+ * as Link Selector Parameter.  After that, it adds a NS header for the
+ * NS-UNITDATA message type and sends it off.
  *
  * Section 9.2.10: transmit side / NS-UNITDATA-REQUEST primitive 
  */
@@ -1084,7 +1281,10 @@ int gprs_ns_sendmsg(struct gprs_ns_inst *nsi, struct msgb *msg)
 	struct gprs_ns_hdr *nsh;
 	uint16_t bvci = msgb_bvci(msg);
 
-	nsvc = gprs_active_nsvc_by_nsei(nsi, msgb_nsei(msg), msgb_bvci(msg));
+	/* every BSSGP PDU is sent by means of this NS-UNITDATA-REQUEST */
+	OSMO_TRACE4(bssgp_tx, msgb_nsei(msg), bvci, msgb_length(msg) ? msg->data[0] : 0xff, msgb_length(msg));
+
+	nsvc = gprs_active_nsvc_by_nsei(nsi, msgb_nsei(msg), bvci, msgb_tlli(msg));
 	if (!nsvc) {
 		int rc;
 		if (gprs_nsvc_by_nsei(nsi, msgb_nsei(msg))) {
@@ -1589,6 +1789,7 @@ void gprs_ns_ll_clear(struct gprs_nsvc *nsvc)
 	default:
 		break;
 	}
+	gprs_ns_rem_addr_cache_flush(nsvc->nsi);
 }
 
 /*! Create/get NS-VC independently from underlying transport layer
@@ -1736,6 +1937,7 @@ int gprs_ns_process_msg(struct gprs_ns_inst *nsi, struct msgb *msg,
 	/* Increment number of Incoming bytes */
 	rate_ctr_inc(&(*nsvc)->ctrg->ctr[NS_CTR_PKTS_IN]);
 	rate_ctr_add(&(*nsvc)->ctrg->ctr[NS_CTR_BYTES_IN], msgb_l2len(msg));
+	OSMO_TRACE3(ns_rx, (*nsvc)->nsei, nsh->pdu_type, msgb_l2len(msg));
 
 	if (nsvc_is_not_used(*nsvc) && !ns_is_sns(nsh->pdu_type) && nsh->pdu_type != NS_PDUT_STATUS) {
 		LOGP(DNS, LOGL_NOTICE, "NSEI=%u Rx %s on unused/pre-configured endpoint, discarding\n",
@@ -1834,12 +2036,21 @@ int gprs_ns_process_msg(struct gprs_ns_inst *nsi, struct msgb *msg,
 	case SNS_PDUT_DELETE:
 		if (!nsi->bss_sns_fi)
 			goto unexpected_sns;
-		/* weird layout: NSEI TLV, then value-only transaction IE, then TLV again */
-		rc = tlv_parse(&tp, &ns_att_tlvdef, nsh->data+5,
-				msgb_l2len(msg) - sizeof(*nsh)-5, 0, 0);
-		if (rc < 0) {
-			LOGPC(DNS, LOGL_NOTICE, "Error during TLV Parse in %s\n", msgb_hexdump(msg));
-			return rc;
+		if (nsh->pdu_type == SNS_PDUT_DELETE && msgb_l2len(msg) > sizeof(*nsh)+6 &&
+		    nsh->data[5] == NS_IE_IP_ADDR) {
+			/* the IP Address IE has no length, it is 5 (IPv4) or 17 (IPv6)
+			 * octets long depending on its first octet */
+			memset(&tp, 0, sizeof(tp));
+			tp.lv[NS_IE_IP_ADDR].val = nsh->data+6;
+			tp.lv[NS_IE_IP_ADDR].len = msgb_l2len(msg) - sizeof(*nsh)-6;
+		} else {
+			/* weird layout: NSEI TLV, then value-only transaction IE, then TLV again */
+			rc = tlv_parse(&tp, &ns_att_tlvdef, nsh->data+5,
+					msgb_l2len(msg) - sizeof(*nsh)-5, 0, 0);
+			if (rc < 0) {
+				LOGPC(DNS, LOGL_NOTICE, "Error during TLV Parse in %s\n", msgb_hexdump(msg));
+				return rc;
+			}
 		}
 		tp.lv[NS_IE_NSEI].val = nsh->data+2;
 		tp.lv[NS_IE_NSEI].len = 2;
@@ -1897,6 +2108,8 @@ struct gprs_ns_inst *gprs_ns_instantiate(gprs_ns_cb_t *cb, void *ctx)
 		return NULL;
 	nsi->cb = cb;
 	INIT_LLIST_HEAD(&nsi->gprs_nsvcs);
+	INIT_LLIST_HEAD(&nsi->lsf_list);
+	nsi->rem_addr_cache = talloc_zero_array(nsi, struct gprs_nsvc *, 1 << NS_REM_ADDR_CACHE_BITS);
 	nsi->timeout[NS_TOUT_TNS_BLOCK] = 3;
 	nsi->timeout[NS_TOUT_TNS_BLOCK_RETRIES] = 3;
 	nsi->timeout[NS_TOUT_TNS_RESET] = 3;
@@ -1921,6 +2134,19 @@ struct gprs_ns_inst *gprs_ns_instantiate(gprs_ns_cb_t *cb, void *ctx)
 	return nsi;
 }
 
+static void nsip_close_extra_fds(struct gprs_ns_inst *nsi)
+{
+	unsigned int i;
+
+	for (i = 0; i < nsi->nsip_num_extra_fds; i++) {
+		close(nsi->nsip_extra_fds[i].fd);
+		osmo_fd_unregister(&nsi->nsip_extra_fds[i]);
+	}
+	talloc_free(nsi->nsip_extra_fds);
+	nsi->nsip_extra_fds = NULL;
+	nsi->nsip_num_extra_fds = 0;
+}
+
 void gprs_ns_close(struct gprs_ns_inst *nsi)
 {
 	struct gprs_nsvc *nsvc, *nsvc2;
@@ -1937,6 +2163,7 @@ void gprs_ns_close(struct gprs_ns_inst *nsi)
 		osmo_fd_unregister(&nsi->nsip.fd);
 		nsi->nsip.fd.data = NULL;
 	}
+	nsip_close_extra_fds(nsi);
 }
 
 /*! Destroy an entire NS instance
@@ -2039,6 +2266,18 @@ static int nsip_fd_cb(struct osmo_fd *bfd, unsigned int what)
 	return rc;
 }
 
+static int nsip_set_dscp(struct gprs_ns_inst *nsi, int fd)
+{
+	int ret;
+
+	ret = setsockopt(fd, IPPROTO_IP, IP_TOS, &nsi->nsip.dscp, sizeof(nsi->nsip.dscp));
+	if (ret < 0)
+		LOGP(DNS, LOGL_ERROR,
+			"Failed to set the DSCP to %d with ret(%d) errno(%d)\n",
+			nsi->nsip.dscp, ret, errno);
+	return ret;
+}
+
 /*! Create a listening socket for GPRS NS/UDP/IP
  *  \param[in] nsi NS protocol instance to listen
  *  \returns >=0 (fd) in case of success, negative in case of error
@@ -2087,18 +2326,75 @@ int gprs_ns_nsip_listen(struct gprs_ns_inst *nsi)
 		return ret;
 	}
 
-	ret = setsockopt(nsi->nsip.fd.fd, IPPROTO_IP, IP_TOS,
-				&nsi->nsip.dscp, sizeof(nsi->nsip.dscp));
-	if (ret < 0)
-		LOGP(DNS, LOGL_ERROR,
-			"Failed to set the DSCP to %d with ret(%d) errno(%d)\n",
-			nsi->nsip.dscp, ret, errno);
+	ret = nsip_set_dscp(nsi, nsi->nsip.fd.fd);
 
 	LOGP(DNS, LOGL_NOTICE, "NS UDP socket at %s:%d\n", inet_ntoa(in), nsi->nsip.local_port);
 
 	return ret;
 }
 
+/*! Create several listening sockets for GPRS NS/UDP/IP on the same local IP/port
+ *  \param[in] nsi NS protocol instance to listen
+ *  \param[in] num_socks total number of sockets to create
+ *  \returns >=0 (fd of the first socket) in case of success, negative in case of error
+ *
+ *  Like gprs_ns_nsip_listen(), but all sockets are bound with SO_REUSEPORT, so
+ *  that the kernel distributes the received datagrams across the sockets (and
+ *  their receive buffers) by a hash of the remote address and port.  Each peer
+ *  thus always ends up on the same socket.  The first socket is stored in
+ *  nsi->nsip.fd and also used for transmission, the others in
+ *  nsi->nsip_extra_fds.  All of them are registered with the select loop of the
+ *  calling thread, which must be the thread owning the NS instance, as the NS
+ *  and BSSGP state is not thread-safe.  A remote IP/port must not be configured.
+ */
+int gprs_ns_nsip_listen_reuseport(struct gprs_ns_inst *nsi, unsigned int num_socks)
+{
+	struct in_addr in;
+	unsigned int i;
+	int ret;
+
+	if (num_socks <= 1)
+		return gprs_ns_nsip_listen(nsi);
+	if (nsi->nsip.remote_ip && nsi->nsip.remote_port)
+		return -EINVAL;
+
+	nsi->nsip_extra_fds = talloc_zero_array(nsi, struct osmo_fd, num_socks - 1);
+	if (!nsi->nsip_extra_fds)
+		return -ENOMEM;
+
+	in.s_addr = osmo_htonl(nsi->nsip.local_ip);
+	for (i = 0; i < num_socks; i++) {
+		struct osmo_fd *ofd = i ? &nsi->nsip_extra_fds[i - 1] : &nsi->nsip.fd;
+
+		ofd->cb = nsip_fd_cb;
+		ofd->data = nsi;
+		ret = osmo_sock_init_ofd(ofd, AF_INET, SOCK_DGRAM, IPPROTO_UDP, inet_ntoa(in),
+					 nsi->nsip.local_port, OSMO_SOCK_F_BIND | OSMO_SOCK_F_REUSEPORT);
+		if (ret < 0) {
+			ofd->cb = NULL;
+			ofd->data = NULL;
+			goto err;
+		}
+		if (i)
+			nsi->nsip_num_extra_fds++;
+		nsip_set_dscp(nsi, ofd->fd);
+	}
+
+	LOGP(DNS, LOGL_NOTICE, "Listening for nsip packets on %s:%u with %u sockets\n",
+	     inet_ntoa(in), nsi->nsip.local_port, num_socks);
+
+	return nsi->nsip.fd.fd;
+err:
+	if (nsi->nsip.fd.data) {
+		close(nsi->nsip.fd.fd);
+		osmo_fd_unregister(&nsi->nsip.fd);
+		nsi->nsip.fd.cb = NULL;
+		nsi->nsip.fd.data = NULL;
+	}
+	nsip_close_extra_fds(nsi);
+	return ret;
+}
+
 /*! Initiate a RESET procedure
  *  \param[in] nsvc NS-VC in which to start the procedure
  *  \param[in] cause Numeric NS cause value
@@ -2151,6 +2447,7 @@ struct gprs_nsvc *gprs_ns_nsip_connect(struct gprs_ns_inst *nsi,
 	if (!nsvc)
 		nsvc = gprs_nsvc_create2(nsi, nsvci, 1, 1);
 	nsvc->ip.bts_addr = *dest;
+	gprs_ns_rem_addr_cache_flush(nsi);
 	nsvc->nsei = nsei;
 	nsvc->remote_end_is_sgsn = 1;
 
@@ -2193,6 +2490,7 @@ struct gprs_nsvc *gprs_ns_nsip_connect_sns(struct gprs_ns_inst *nsi,
 		nsvc = gprs_nsvc_create2(nsi, nsvci, 0, 0);
 	}
 	nsvc->ip.bts_addr = *dest;
+	gprs_ns_rem_addr_cache_flush(nsi);
 	nsvc->nsei = nsei;
 	nsvc->remote_end_is_sgsn = 1;
 	/* NSVCs are always UNBLOCKED in IP-SNS */
@@ -2252,4 +2550,10 @@ void gprs_start_alive_all_nsvcs(struct gprs_ns_inst *nsi)
 	}
 }
 
+static __attribute__((constructor)) void on_dso_load_gprs_ns(void)
+{
+	value_string_index(gprs_ns_pdu_strings);
+	value_string_index(ns_cause_str);
+}
+
 /*! @} */
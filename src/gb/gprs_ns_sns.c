@@ -24,6 +24,23 @@
 
 #define S(x)	(1 << (x))
 
+/* Number of buckets of the remote endpoint hash table, must be a power of 2 */
+#define SNS_EP_HASH_SIZE	64
+
+/* A remote IPv4 or IPv6 endpoint, as configured by the SGSN */
+struct sns_endpoint {
+	/* entry in gprs_sns_state.ep_list, in order of configuration */
+	struct llist_head list;
+	/* next endpoint in the same bucket of gprs_sns_state.ep_hash */
+	struct sns_endpoint *hash_next;
+	bool is_ip6;
+	/* network byte order, IPv4 addresses use the first four octets */
+	uint8_t ip_addr[16];
+	uint16_t udp_port;
+	uint8_t sig_weight;
+	uint8_t data_weight;
+};
+
 struct gprs_sns_state {
 	struct gprs_ns_inst *nsi;
 	struct gprs_nsvc *nsvc_hack;
@@ -36,10 +53,17 @@ struct gprs_sns_state {
 	 * remote (SGSN) side */
 	size_t num_max_nsvcs;
 	size_t num_max_ip4_remote;
-
-	/* remote configuration as received */
-	struct gprs_ns_ie_ip4_elem *ip4_remote;
-	unsigned int num_ip4_remote;
+	size_t num_max_ip6_remote;
+
+	/* remote configuration as received.  Only IPv4 endpoints get NS-VCs, as
+	 * struct gprs_nsvc and the NS/UDP socket are IPv4 only; IPv6 endpoints
+	 * are kept track of for the SNS procedures. */
+	struct llist_head ep_list;
+	struct sns_endpoint *ep_hash[SNS_EP_HASH_SIZE];
+	/* [0]: IPv4, [1]: IPv6 */
+	unsigned int num_ep[2];
+	unsigned int sig_weight_sum[2];
+	unsigned int data_weight_sum[2];
 
 	/* IP-SNS based Gb doesn't have a NSVCI.  However, our existing Gb stack
 	 * requires a unique NSVCI per NS-VC.  Let's simply allocate them dynamically from
@@ -53,36 +77,117 @@ static inline struct gprs_ns_inst *ns_inst_from_fi(struct osmo_fsm_inst *fi)
 	return gss->nsi;
 }
 
-/* helper function to compute the sum of all (data or signaling) weights */
-static int ip4_weight_sum(const struct gprs_ns_ie_ip4_elem *ip4, unsigned int num,
-			  bool data_weight)
+static void ep_from_ip4(struct sns_endpoint *ep, const struct gprs_ns_ie_ip4_elem *ip4)
+{
+	memset(ep, 0, sizeof(*ep));
+	memcpy(ep->ip_addr, &ip4->ip_addr, sizeof(ip4->ip_addr));
+	ep->udp_port = ip4->udp_port;
+	ep->sig_weight = ip4->sig_weight;
+	ep->data_weight = ip4->data_weight;
+}
+
+static void ep_from_ip6(struct sns_endpoint *ep, const struct gprs_ns_ie_ip6_elem *ip6)
 {
+	memset(ep, 0, sizeof(*ep));
+	ep->is_ip6 = true;
+	memcpy(ep->ip_addr, ip6->ip_addr, sizeof(ip6->ip_addr));
+	ep->udp_port = ip6->udp_port;
+	ep->sig_weight = ip6->sig_weight;
+	ep->data_weight = ip6->data_weight;
+}
+
+static unsigned int ep_hash(const struct sns_endpoint *ep)
+{
+	uint32_t h = ep->udp_port;
 	unsigned int i;
-	int weight_sum = 0;
 
-	for (i = 0; i < num; i++) {
-		if (data_weight)
-			weight_sum += ip4[i].data_weight;
-		else
-			weight_sum += ip4[i].sig_weight;
+	for (i = 0; i < (ep->is_ip6 ? 16 : 4); i++)
+		h = (h ^ ep->ip_addr[i]) * 0x01000193;
+	return (h ^ (h >> 16)) & (SNS_EP_HASH_SIZE - 1);
+}
+
+static bool ep_same_addr(const struct sns_endpoint *a, const struct sns_endpoint *b)
+{
+	return a->is_ip6 == b->is_ip6 && a->udp_port == b->udp_port &&
+	       !memcmp(a->ip_addr, b->ip_addr, a->is_ip6 ? 16 : 4);
+}
+
+/* find the remote endpoint with the IP address and port of key */
+static struct sns_endpoint *ep_find(struct gprs_sns_state *gss, const struct sns_endpoint *key)
+{
+	struct sns_endpoint *ep;
+
+	for (ep = gss->ep_hash[ep_hash(key)]; ep; ep = ep->hash_next) {
+		if (ep_same_addr(ep, key))
+			return ep;
 	}
-	return weight_sum;
+	return NULL;
 }
-#define ip4_weight_sum_data(x,y)	ip4_weight_sum(x, y, true)
-#define ip4_weight_sum_sig(x,y)		ip4_weight_sum(x, y, false)
 
-static struct gprs_nsvc *nsvc_by_ip4_elem(struct gprs_ns_inst *nsi,
-					  const struct gprs_ns_ie_ip4_elem *ip4)
+static void ep_set_weights(struct gprs_sns_state *gss, struct sns_endpoint *ep,
+			   uint8_t sig_weight, uint8_t data_weight)
+{
+	gss->sig_weight_sum[ep->is_ip6] += sig_weight - ep->sig_weight;
+	gss->data_weight_sum[ep->is_ip6] += data_weight - ep->data_weight;
+	ep->sig_weight = sig_weight;
+	ep->data_weight = data_weight;
+}
+
+/* Add a copy of a remote endpoint to gprs_sns_state, or update the weights of an existing one */
+static struct sns_endpoint *ep_add(struct gprs_sns_state *gss, const struct sns_endpoint *key)
+{
+	struct sns_endpoint *ep = ep_find(gss, key);
+	unsigned int h;
+
+	if (ep) {
+		ep_set_weights(gss, ep, key->sig_weight, key->data_weight);
+		return ep;
+	}
+
+	ep = talloc(gss, struct sns_endpoint);
+	if (!ep)
+		return NULL;
+	*ep = *key;
+	ep->sig_weight = ep->data_weight = 0;
+	ep_set_weights(gss, ep, key->sig_weight, key->data_weight);
+
+	h = ep_hash(ep);
+	ep->hash_next = gss->ep_hash[h];
+	gss->ep_hash[h] = ep;
+	llist_add_tail(&ep->list, &gss->ep_list);
+	gss->num_ep[ep->is_ip6]++;
+	return ep;
+}
+
+/* Remove a remote endpoint from gprs_sns_state */
+static void ep_del(struct gprs_sns_state *gss, struct sns_endpoint *ep)
+{
+	struct sns_endpoint **pp;
+
+	for (pp = &gss->ep_hash[ep_hash(ep)]; *pp != ep; pp = &(*pp)->hash_next)
+		;
+	*pp = ep->hash_next;
+	llist_del(&ep->list);
+
+	ep_set_weights(gss, ep, 0, 0);
+	gss->num_ep[ep->is_ip6]--;
+	talloc_free(ep);
+}
+
+static struct gprs_nsvc *nsvc_by_ep(struct gprs_ns_inst *nsi, const struct sns_endpoint *ep)
 {
 	struct sockaddr_in sin;
+
+	if (ep->is_ip6)
+		return NULL;
+
 	/* copy over. Both data structures use network byte order */
-	sin.sin_addr.s_addr = ip4->ip_addr;
-	sin.sin_port = ip4->udp_port;
+	memcpy(&sin.sin_addr.s_addr, ep->ip_addr, sizeof(sin.sin_addr.s_addr));
+	sin.sin_port = ep->udp_port;
 	return gprs_nsvc_by_rem_addr(nsi, &sin);
 }
 
-static struct gprs_nsvc *gprs_nsvc_create_ip4(struct gprs_ns_inst *nsi,
-					      const struct gprs_ns_ie_ip4_elem *ip4)
+static struct gprs_nsvc *gprs_nsvc_create_ep(struct gprs_ns_inst *nsi, const struct sns_endpoint *ep)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) nsi->bss_sns_fi->priv;
 	struct gprs_nsvc *nsvc;
@@ -90,10 +195,10 @@ static struct gprs_nsvc *gprs_nsvc_create_ip4(struct gprs_ns_inst *nsi,
 	/* copy over. Both data structures use network byte order */
 	memset(&sin, 0, sizeof(sin));
 	sin.sin_family = AF_INET;
-	sin.sin_addr.s_addr = ip4->ip_addr;
-	sin.sin_port = ip4->udp_port;
+	memcpy(&sin.sin_addr.s_addr, ep->ip_addr, sizeof(sin.sin_addr.s_addr));
+	sin.sin_port = ep->udp_port;
 
-	nsvc = gprs_nsvc_create2(nsi, gss->next_nsvci--, ip4->sig_weight, ip4->data_weight);
+	nsvc = gprs_nsvc_create2(nsi, gss->next_nsvci--, ep->sig_weight, ep->data_weight);
 	if (!nsvc)
 		return NULL;
 
@@ -101,6 +206,9 @@ static struct gprs_nsvc *gprs_nsvc_create_ip4(struct gprs_ns_inst *nsi,
 	nsvc->nsei = gss->nsvc_hack->nsei;
 	nsvc->nsvci_is_valid = 0;
 	nsvc->ip.bts_addr = sin;
+	/* the new NS-VC is first in nsi->gprs_nsvcs, no need to flush the cache */
+	gprs_ns_rem_addr_cache_add(nsi, nsvc);
+	gprs_ns_lsf_invalidate(nsi);
 
 	return nsvc;
 }
@@ -109,22 +217,25 @@ static int create_missing_nsvcs(struct osmo_fsm_inst *fi)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct gprs_ns_inst *nsi = ns_inst_from_fi(fi);
-	unsigned int i;
+	struct sns_endpoint *ep;
 
-	for (i = 0; i < gss->num_ip4_remote; i++) {
-		const struct gprs_ns_ie_ip4_elem *ip4 = &gss->ip4_remote[i];
-		struct gprs_nsvc *nsvc = nsvc_by_ip4_elem(nsi, ip4);
+	llist_for_each_entry(ep, &gss->ep_list, list) {
+		struct gprs_nsvc *nsvc;
+		if (ep->is_ip6)
+			continue;
+		nsvc = nsvc_by_ep(nsi, ep);
 		if (!nsvc) {
 			/* create, if it doesn't exist */
-			nsvc = gprs_nsvc_create_ip4(nsi, ip4);
+			nsvc = gprs_nsvc_create_ep(nsi, ep);
 			if (!nsvc) {
 				LOGPFSML(fi, LOGL_ERROR, "SNS-CONFIG: Failed to create NSVC\n");
 				continue;
 			}
 		} else {
 			/* update data / signalling weight */
-			nsvc->data_weight = ip4->data_weight;
-			nsvc->sig_weight = ip4->sig_weight;
+			nsvc->data_weight = ep->data_weight;
+			nsvc->sig_weight = ep->sig_weight;
+			gprs_ns_lsf_invalidate(nsi);
 		}
 		LOGPFSML(fi, LOGL_INFO, "NS-VC %s data_weight=%u, sig_weight=%u\n",
 			 gprs_ns_ll_str(nsvc), nsvc->data_weight, nsvc->sig_weight);
@@ -133,90 +244,67 @@ static int create_missing_nsvcs(struct osmo_fsm_inst *fi)
 	return 0;
 }
 
-/* Add a given remote IPv4 element to gprs_sns_state */
-static int add_remote_ip4_elem(struct gprs_sns_state *gss, const struct gprs_ns_ie_ip4_elem *ip4)
-{
-	if (gss->num_ip4_remote >= gss->num_max_ip4_remote)
-		return -E2BIG;
-
-	gss->ip4_remote = talloc_realloc(gss, gss->ip4_remote, struct gprs_ns_ie_ip4_elem,
-					 gss->num_ip4_remote+1);
-	gss->ip4_remote[gss->num_ip4_remote] = *ip4;
-	gss->num_ip4_remote += 1;
-	return 0;
-}
-
-/* Remove a given remote IPv4 element from gprs_sns_state */
-static int remove_remote_ip4_elem(struct gprs_sns_state *gss, const struct gprs_ns_ie_ip4_elem *ip4)
-{
-	unsigned int i;
-
-	for (i = 0; i < gss->num_ip4_remote; i++) {
-		if (memcmp(&gss->ip4_remote[i], ip4, sizeof(*ip4)))
-			continue;
-		/* all array elements < i remain as they are; all > i are shifted left by one */
-		memmove(&gss->ip4_remote[i], &gss->ip4_remote[i+1], gss->num_ip4_remote-i-1);
-		gss->num_ip4_remote -= 1;
-		return 0;
-	}
-	return -1;
-}
-
-/* update the weights for specified remote IPv4 */
-static int update_remote_ip4_elem(struct gprs_sns_state *gss, const struct gprs_ns_ie_ip4_elem *ip4)
+static const char *ep_str(const struct sns_endpoint *ep)
 {
-	unsigned int i;
+	static char buf[INET6_ADDRSTRLEN + 8];
+	char addr[INET6_ADDRSTRLEN];
 
-	for (i = 0; i < gss->num_ip4_remote; i++) {
-		if (gss->ip4_remote[i].ip_addr != ip4->ip_addr ||
-		    gss->ip4_remote[i].udp_port != ip4->udp_port)
-			continue;
-		gss->ip4_remote[i].sig_weight = ip4->sig_weight;
-		gss->ip4_remote[i].data_weight = ip4->data_weight;
-		return 0;
-	}
-	return -1;
+	inet_ntop(ep->is_ip6 ? AF_INET6 : AF_INET, ep->ip_addr, addr, sizeof(addr));
+	snprintf(buf, sizeof(buf), ep->is_ip6 ? "[%s]:%u" : "%s:%u", addr, ntohs(ep->udp_port));
+	return buf;
 }
 
-
-static int do_sns_change_weight(struct osmo_fsm_inst *fi, const struct gprs_ns_ie_ip4_elem *ip4)
+static int do_sns_change_weight(struct osmo_fsm_inst *fi, const struct sns_endpoint *key)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct gprs_ns_inst *nsi = ns_inst_from_fi(fi);
-	struct gprs_nsvc *nsvc = nsvc_by_ip4_elem(nsi, ip4);
+	struct sns_endpoint *ep = ep_find(gss, key);
+	struct gprs_nsvc *nsvc;
 
-	/* TODO: Upon receiving an SNS-CHANGEWEIGHT PDU, if the resulting sum of the
-	 * signalling weights of all the peer IP endpoints configured for this NSE is
-	 * equal to zero or if the resulting sum of the data weights of all the peer IP
-	 * endpoints configured for this NSE is equal to zero, the BSS/SGSN shall send an
-	 * SNS-ACK PDU with a cause code of "Invalid weights". */
+	if (!ep)
+		return -NS_CAUSE_UNKN_IP_EP;
+	ep_set_weights(gss, ep, key->sig_weight, key->data_weight);
 
-	update_remote_ip4_elem(gss, ip4);
+	if (ep->is_ip6) {
+		LOGPFSML(fi, LOGL_INFO, "CHANGE-WEIGHT IPv6 endpoint %s\n", ep_str(ep));
+		return 0;
+	}
 
+	nsvc = nsvc_by_ep(nsi, ep);
 	if (!nsvc) {
 		LOGPFSML(fi, LOGL_NOTICE, "Couldn't find NS-VC for SNS-CHANGE_WEIGHT\n");
 		return -NS_CAUSE_NSVC_UNKNOWN;
 	}
 
 	LOGPFSML(fi, LOGL_INFO, "CHANGE-WEIGHT NS-VC %s data_weight %u->%u, sig_weight %u->%u\n",
-		 gprs_ns_ll_str(nsvc), nsvc->data_weight, ip4->data_weight,
-		 nsvc->sig_weight, ip4->sig_weight);
+		 gprs_ns_ll_str(nsvc), nsvc->data_weight, ep->data_weight,
+		 nsvc->sig_weight, ep->sig_weight);
 
-	nsvc->data_weight = ip4->data_weight;
-	nsvc->sig_weight = ip4->sig_weight;
+	nsvc->data_weight = ep->data_weight;
+	nsvc->sig_weight = ep->sig_weight;
+	gprs_ns_lsf_invalidate(nsi);
 
 	return 0;
 }
 
-static int do_sns_delete(struct osmo_fsm_inst *fi, const struct gprs_ns_ie_ip4_elem *ip4)
+static int do_sns_delete(struct osmo_fsm_inst *fi, const struct sns_endpoint *key)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct gprs_ns_inst *nsi = ns_inst_from_fi(fi);
-	struct gprs_nsvc *nsvc = nsvc_by_ip4_elem(nsi, ip4);
+	struct sns_endpoint *ep = ep_find(gss, key);
+	struct gprs_nsvc *nsvc;
 
-	if (remove_remote_ip4_elem(gss, ip4) < 0)
+	if (!ep)
 		return -NS_CAUSE_UNKN_IP_EP;
 
+	if (ep->is_ip6) {
+		LOGPFSML(fi, LOGL_INFO, "DELETE IPv6 endpoint %s\n", ep_str(ep));
+		ep_del(gss, ep);
+		return 0;
+	}
+
+	nsvc = nsvc_by_ep(nsi, ep);
+	ep_del(gss, ep);
 	if (!nsvc) {
 		LOGPFSML(fi, LOGL_NOTICE, "Couldn't find NS-VC for SNS-DELETE\n");
 		return -NS_CAUSE_NSVC_UNKNOWN;
@@ -227,29 +315,38 @@ static int do_sns_delete(struct osmo_fsm_inst *fi, const struct gprs_ns_ie_ip4_e
 	return 0;
 }
 
-static int do_sns_add(struct osmo_fsm_inst *fi, const struct gprs_ns_ie_ip4_elem *ip4)
+static int do_sns_add(struct osmo_fsm_inst *fi, const struct sns_endpoint *key)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct gprs_ns_inst *nsi = ns_inst_from_fi(fi);
+	size_t num_max = key->is_ip6 ? gss->num_max_ip6_remote : gss->num_max_ip4_remote;
+	struct sns_endpoint *ep;
 	struct gprs_nsvc *nsvc;
 
-	/* Upon receiving an SNS-ADD PDU, if the consequent number of IPv4 endpoints
-	 * exceeds the number of IPv4 endpoints supported by the NSE, the NSE shall send
-	 * an SNS-ACK PDU with a cause code set to "Invalid number of IP4 Endpoints". */
-	if (add_remote_ip4_elem(gss, ip4) < 0)
-		return -NS_CAUSE_INVAL_NR_NS_VC;
-
 	/* Upon receiving an SNS-ADD PDU containing an already configured IP endpoint the
 	 * NSE shall send an SNS-ACK PDU with the cause code "Protocol error -
 	 * unspecified" */
-	nsvc = nsvc_by_ip4_elem(nsi, ip4);
-	if (nsvc)
+	if (ep_find(gss, key))
 		return -NS_CAUSE_PROTO_ERR_UNSPEC;
 
-	nsvc = gprs_nsvc_create_ip4(nsi, ip4);
+	/* Upon receiving an SNS-ADD PDU, if the consequent number of IPv4 endpoints
+	 * exceeds the number of IPv4 endpoints supported by the NSE, the NSE shall send
+	 * an SNS-ACK PDU with a cause code set to "Invalid number of IP4 Endpoints". */
+	if (gss->num_ep[key->is_ip6] >= num_max)
+		return key->is_ip6 ? -NS_CAUSE_INVAL_NR_IPv6_EP : -NS_CAUSE_INVAL_NR_IPv4_EP;
+
+	ep = ep_add(gss, key);
+	if (!ep)
+		return -NS_CAUSE_EQUIP_FAIL;
+	if (ep->is_ip6) {
+		LOGPFSML(fi, LOGL_INFO, "ADD IPv6 endpoint %s\n", ep_str(ep));
+		return 0;
+	}
+
+	nsvc = gprs_nsvc_create_ep(nsi, ep);
 	if (!nsvc) {
 		LOGPFSML(fi, LOGL_ERROR, "SNS-ADD: Failed to create NSVC\n");
-		remove_remote_ip4_elem(gss, ip4);
+		ep_del(gss, ep);
 		return -NS_CAUSE_EQUIP_FAIL;
 	}
 	LOGPFSML(fi, LOGL_INFO, "ADD NS-VC %s data_weight=%u, sig_weight=%u\n",
@@ -259,6 +356,52 @@ static int do_sns_add(struct osmo_fsm_inst *fi, const struct gprs_ns_ie_ip4_elem
 	return 0;
 }
 
+/* IPv4 and IPv6 elements of an SNS PDU, as endpoints */
+struct sns_ep_list {
+	const struct gprs_ns_ie_ip4_elem *v4;
+	unsigned int num_v4;
+	const struct gprs_ns_ie_ip6_elem *v6;
+	unsigned int num_v6;
+};
+
+/* returns false if the PDU contains neither of both lists */
+static bool sns_ep_list_parse(struct sns_ep_list *l, const struct tlv_parsed *tp)
+{
+	memset(l, 0, sizeof(*l));
+	if (TLVP_PRESENT(tp, NS_IE_IPv4_LIST)) {
+		l->v4 = (const struct gprs_ns_ie_ip4_elem *) TLVP_VAL(tp, NS_IE_IPv4_LIST);
+		l->num_v4 = TLVP_LEN(tp, NS_IE_IPv4_LIST) / sizeof(*l->v4);
+	}
+	if (TLVP_PRESENT(tp, NS_IE_IPv6_LIST)) {
+		l->v6 = (const struct gprs_ns_ie_ip6_elem *) TLVP_VAL(tp, NS_IE_IPv6_LIST);
+		l->num_v6 = TLVP_LEN(tp, NS_IE_IPv6_LIST) / sizeof(*l->v6);
+	}
+	return l->v4 || l->v6;
+}
+
+static unsigned int sns_ep_list_len(const struct sns_ep_list *l)
+{
+	return l->num_v4 + l->num_v6;
+}
+
+/* the i-th element of the list, the IPv4 elements come first */
+static void sns_ep_list_get(struct sns_endpoint *ep, const struct sns_ep_list *l, unsigned int i)
+{
+	if (i < l->num_v4)
+		ep_from_ip4(ep, &l->v4[i]);
+	else
+		ep_from_ip6(ep, &l->v6[i - l->num_v4]);
+}
+
+static void sns_tx_ack(struct gprs_sns_state *gss, uint8_t trans_id, uint8_t *cause,
+		       const struct sns_ep_list *l)
+{
+	if (l)
+		gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, cause, l->v4, l->num_v4, l->v6, l->num_v6);
+	else
+		gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, cause, NULL, 0, NULL, 0);
+}
+
 
 
 /***********************************************************************
@@ -373,8 +516,9 @@ static void gprs_sns_st_config_sgsn(struct osmo_fsm_inst *fi, uint32_t event, vo
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct tlv_parsed *tp = NULL;
 	struct gprs_ns_inst *nsi = ns_inst_from_fi(fi);
-	const struct gprs_ns_ie_ip4_elem *v4_list;
-	unsigned int num_v4;
+	struct sns_ep_list l;
+	struct sns_endpoint ep;
+	unsigned int i;
 	uint8_t cause;
 
 	switch (event) {
@@ -384,33 +528,36 @@ static void gprs_sns_st_config_sgsn(struct osmo_fsm_inst *fi, uint32_t event, vo
 #if 0		/* part of incoming SNS-SIZE (doesn't happen on BSS side */
 		if (TLVP_PRESENT(tp, NS_IE_RESET_FLAG)) {
 			/* reset all existing config */
-			if (gss->ip4_remote)
-				talloc_free(gss->ip4_remote);
-			gss->num_ip4_remote = 0;
+			struct sns_endpoint *ep, *ep2;
+			llist_for_each_entry_safe(ep, ep2, &gss->ep_list, list)
+				ep_del(gss, ep);
 		}
 #endif
-		if (!TLVP_PRESENT(tp, NS_IE_IPv4_LIST)) {
+		if (!sns_ep_list_parse(&l, tp)) {
 			cause = NS_CAUSE_INVAL_NR_IPv4_EP;
 			gprs_ns_tx_sns_config_ack(gss->nsvc_hack, &cause);
 			osmo_fsm_inst_state_chg(fi, GPRS_SNS_ST_UNCONFIGURED, 0, 0);
 			break;
 		}
-		v4_list = (const struct gprs_ns_ie_ip4_elem *) TLVP_VAL(tp, NS_IE_IPv4_LIST);
-		num_v4 = TLVP_LEN(tp, NS_IE_IPv4_LIST) / sizeof(*v4_list);
-		/* realloc to the new size */
-		gss->ip4_remote = talloc_realloc(gss, gss->ip4_remote,
-						 struct gprs_ns_ie_ip4_elem,
-						 gss->num_ip4_remote+num_v4);
-		/* append the new entries to the end of the list */
-		memcpy(&gss->ip4_remote[gss->num_ip4_remote], v4_list, num_v4*sizeof(*v4_list));
-		gss->num_ip4_remote += num_v4;
-
-		LOGPFSML(fi, LOGL_INFO, "Rx SNS-CONFIG: Remote IPv4 list now %u entries\n",
-			 gss->num_ip4_remote);
+		/* add the new entries to the tables */
+		for (i = 0; i < sns_ep_list_len(&l); i++) {
+			sns_ep_list_get(&ep, &l, i);
+			if (!ep_add(gss, &ep))
+				break;
+		}
+		if (i < sns_ep_list_len(&l)) {
+			cause = NS_CAUSE_EQUIP_FAIL;
+			gprs_ns_tx_sns_config_ack(gss->nsvc_hack, &cause);
+			osmo_fsm_inst_state_chg(fi, GPRS_SNS_ST_UNCONFIGURED, 0, 0);
+			break;
+		}
+
+		LOGPFSML(fi, LOGL_INFO, "Rx SNS-CONFIG: Remote IPv4 list now %u entries, IPv6 list %u entries\n",
+			 gss->num_ep[0], gss->num_ep[1]);
 		if (event == GPRS_SNS_EV_CONFIG_END) {
 			/* check if sum of data / sig weights == 0 */
-			if (ip4_weight_sum_data(gss->ip4_remote, gss->num_ip4_remote) == 0 ||
-			    ip4_weight_sum_sig(gss->ip4_remote, gss->num_ip4_remote) == 0) {
+			if (gss->data_weight_sum[0] + gss->data_weight_sum[1] == 0 ||
+			    gss->sig_weight_sum[0] + gss->sig_weight_sum[1] == 0) {
 				cause = NS_CAUSE_INVAL_WEIGH;
 				gprs_ns_tx_sns_config_ack(gss->nsvc_hack, &cause);
 				osmo_fsm_inst_state_chg(fi, GPRS_SNS_ST_UNCONFIGURED, 0, 0);
@@ -431,51 +578,74 @@ static void gprs_sns_st_config_sgsn(struct osmo_fsm_inst *fi, uint32_t event, vo
 	}
 }
 
+/* Upon receiving an SNS-CHANGEWEIGHT PDU, if the resulting sum of the signalling
+ * weights of all the peer IP endpoints configured for this NSE is equal to zero or
+ * if the resulting sum of the data weights of all the peer IP endpoints configured
+ * for this NSE is equal to zero, the BSS/SGSN shall send an SNS-ACK PDU with a
+ * cause code of "Invalid weights". */
+static bool sns_change_weight_valid(struct gprs_sns_state *gss, const struct sns_ep_list *l)
+{
+	unsigned int sig_weight_sum = gss->sig_weight_sum[0] + gss->sig_weight_sum[1];
+	unsigned int data_weight_sum = gss->data_weight_sum[0] + gss->data_weight_sum[1];
+	struct sns_endpoint key, *ep;
+	unsigned int i;
+
+	for (i = 0; i < sns_ep_list_len(l); i++) {
+		sns_ep_list_get(&key, l, i);
+		ep = ep_find(gss, &key);
+		if (!ep)
+			continue;
+		sig_weight_sum += key.sig_weight - ep->sig_weight;
+		data_weight_sum += key.data_weight - ep->data_weight;
+	}
+
+	return sig_weight_sum && data_weight_sum;
+}
+
 static void gprs_sns_st_configured(struct osmo_fsm_inst *fi, uint32_t event, void *data)
 {
 	struct gprs_sns_state *gss = (struct gprs_sns_state *) fi->priv;
 	struct tlv_parsed *tp = NULL;
-	const struct gprs_ns_ie_ip4_elem *v4_list = NULL;
-	unsigned int num_v4 = 0;
+	struct sns_endpoint key, *ep, *ep2;
+	struct sns_ep_list l;
 	uint8_t trans_id;
 	uint8_t cause = 0xff;
-	unsigned int i;
+	unsigned int i, j;
 	int rc;
 
 	switch (event) {
 	case GPRS_SNS_EV_ADD:
 		tp = data;
 		trans_id = *TLVP_VAL(tp, NS_IE_TRANS_ID);
-		if (TLVP_PRESENT(tp, NS_IE_IPv4_LIST)) {
-			v4_list = (const struct gprs_ns_ie_ip4_elem *) TLVP_VAL(tp, NS_IE_IPv4_LIST);
-			num_v4 = TLVP_LEN(tp, NS_IE_IPv4_LIST) / sizeof(*v4_list);
-			for (i = 0; i < num_v4; i++) {
-				rc = do_sns_add(fi, &v4_list[i]);
-				if (rc < 0) {
-					unsigned int j;
-					/* rollback/undo to restore previous state */
-					for (j = 0; j < i; j++)
-						do_sns_delete(fi, &v4_list[j]);
-					cause = -rc;
-					gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
-					break;
-				}
-			}
-		} else {
+		if (!sns_ep_list_parse(&l, tp)) {
 			cause = NS_CAUSE_INVAL_NR_IPv4_EP;
-			gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
+			sns_tx_ack(gss, trans_id, &cause, NULL);
 			break;
 		}
-		gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, NULL, v4_list, num_v4);
+		for (i = 0; i < sns_ep_list_len(&l); i++) {
+			sns_ep_list_get(&key, &l, i);
+			rc = do_sns_add(fi, &key);
+			if (rc < 0) {
+				/* rollback/undo to restore previous state */
+				for (j = 0; j < i; j++) {
+					sns_ep_list_get(&key, &l, j);
+					do_sns_delete(fi, &key);
+				}
+				cause = -rc;
+				sns_tx_ack(gss, trans_id, &cause, NULL);
+				break;
+			}
+		}
+		if (cause == 0xff)
+			sns_tx_ack(gss, trans_id, NULL, &l);
 		break;
 	case GPRS_SNS_EV_DELETE:
 		tp = data;
 		trans_id = *TLVP_VAL(tp, NS_IE_TRANS_ID);
-		if (TLVP_PRESENT(tp, NS_IE_IPv4_LIST)) {
-			v4_list = (const struct gprs_ns_ie_ip4_elem *) TLVP_VAL(tp, NS_IE_IPv4_LIST);
-			num_v4 = TLVP_LEN(tp, NS_IE_IPv4_LIST) / sizeof(*v4_list);
-			for (i = 0; i < num_v4; i++) {
-				rc = do_sns_delete(fi, &v4_list[i]);
+		if (sns_ep_list_parse(&l, tp)) {
+			for (i = 0; i < sns_ep_list_len(&l); i++) {
+				sns_ep_list_get(&key, &l, i);
+				rc = do_sns_delete(fi, &key);
 				if (rc < 0) {
 					cause = -rc;
 					/* continue to delete others */
@@ -483,67 +653,66 @@ static void gprs_sns_st_configured(struct osmo_fsm_inst *fi, uint32_t event, voi
 			}
 			if (cause != 0xff) {
 				/* TODO: create list of not-deleted and return it */
-				gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
+				sns_tx_ack(gss, trans_id, &cause, NULL);
 				break;
 			}
+			sns_tx_ack(gss, trans_id, NULL, &l);
 		} else if (TLVP_PRES_LEN(tp, NS_IE_IP_ADDR, 5)) {
 			/* delete all NS-VCs for given IP address */
 			const uint8_t *ie = TLVP_VAL(tp, NS_IE_IP_ADDR);
-			struct gprs_ns_ie_ip4_elem *ip4_remote;
-			uint32_t ip_addr = *(uint32_t *)(ie+1);
-			if (ie[0] != 0x01) { /* Address Type != IPv4 */
+			bool is_ip6 = ie[0] == 0x02;
+			if (ie[0] != 0x01 && !(is_ip6 && TLVP_LEN(tp, NS_IE_IP_ADDR) >= 17)) {
+				/* Address Type neither IPv4 nor IPv6 */
 				cause = NS_CAUSE_UNKN_IP_ADDR;
-				gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
+				sns_tx_ack(gss, trans_id, &cause, NULL);
 				break;
 			}
-			/* make a copy as do_sns_delete() will change the array underneath us */
-			ip4_remote = talloc_memdup(fi, gss->ip4_remote,
-						   gss->num_ip4_remote*sizeof(*v4_list));
-			for (i = 0; i < gss->num_ip4_remote; i++) {
-				if (ip4_remote[i].ip_addr == ip_addr) {
-					rc = do_sns_delete(fi, &ip4_remote[i]);
-					if (rc < 0) {
-						cause = -rc;
-						/* continue to delete others */
-					}
+			llist_for_each_entry_safe(ep, ep2, &gss->ep_list, list) {
+				if (ep->is_ip6 != is_ip6 || memcmp(ep->ip_addr, ie+1, is_ip6 ? 16 : 4))
+					continue;
+				rc = do_sns_delete(fi, ep);
+				if (rc < 0) {
+					cause = -rc;
+					/* continue to delete others */
 				}
 			}
-			talloc_free(ip4_remote);
 			if (cause != 0xff) {
 				/* TODO: create list of not-deleted and return it */
-				gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
+				sns_tx_ack(gss, trans_id, &cause, NULL);
 				break;
 			}
+			sns_tx_ack(gss, trans_id, NULL, NULL);
 		} else {
 			cause = NS_CAUSE_INVAL_NR_IPv4_EP;
-			gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
-			break;
+			sns_tx_ack(gss, trans_id, &cause, NULL);
 		}
-		gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, NULL, v4_list, num_v4);
 		break;
 	case GPRS_SNS_EV_CHANGE_WEIGHT:
 		tp = data;
 		trans_id = *TLVP_VAL(tp, NS_IE_TRANS_ID);
-		if (TLVP_PRESENT(tp, NS_IE_IPv4_LIST)) {
-			v4_list = (const struct gprs_ns_ie_ip4_elem *) TLVP_VAL(tp, NS_IE_IPv4_LIST);
-			num_v4 = TLVP_LEN(tp, NS_IE_IPv4_LIST) / sizeof(*v4_list);
-			for (i = 0; i < num_v4; i++) {
-				rc = do_sns_change_weight(fi, &v4_list[i]);
-				if (rc < 0) {
-					cause = -rc;
-					/* continue to others */
-				}
-			}
-			if (cause != 0xff) {
-				gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
-				break;
-			}
-		} else {
+		if (!sns_ep_list_parse(&l, tp)) {
 			cause = NS_CAUSE_INVAL_NR_IPv4_EP;
-			gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, &cause, NULL, 0);
+			sns_tx_ack(gss, trans_id, &cause, NULL);
+			break;
+		}
+		if (!sns_change_weight_valid(gss, &l)) {
+			cause = NS_CAUSE_INVAL_WEIGH;
+			sns_tx_ack(gss, trans_id, &cause, NULL);
+			break;
+		}
+		for (i = 0; i < sns_ep_list_len(&l); i++) {
+			sns_ep_list_get(&key, &l, i);
+			rc = do_sns_change_weight(fi, &key);
+			if (rc < 0) {
+				cause = -rc;
+				/* continue to others */
+			}
+		}
+		if (cause != 0xff) {
+			sns_tx_ack(gss, trans_id, &cause, NULL);
 			break;
 		}
-		gprs_ns_tx_sns_ack(gss->nsvc_hack, trans_id, NULL, v4_list, num_v4);
+		sns_tx_ack(gss, trans_id, NULL, &l);
 		break;
 	}
 }
@@ -648,6 +817,7 @@ struct osmo_fsm_inst *gprs_sns_bss_fsm_alloc(void *ctx, struct gprs_nsvc *nsvc,
 	/* FIXME: we shouldn't use 'nsvc' here but only gprs_ns_inst */
 	gss->nsvc_hack = nsvc;
 	gss->next_nsvci = 65533; /* 65534 + 65535 are already used internally */
+	INIT_LLIST_HEAD(&gss->ep_list);
 
 	/* create IPv4 list from the one IP/port the NS instance has */
 	ip4 = talloc_zero(gss, struct gprs_ns_ie_ip4_elem);
@@ -670,6 +840,8 @@ struct osmo_fsm_inst *gprs_sns_bss_fsm_alloc(void *ctx, struct gprs_nsvc *nsvc,
 	gss->num_ip4_local = 1;
 	gss->num_max_nsvcs = 8;
 	gss->num_max_ip4_remote = 4;
+	/* NS-VCs are IPv4 only, see struct gprs_sns_state */
+	gss->num_max_ip6_remote = 0;
 
 	return fi;
 err:
@@ -750,9 +922,16 @@ static void vty_dump_sns_ip4(struct vty *vty, const struct gprs_ns_ie_ip4_elem *
 		inet_ntoa(in), ntohs(ip4->udp_port), ip4->sig_weight, ip4->data_weight, VTY_NEWLINE);
 }
 
+static void vty_dump_sns_ep(struct vty *vty, const struct sns_endpoint *ep)
+{
+	vty_out(vty, " %s, Signalling Weight: %u, Data Weight: %u%s",
+		ep_str(ep), ep->sig_weight, ep->data_weight, VTY_NEWLINE);
+}
+
 void gprs_sns_dump_vty(struct vty *vty, const struct gprs_ns_inst *nsi, bool stats)
 {
 	struct gprs_sns_state *gss;
+	struct sns_endpoint *ep;
 	unsigned int i;
 
 	if (!nsi->bss_sns_fi)
@@ -761,14 +940,24 @@ void gprs_sns_dump_vty(struct vty *vty, const struct gprs_ns_inst *nsi, bool sta
 	vty_out_fsm_inst(vty, nsi->bss_sns_fi);
 	gss = (struct gprs_sns_state *) nsi->bss_sns_fi->priv;
 
-	vty_out(vty, "Maximum number of remote  NS-VCs: %zu, IPv4 Endpoints: %zu%s",
-		gss->num_max_nsvcs, gss->num_max_ip4_remote, VTY_NEWLINE);
+	vty_out(vty, "Maximum number of remote  NS-VCs: %zu, IPv4 Endpoints: %zu, IPv6 Endpoints: %zu%s",
+		gss->num_max_nsvcs, gss->num_max_ip4_remote, gss->num_max_ip6_remote, VTY_NEWLINE);
 
 	vty_out(vty, "Local IPv4 Endpoints:%s", VTY_NEWLINE);
 	for (i = 0; i < gss->num_ip4_local; i++)
 		vty_dump_sns_ip4(vty, &gss->ip4_local[i]);
 
 	vty_out(vty, "Remote IPv4 Endpoints:%s", VTY_NEWLINE);
-	for (i = 0; i < gss->num_ip4_remote; i++)
-		vty_dump_sns_ip4(vty, &gss->ip4_remote[i]);
+	llist_for_each_entry(ep, &gss->ep_list, list) {
+		if (!ep->is_ip6)
+			vty_dump_sns_ep(vty, ep);
+	}
+
+	if (gss->num_ep[1]) {
+		vty_out(vty, "Remote IPv6 Endpoints:%s", VTY_NEWLINE);
+		llist_for_each_entry(ep, &gss->ep_list, list) {
+			if (ep->is_ip6)
+				vty_dump_sns_ep(vty, ep);
+		}
+	}
 }
@@ -294,6 +294,7 @@ DEFUN(cfg_nse_nsvc, cfg_nse_nsvci_cmd,
 	if (!nsvc) {
 		nsvc = gprs_nsvc_create2(vty_nsi, nsvci, 1, 1);
 		nsvc->nsei = nsei;
+		gprs_ns_lsf_invalidate(vty_nsi);
 	}
 	nsvc->nsvci = nsvci;
 	/* All NSVCs that are explicitly configured by VTY are
@@ -319,6 +320,7 @@ DEFUN(cfg_nse_remoteip, cfg_nse_remoteip_cmd,
 		return CMD_WARNING;
 	}
 	inet_aton(argv[1], &nsvc->ip.bts_addr.sin_addr);
+	gprs_ns_rem_addr_cache_flush(vty_nsi);
 
 	return CMD_SUCCESS;
 
@@ -347,6 +349,7 @@ DEFUN(cfg_nse_remoteport, cfg_nse_remoteport_cmd,
 	}
 
 	nsvc->ip.bts_addr.sin_port = osmo_htons(port);
+	gprs_ns_rem_addr_cache_flush(vty_nsi);
 
 	return CMD_SUCCESS;
 }
@@ -374,6 +377,7 @@ DEFUN(cfg_nse_fr_dlci, cfg_nse_fr_dlci_cmd,
 	}
 
 	nsvc->frgre.bts_addr.sin_port = osmo_htons(dlci);
+	gprs_ns_rem_addr_cache_flush(vty_nsi);
 
 	return CMD_SUCCESS;
 }
@@ -144,14 +144,18 @@ static int encode_wperiod(uint32_t secs)
  * Message Encoding
  ***********************************************************************/
 
-/* 8.1.3.1 WRITE REPLACE */
-static int cbsp_enc_write_repl(struct msgb *msg, const struct osmo_cbsp_write_replace *in)
+/* 8.1.3.1 WRITE REPLACE: IEs in front of the cell list */
+static void cbsp_enc_write_repl_head(struct msgb *msg, const struct osmo_cbsp_write_replace *in)
 {
 	msgb_tv16_put(msg, CBSP_IEI_MSG_ID, in->msg_id);
 	msgb_tv16_put(msg, CBSP_IEI_NEW_SERIAL_NR, in->new_serial_nr);
 	if (in->old_serial_nr)
 		msgb_tv16_put(msg, CBSP_IEI_OLD_SERIAL_NR, *in->old_serial_nr);
-	msgb_put_cbsp_cell_list(msg, &in->cell_list);
+}
+
+/* 8.1.3.1 WRITE REPLACE: IEs after the cell list */
+static int cbsp_enc_write_repl_tail(struct msgb *msg, const struct osmo_cbsp_write_replace *in)
+{
 	if (in->is_cbs) {
 		int num_of_pages = llist_count(&in->u.cbs.msg_content);
 		struct osmo_cbsp_content *ce;
@@ -187,6 +191,14 @@ static int cbsp_enc_write_repl(struct msgb *msg, const struct osmo_cbsp_write_re
 	return 0;
 }
 
+/* 8.1.3.1 WRITE REPLACE */
+static int cbsp_enc_write_repl(struct msgb *msg, const struct osmo_cbsp_write_replace *in)
+{
+	cbsp_enc_write_repl_head(msg, in);
+	msgb_put_cbsp_cell_list(msg, &in->cell_list);
+	return cbsp_enc_write_repl_tail(msg, in);
+}
+
 /* 8.1.3.2 WRITE REPLACE COMPLETE*/
 static int cbsp_enc_write_repl_compl(struct msgb *msg, const struct osmo_cbsp_write_replace_complete *in)
 {
@@ -493,6 +505,91 @@ struct msgb *osmo_cbsp_encode(void *ctx, const struct osmo_cbsp_decoded *in)
 	return msg;
 }
 
+/* maximum size of the IEs after the cell list: 15 pages of Message Content */
+#define CBSP_WRITE_REPL_TAIL_MAX	(16 + 15 * (2 + 82))
+
+/*! Pre-encode the cell independent parts of a WRITE-REPLACE message.
+ *  All IEs except for the cell list, in particular the pages of a CBS message,
+ *  are encoded once, so that the message can be sent to a large number of cells
+ *  and peers with osmo_cbsp_encode_write_replace_tmpl() without encoding them
+ *  again.  The cell list of \a in is ignored.
+ *  \param[in] ctx talloc context from which to allocate the template.
+ *  \param[in] in decoded WRITE-REPLACE message.  Ownership not transferred.
+ *  \return callee-allocated template; NULL on error */
+struct osmo_cbsp_write_replace_tmpl *osmo_cbsp_write_replace_tmpl_alloc(void *ctx,
+									const struct osmo_cbsp_write_replace *in)
+{
+	struct osmo_cbsp_write_replace_tmpl *tmpl;
+
+	osmo_cbsp_errstr = NULL;
+
+	tmpl = talloc_zero(ctx, struct osmo_cbsp_write_replace_tmpl);
+	if (!tmpl)
+		return NULL;
+
+	tmpl->head = msgb_alloc_c(tmpl, 3 * 3, "cbsp_write_repl_head");
+	tmpl->tail = msgb_alloc_c(tmpl, CBSP_WRITE_REPL_TAIL_MAX, "cbsp_write_repl_tail");
+	if (!tmpl->head || !tmpl->tail)
+		goto err;
+
+	cbsp_enc_write_repl_head(tmpl->head, in);
+	if (cbsp_enc_write_repl_tail(tmpl->tail, in) < 0)
+		goto err;
+
+	return tmpl;
+err:
+	talloc_free(tmpl);
+	return NULL;
+}
+
+/*! Encode a WRITE-REPLACE message from a template and a cell list.
+ *  The result is identical to osmo_cbsp_encode() of the message that the
+ *  template was created from, with \a cell_list as its cell list.  The msgb is
+ *  sized to fit the message, instead of using osmo_cbsp_msgb_alloc().
+ *  \param[in] ctx talloc context from which to allocate returned msgb.
+ *  \param[in] tmpl template created by osmo_cbsp_write_replace_tmpl_alloc().
+ *  \param[in] cell_list cells to which the message is to be broadcast.
+ *  \return callee-allocated message buffer containing binary CBSP PDU; NULL on error */
+struct msgb *osmo_cbsp_encode_write_replace_tmpl(void *ctx, const struct osmo_cbsp_write_replace_tmpl *tmpl,
+						 const struct osmo_cbsp_cell_list *cell_list)
+{
+	int cell_id_size = gsm0808_cell_id_size(cell_list->id_discr);
+	unsigned int len;
+	struct msgb *msg;
+
+	osmo_cbsp_errstr = NULL;
+
+	if (cell_id_size < 0) {
+		osmo_cbsp_errstr = "invalid cell identification discriminator";
+		return NULL;
+	}
+
+	/* header, IEs and cell list IE (tag, length, discriminator, cells) */
+	len = msgb_length(tmpl->head) + 4 + llist_count(&cell_list->list) * cell_id_size +
+	      msgb_length(tmpl->tail);
+	if (len > UINT16_MAX - 4) {
+		osmo_cbsp_errstr = "cell list too long";
+		return NULL;
+	}
+
+	msg = msgb_alloc_headroom_c(ctx, len + 4, 4, __func__);
+	if (!msg)
+		return NULL;
+
+	memcpy(msgb_put(msg, msgb_length(tmpl->head)), msgb_data(tmpl->head), msgb_length(tmpl->head));
+	msgb_put_cbsp_cell_list(msg, cell_list);
+	memcpy(msgb_put(msg, msgb_length(tmpl->tail)), msgb_data(tmpl->tail), msgb_length(tmpl->tail));
+
+	/* push header in front */
+	len = msgb_length(msg);
+	msgb_push_u8(msg, len & 0xff);
+	msgb_push_u8(msg, (len >> 8) & 0xff);
+	msgb_push_u8(msg, (len >> 16) & 0xff);
+	msgb_push_u8(msg, CBSP_MSGT_WRITE_REPLACE);
+
+	return msg;
+}
+
 /***********************************************************************
  * IE Decoding
  ***********************************************************************/
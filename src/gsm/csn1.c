@@ -0,0 +1,280 @@
+/*! \file csn1.c
+ * Table driven CSN.1 (3GPP TS 24.007 Annex B) encoder + decoder. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include <osmocom/core/bitvec.h>
+#include <osmocom/gsm/csn1.h>
+
+/*! \addtogroup csn1
+ *  @{
+ */
+
+static inline uint64_t get_member(const uint8_t *p, uint8_t size)
+{
+	switch (size) {
+	case 1:
+		return *p;
+	case 2:
+		return *(const uint16_t *)p;
+	case 4:
+		return *(const uint32_t *)p;
+	case 8:
+		return *(const uint64_t *)p;
+	default:
+		return 0;
+	}
+}
+
+static inline void set_member(uint8_t *p, uint8_t size, uint64_t val)
+{
+	switch (size) {
+	case 1:
+		*p = val;
+		break;
+	case 2:
+		*(uint16_t *)p = val;
+		break;
+	case 4:
+		*(uint32_t *)p = val;
+		break;
+	case 8:
+		*(uint64_t *)p = val;
+		break;
+	}
+}
+
+/* read num_bits (0..64) bits, L/H decoded if requested */
+static inline int read_bits(struct bitvec *bv, unsigned int num_bits, bool lh, uint64_t *val)
+{
+	return bitvec_get_u64(bv, val, num_bits, lh);
+}
+
+/* write num_bits (0..64) bits, L/H encoded if requested */
+static inline int write_bits(struct bitvec *bv, unsigned int num_bits, bool lh, uint64_t val)
+{
+	if (num_bits > bitvec_tailroom_bits(bv))
+		return -EINVAL;
+	return bitvec_set_u64(bv, val, num_bits, lh);
+}
+
+/* Shared worker of osmo_csn1_decode() and osmo_csn1_encode().  Decoding and
+ * encoding walk the description the same way, so keeping them in one place
+ * ensures that they can never disagree on the syntax. */
+static int csn1_code(const struct osmo_csn1_insn *pc, struct bitvec *bv, uint8_t *base,
+		     bool enc, unsigned int depth)
+{
+	uint64_t val;
+	unsigned int i;
+	int rc;
+
+	if (depth >= OSMO_CSN1_MAX_DEPTH)
+		return -E2BIG;
+
+	while (pc->op != OSMO_CSN1_OP_END) {
+		const struct osmo_csn1_insn *insn = pc++;
+		uint8_t *member = base + insn->offset;
+
+		switch (insn->op) {
+		case OSMO_CSN1_OP_UINT:
+		case OSMO_CSN1_OP_UINT_LH:
+			if (enc) {
+				rc = write_bits(bv, insn->num_bits, insn->op == OSMO_CSN1_OP_UINT_LH,
+						get_member(member, insn->size));
+			} else {
+				rc = read_bits(bv, insn->num_bits, insn->op == OSMO_CSN1_OP_UINT_LH, &val);
+				if (rc == 0)
+					set_member(member, insn->size, val);
+			}
+			if (rc < 0)
+				return rc;
+			break;
+
+		case OSMO_CSN1_OP_UINT_ARRAY:
+			for (i = 0; i < insn->count; i++, member += insn->size) {
+				if (enc) {
+					rc = write_bits(bv, insn->num_bits, false, get_member(member, insn->size));
+				} else {
+					rc = read_bits(bv, insn->num_bits, false, &val);
+					if (rc == 0)
+						set_member(member, insn->size, val);
+				}
+				if (rc < 0)
+					return rc;
+			}
+			break;
+
+		case OSMO_CSN1_OP_NEXT_EXIST:
+		case OSMO_CSN1_OP_NEXT_EXIST_LH:
+			if (enc) {
+				val = !!get_member(member, insn->size);
+				rc = write_bits(bv, 1, insn->op == OSMO_CSN1_OP_NEXT_EXIST_LH, val);
+			} else {
+				rc = read_bits(bv, 1, insn->op == OSMO_CSN1_OP_NEXT_EXIST_LH, &val);
+				if (rc == 0)
+					set_member(member, insn->size, val);
+			}
+			if (rc < 0)
+				return rc;
+			if (!val) {
+				for (i = 0; i < insn->count; i++, pc++) {
+					if (pc->op == OSMO_CSN1_OP_END)
+						return -EINVAL;
+				}
+			}
+			break;
+
+		case OSMO_CSN1_OP_REC_ARRAY:
+		case OSMO_CSN1_OP_REC_TYPE_ARRAY:
+		{
+			uint8_t *num = base + insn->aux;
+			unsigned int n = enc ? *num : 0;
+
+			if (n > insn->count)
+				return -ERANGE;
+
+			for (i = 0; ; i++, member += insn->size) {
+				/* repetition bit: 1 for another element, 0 terminates the list */
+				if (enc) {
+					val = (i < n);
+					rc = write_bits(bv, 1, false, val);
+				} else {
+					rc = read_bits(bv, 1, false, &val);
+				}
+				if (rc < 0)
+					return rc;
+				if (!val)
+					break;
+				if (i >= insn->count)
+					return -ERANGE;
+
+				if (insn->op == OSMO_CSN1_OP_REC_TYPE_ARRAY) {
+					rc = csn1_code(insn->type, bv, member, enc, depth + 1);
+				} else if (enc) {
+					rc = write_bits(bv, insn->num_bits, false, get_member(member, insn->size));
+				} else {
+					rc = read_bits(bv, insn->num_bits, false, &val);
+					if (rc == 0)
+						set_member(member, insn->size, val);
+				}
+				if (rc < 0)
+					return rc;
+			}
+			if (!enc)
+				*num = i;
+			break;
+		}
+
+		case OSMO_CSN1_OP_UNION:
+		{
+			const struct osmo_csn1_insn *alt;
+
+			/* the description must contain all alternatives */
+			for (i = 0; i < insn->count; i++) {
+				if (pc[i].op == OSMO_CSN1_OP_END)
+					return -EINVAL;
+			}
+
+			if (enc) {
+				val = get_member(member, insn->size);
+				rc = val < insn->count ? write_bits(bv, insn->num_bits, false, val) : -ERANGE;
+			} else {
+				rc = read_bits(bv, insn->num_bits, false, &val);
+				if (rc == 0 && val >= insn->count)
+					rc = -ERANGE;
+				if (rc == 0)
+					set_member(member, insn->size, val);
+			}
+			if (rc < 0)
+				return rc;
+
+			/* each alternative is a single instruction, typically OSMO_CSN1_TYPE */
+			alt = &pc[val];
+			if (alt->op != OSMO_CSN1_OP_NULL) {
+				const struct osmo_csn1_insn sub[] = { *alt, OSMO_CSN1_END };
+				rc = csn1_code(sub, bv, base, enc, depth + 1);
+				if (rc < 0)
+					return rc;
+			}
+			pc += insn->count;
+			break;
+		}
+
+		case OSMO_CSN1_OP_TYPE:
+			rc = csn1_code(insn->type, bv, member, enc, depth + 1);
+			if (rc < 0)
+				return rc;
+			break;
+
+		case OSMO_CSN1_OP_FIXED:
+			if (enc) {
+				rc = write_bits(bv, insn->num_bits, false, insn->aux);
+			} else {
+				rc = read_bits(bv, insn->num_bits, false, &val);
+				if (rc == 0 && val != insn->aux)
+					rc = -EBADMSG;
+			}
+			if (rc < 0)
+				return rc;
+			break;
+
+		case OSMO_CSN1_OP_NULL:
+			break;
+
+		case OSMO_CSN1_OP_PADDING:
+			if (enc)
+				bitvec_spare_padding(bv, bv->data_len * 8 - 1);
+			else
+				bv->cur_bit = bv->data_len * 8;
+			break;
+
+		default:
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*! Decode a CSN.1 structure.
+ *  \param[in] descr CSN.1 description of the structure.
+ *  \param[in] bv bit vector to decode from, starting at bv->cur_bit.
+ *  \param[out] data struct described by descr, receiving the decoded values. Members of
+ *  absent optional elements are not touched, the caller usually zero-initializes data.
+ *  \returns 0 on success (bv->cur_bit points after the structure); negative errno on error:
+ *  -EINVAL if the bit vector is too short, -ERANGE for an invalid union selector or too
+ *  many array elements, -EBADMSG for a mismatching fixed pattern, -E2BIG if nested too deep. */
+int osmo_csn1_decode(const struct osmo_csn1_insn *descr, struct bitvec *bv, void *data)
+{
+	return csn1_code(descr, bv, data, false, 0);
+}
+
+/*! Encode a CSN.1 structure.
+ *  \param[in] descr CSN.1 description of the structure.
+ *  \param[inout] bv bit vector to encode to, starting at bv->cur_bit.
+ *  \param[in] data struct described by descr, holding the values to encode.
+ *  \returns 0 on success (bv->cur_bit points after the structure); negative errno on error:
+ *  -EINVAL if the bit vector is too short, -ERANGE for an invalid union selector or too
+ *  many array elements, -E2BIG if nested too deep. */
+int osmo_csn1_encode(const struct osmo_csn1_insn *descr, struct bitvec *bv, const void *data)
+{
+	return csn1_code(descr, bv, (uint8_t *)data, true, 0);
+}
+
+/*! @} */
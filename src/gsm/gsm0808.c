@@ -1754,4 +1754,10 @@ const struct value_string gsm0808_lcls_status_names[] = {
 	{ 0, NULL }
 };
 
+static __attribute__((constructor)) void on_dso_load_gsm0808(void)
+{
+	value_string_index(gsm0808_msgt_names);
+	value_string_index(gsm0808_cause_names);
+}
+
 /*! @} */
@@ -1867,4 +1867,18 @@ int8_t osmo_gsm48_rfpowercap2powerclass(enum gsm_band band, uint8_t rf_power_cap
 }
 
 
+static __attribute__((constructor)) void on_dso_load_gsm48(void)
+{
+	value_string_index(rr_cause_names);
+	value_string_index(cc_msg_names);
+	value_string_index(rr_msg_names);
+	value_string_index(gsm48_pdisc_names);
+	value_string_index(gsm48_rr_msgtype_names);
+	value_string_index(gsm48_mm_msgtype_names);
+	value_string_index(gsm48_cc_msgtype_names);
+	value_string_index(gsm48_cc_cause_names);
+	value_string_index(gsm48_nc_ss_msgtype_names);
+	value_string_index(gsm48_reject_value_names);
+}
+
 /*! @} */
@@ -26,6 +26,7 @@
 #include <osmocom/core/utils.h>
 
 #include <errno.h>
+#include <string.h>
 
 static inline int greatest_power_of_2_lesser_or_equal_to(int index)
 {
@@ -47,92 +48,163 @@ static inline int mod(int data, int range)
 	return res;
 }
 
-/**
- * Determine at which index to split the ARFCNs to create an
- * equally size partition for the given range. Return -1 if
- * no such partition exists.
+/*
+ * The partition tree is built from lists kept sorted by frequency modulo the
+ * current range. Each entry also carries its position in the caller's list, so
+ * that ties are broken exactly like the straightforward quadratic search does:
+ * the first matching frequency in list order wins.
  */
-int osmo_gsm48_range_enc_find_index(enum osmo_gsm48_range range, const int *freqs, const int size)
+struct range_enc_elem {
+	int val;	/* frequency modulo the current range */
+	int pos;	/* position in the original ARFCN list */
+};
+
+/* Build the element list for freqs[], sorted by frequency modulo range */
+static void range_enc_elems_init(struct range_enc_elem *elems, enum osmo_gsm48_range range,
+				 const int *freqs, int size)
 {
-	int i, j, n;
+	struct range_enc_elem tmp;
+	int i, j;
+
+	/* insertion sort, stable and fast enough for these list sizes */
+	for (i = 0; i < size; i++) {
+		tmp = (struct range_enc_elem) { .val = mod(freqs[i], range), .pos = i };
+		for (j = i; j > 0 && elems[j - 1].val > tmp.val; j--)
+			elems[j] = elems[j - 1];
+		elems[j] = tmp;
+	}
+}
+
+/* Index of the first element with a value not lower than val */
+static inline int range_enc_lower_bound(const struct range_enc_elem *elems, int size, int val)
+{
+	int lo = 0, hi = size, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (elems[mid].val < val)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
 
+/*
+ * Find the pivot splitting the sorted elements into two equally sized halves.
+ * For every element the number of elements within [val, val + (range - 1) / 2]
+ * (modulo range) is computed in a single sliding window pass. Returns the index
+ * into elems[] or -1 if no such partition exists.
+ */
+static int range_enc_find_pivot(const struct range_enc_elem *elems, int size, int range)
+{
 	const int RANGE_DELTA = (range - 1) / 2;
+	const int wanted = (size - 1) / 2 + 1;
+	int vals[2 * size];
+	int k, end = 0, cnt = 0;
+	int best = -1;
+
+	/* unroll the circle, so that the window never needs to wrap */
+	for (k = 0; k < size; k++) {
+		vals[k] = elems[k].val;
+		vals[k + size] = elems[k].val + range;
+	}
 
-	for (i = 0; i < size; ++i) {
-		n = 0;
-		for (j = 0; j < size; ++j) {
-			if (mod(freqs[j] - freqs[i], range) <= RANGE_DELTA)
-				n += 1;
+	for (k = 0; k < size; k++) {
+		/* duplicates share the count of the first one of their run */
+		if (k == 0 || vals[k] != vals[k - 1]) {
+			if (end < k)
+				end = k;
+			while (end < k + size && vals[end] - vals[k] <= RANGE_DELTA)
+				end++;
+			cnt = end - k;
 		}
-
-		if (n - 1 == (size - 1) / 2)
-			return i;
+		if (cnt == wanted && (best < 0 || elems[k].pos < elems[best].pos))
+			best = k;
 	}
 
-	return -1;
+	return best;
 }
 
-/* Worker for range_enc_arfcns(), do not call directly. */
-static int _range_enc_arfcns(enum osmo_gsm48_range range,
-		const int *arfcns, int size, int *out,
-		const int index)
+/*
+ * Append the elements within [origin, origin + range / 2) (modulo range) to
+ * out[], relative to origin. The result is again sorted. Returns the number of
+ * elements appended or -1 if more than max_out would be needed.
+ */
+static int range_enc_subset(struct range_enc_elem *out, int max_out,
+			    const struct range_enc_elem *elems, int size, int range, int origin)
 {
-	int split_at;
-	int i;
+	int k = range_enc_lower_bound(elems, size, origin);
+	int i, n = 0;
+
+	for (i = 0; i < size; i++, k++) {
+		const struct range_enc_elem *e;
+		int v;
+
+		if (k == size)
+			k = 0;
+		e = &elems[k];
+		v = e->val - origin;
+
+		if (v < 0)
+			v += range;
+		if (v >= range / 2)
+			break;
+		if (n == max_out)
+			return -1;
+		out[n++] = (struct range_enc_elem) { .val = v, .pos = e->pos };
+	}
 
-	/*
-	 * The below is a GNU extension and we can remove it when
-	 * we move to a quicksort like in-situ swap with the pivot.
-	 */
-	int arfcns_left[size / 2];
-	int arfcns_right[size / 2];
-	int l_size;
-	int r_size;
-	int l_origin;
-	int r_origin;
-
-	/* Now do the processing */
-	split_at = osmo_gsm48_range_enc_find_index(range, arfcns, size);
-	if (split_at < 0)
-		return -EINVAL;
+	return n;
+}
 
-	/* we now know where to split */
-	out[index] = 1 + arfcns[split_at];
-
-	/* calculate the work that needs to be done for the leafs */
-	l_origin = mod(arfcns[split_at] + ((range - 1) / 2) + 1, range);
-	r_origin = mod(arfcns[split_at] + 1, range);
-	for (i = 0, l_size = 0, r_size = 0; i < size; ++i) {
-		if (mod(arfcns[i] - l_origin, range) < range / 2)
-			arfcns_left[l_size++] = mod(arfcns[i] - l_origin, range);
-		if (mod(arfcns[i] - r_origin, range) < range / 2)
-			arfcns_right[r_size++] = mod(arfcns[i] - r_origin, range);
-	}
+/**
+ * Determine at which index to split the ARFCNs to create an
+ * equally size partition for the given range. Return -1 if
+ * no such partition exists.
+ */
+int osmo_gsm48_range_enc_find_index(enum osmo_gsm48_range range, const int *freqs, const int size)
+{
+	struct range_enc_elem elems[size > 0 ? size : 1];
+	int pivot;
 
-	/*
-	 * Now recurse and we need to make this iterative... but as the
-	 * tree is balanced the stack will not be too deep.
-	 */
-	if (l_size)
-		osmo_gsm48_range_enc_arfcns(range / 2, arfcns_left, l_size,
-			out, index + greatest_power_of_2_lesser_or_equal_to(index + 1));
-	if (r_size)
-		osmo_gsm48_range_enc_arfcns((range - 1) / 2, arfcns_right, r_size,
-			 out, index + (2 * greatest_power_of_2_lesser_or_equal_to(index + 1)));
-	return 0;
+	range_enc_elems_init(elems, range, freqs, size);
+	pivot = range_enc_find_pivot(elems, size, range);
+
+	return pivot < 0 ? -1 : elems[pivot].pos;
 }
 
+/* One node of the partition tree: a subset of the ARFCNs to be encoded with the given range at out[index] */
+struct range_enc_node {
+	int range;
+	int index;
+	int size;
+	int offs;	/* offset of the subset in the per-level element buffer */
+};
+
 /**
  * Range encode the ARFCN list.
+ *
+ * The partition tree is processed level by level. The subsets of all nodes on
+ * a tree level are disjoint, so two buffers of the input size are sufficient to
+ * hold the current and the next level and no allocation or recursion is needed.
+ *
  * \param range The range to use.
  * \param arfcns The list of ARFCNs
- * \param size The size of the list of ARFCNs
+ * \param size The size of the list of ARFCNs, at most OSMO_GSM48_RANGE_ENC_MAX_ARFCNS
  * \param out Place to store the W(i) output.
+ * \param index Index into out at which to store the W(i) of the tree root, usually 0.
+ * \returns 0 on success, negative errno on error.
  */
 int osmo_gsm48_range_enc_arfcns(enum osmo_gsm48_range range,
 		const int *arfcns, int size, int *out,
 		const int index)
 {
+	struct range_enc_node nodes[2][OSMO_GSM48_RANGE_ENC_MAX_ARFCNS];
+	struct range_enc_elem buf[2][OSMO_GSM48_RANGE_ENC_MAX_ARFCNS];
+	int num_nodes, cur = 0;
+	int n;
+
 	if (size <= 0)
 		return 0;
 
@@ -141,7 +213,83 @@ int osmo_gsm48_range_enc_arfcns(enum osmo_gsm48_range range,
 		return 0;
 	}
 
-	return _range_enc_arfcns(range, arfcns, size, out, index);
+	if (size > OSMO_GSM48_RANGE_ENC_MAX_ARFCNS)
+		return -E2BIG;
+
+	range_enc_elems_init(buf[cur], range, arfcns, size);
+	nodes[cur][0] = (struct range_enc_node) {
+		.range = range,
+		.index = index,
+		.size = size,
+		.offs = 0,
+	};
+	num_nodes = 1;
+
+	while (num_nodes > 0) {
+		int next_nodes = 0;
+		int next_offs = 0;
+
+		for (n = 0; n < num_nodes; n++) {
+			const struct range_enc_node *node = &nodes[cur][n];
+			const struct range_enc_elem *elems = &buf[cur][node->offs];
+			int rng = node->range;
+			int pivot, pivot_val, step;
+			int l_size, r_size;
+
+			/* leafs need no partitioning, about half of the nodes are leafs */
+			if (node->size == 1) {
+				out[node->index] = 1 + elems[0].val;
+				continue;
+			}
+
+			pivot = range_enc_find_pivot(elems, node->size, rng);
+			if (pivot < 0)
+				return -EINVAL;
+			pivot_val = elems[pivot].val;
+
+			/* we now know where to split, the root keeps the value as passed by the caller */
+			if (node->index == index)
+				out[node->index] = 1 + arfcns[elems[pivot].pos];
+			else
+				out[node->index] = 1 + pivot_val;
+
+			/* calculate the work that needs to be done for the leafs */
+			l_size = range_enc_subset(&buf[!cur][next_offs], OSMO_GSM48_RANGE_ENC_MAX_ARFCNS - next_offs,
+						  elems, node->size, rng, mod(pivot_val + ((rng - 1) / 2) + 1, rng));
+			if (l_size < 0)
+				return -EINVAL;
+			r_size = range_enc_subset(&buf[!cur][next_offs + l_size],
+						  OSMO_GSM48_RANGE_ENC_MAX_ARFCNS - next_offs - l_size,
+						  elems, node->size, rng, mod(pivot_val + 1, rng));
+			if (r_size < 0)
+				return -EINVAL;
+
+			step = greatest_power_of_2_lesser_or_equal_to(node->index + 1);
+			if (l_size) {
+				nodes[!cur][next_nodes++] = (struct range_enc_node) {
+					.range = rng / 2,
+					.index = node->index + step,
+					.size = l_size,
+					.offs = next_offs,
+				};
+				next_offs += l_size;
+			}
+			if (r_size) {
+				nodes[!cur][next_nodes++] = (struct range_enc_node) {
+					.range = (rng - 1) / 2,
+					.index = node->index + 2 * step,
+					.size = r_size,
+					.offs = next_offs,
+				};
+				next_offs += r_size;
+			}
+		}
+
+		num_nodes = next_nodes;
+		cur = !cur;
+	}
+
+	return 0;
 }
 
 /*
@@ -319,3 +467,119 @@ int osmo_gsm48_range_enc_filter_arfcns(int *arfcns, const int size, const int f0
 
 	return j;
 }
+
+/**
+ * Range encode a list of ARFCNs as Frequency List / Neighbour Cell Description,
+ * see 3GPP TS 44.018 section 10.5.2.13 and Annex J. This combines
+ * osmo_gsm48_range_enc_determine_range(), osmo_gsm48_range_enc_filter_arfcns(),
+ * osmo_gsm48_range_enc_arfcns() and the osmo_gsm48_range_enc_*() writers.
+ * \param[out] chan_list 16 octets of output, the format identifier bits are set as well.
+ * \param[in] arfcns The ARFCNs to encode, in any order and without duplicates.
+ * \param[in] size The number of ARFCNs, at most OSMO_GSM48_RANGE_ENC_MAX_ARFCNS.
+ * \returns the used range (enum osmo_gsm48_range) on success, negative errno on error.
+ */
+int osmo_gsm48_range_enc_freq_list(uint8_t *chan_list, const int *arfcns, int size)
+{
+	int sorted[OSMO_GSM48_RANGE_ENC_MAX_ARFCNS];
+	int w[OSMO_GSM48_RANGE_ENC_MAX_ARFCNS];
+	int f0, f0_included = 0;
+	enum osmo_gsm48_range range;
+	int i, j, tmp, rc;
+
+	if (size <= 0 || size > OSMO_GSM48_RANGE_ENC_MAX_ARFCNS)
+		return -EINVAL;
+
+	for (i = 0; i < size; i++) {
+		tmp = arfcns[i];
+		for (j = i; j > 0 && sorted[j - 1] > tmp; j--)
+			sorted[j] = sorted[j - 1];
+		sorted[j] = tmp;
+	}
+
+	range = osmo_gsm48_range_enc_determine_range(sorted, size, &f0);
+	if (range == OSMO_GSM48_ARFCN_RANGE_INVALID)
+		return -ERANGE;
+
+	size = osmo_gsm48_range_enc_filter_arfcns(sorted, size, f0, &f0_included);
+
+	memset(w, 0, sizeof(w));
+	rc = osmo_gsm48_range_enc_arfcns(range, sorted, size, w, 0);
+	if (rc < 0)
+		return rc;
+
+	memset(chan_list, 0, 16);
+	switch (range) {
+	case OSMO_GSM48_ARFCN_RANGE_128:
+		osmo_gsm48_range_enc_128(chan_list, f0, w);
+		break;
+	case OSMO_GSM48_ARFCN_RANGE_256:
+		osmo_gsm48_range_enc_256(chan_list, f0, w);
+		break;
+	case OSMO_GSM48_ARFCN_RANGE_512:
+		osmo_gsm48_range_enc_512(chan_list, f0, w);
+		break;
+	case OSMO_GSM48_ARFCN_RANGE_1024:
+		osmo_gsm48_range_enc_1024(chan_list, f0, f0_included, w);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return range;
+}
+
+#define RANGE_ENC_BULK_CACHE_SIZE 64
+
+static uint32_t range_enc_list_hash(const int *arfcns, int size)
+{
+	uint32_t h = 2166136261u;
+	int i;
+
+	for (i = 0; i < size; i++)
+		h = (h ^ (uint32_t)arfcns[i]) * 16777619u;
+	return h;
+}
+
+/**
+ * Range encode many ARFCN lists in one call, e.g. the neighbour lists of all
+ * cells of a network after a change of the frequency plan. Lists with the same
+ * content (as passed in, i.e. in the same order) are encoded only once.
+ * \param[inout] lists Array of lists; arfcns and size are inputs, chan_list and rc are outputs.
+ * \param[in] num Number of entries in lists.
+ * \returns the number of lists that were encoded successfully.
+ */
+unsigned int osmo_gsm48_range_enc_freq_lists(struct osmo_gsm48_range_enc_list *lists, unsigned int num)
+{
+	int cache[RANGE_ENC_BULK_CACHE_SIZE];
+	unsigned int i, num_ok = 0;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++)
+		cache[i] = -1;
+
+	for (i = 0; i < num; i++) {
+		struct osmo_gsm48_range_enc_list *l = &lists[i];
+		const struct osmo_gsm48_range_enc_list *prev;
+		unsigned int slot;
+
+		if (l->size <= 0 || l->size > OSMO_GSM48_RANGE_ENC_MAX_ARFCNS) {
+			l->rc = -EINVAL;
+			continue;
+		}
+
+		slot = range_enc_list_hash(l->arfcns, l->size) % RANGE_ENC_BULK_CACHE_SIZE;
+		prev = cache[slot] >= 0 ? &lists[cache[slot]] : NULL;
+		if (prev && prev->size == l->size
+		    && (prev->arfcns == l->arfcns || !memcmp(prev->arfcns, l->arfcns, l->size * sizeof(int)))) {
+			memcpy(l->chan_list, prev->chan_list, sizeof(l->chan_list));
+			l->rc = prev->rc;
+		} else {
+			l->rc = osmo_gsm48_range_enc_freq_list(l->chan_list, l->arfcns, l->size);
+			cache[slot] = i;
+		}
+
+		if (l->rc >= 0)
+			num_ok++;
+	}
+
+	return num_ok;
+}
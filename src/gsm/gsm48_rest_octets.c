@@ -946,6 +946,244 @@ int osmo_gsm48_rest_octets_si13_encode(uint8_t *data, const struct osmo_gsm48_si
 }
 
 
+/***********************************************************************
+ * Cached encoder
+ ***********************************************************************/
+
+/*! Initialize a SI rest octets cache; all parts are marked dirty.
+ *  \param[out] cache caller-allocated cache to initialize */
+void osmo_gsm48_si_ro_cache_init(struct osmo_gsm48_si_ro_cache *cache)
+{
+	memset(cache, 0, sizeof(*cache));
+	cache->si4.len = sizeof(cache->si4.ro);
+	cache->dirty = (1 << _NUM_OSMO_GSM48_SI_RO_PART) - 1;
+}
+
+/*! Set the neighbour lists to be encoded in the SI2quater rest octets.
+ *  \param[inout] cache SI rest octets cache
+ *  \param[in] uarfcn_list UARFCNs, owned by the caller
+ *  \param[in] scramble_list Scrambling Codes, owned by the caller
+ *  \param[in] uarfcn_length number of entries in uarfcn_list / scramble_list
+ *  \param[in] earfcn_list E-UTRAN neighbours, owned by the caller (may be NULL)
+ *
+ * As the lists are not copied, this needs to be called whenever their contents
+ * change, even if the pointers stay the same. */
+void osmo_gsm48_si_ro_cache_set_si2quater(struct osmo_gsm48_si_ro_cache *cache,
+					  const uint16_t *uarfcn_list, uint16_t *scramble_list,
+					  size_t uarfcn_length, struct osmo_earfcn_si2q *earfcn_list)
+{
+	cache->si2quater.uarfcn_list = uarfcn_list;
+	cache->si2quater.scramble_list = scramble_list;
+	cache->si2quater.uarfcn_length = uarfcn_length;
+	cache->si2quater.earfcn_list = earfcn_list;
+	cache->dirty |= 1 << OSMO_GSM48_SI_RO_SI2QUATER;
+}
+
+/* copy 'in' to the cached input parameters, mark part dirty if they changed */
+static void si_ro_cache_set(struct osmo_gsm48_si_ro_cache *cache, enum osmo_gsm48_si_ro_part part,
+			    void *cached, const void *in, size_t len)
+{
+	if (!(cache->dirty & (1 << part)) && !memcmp(cached, in, len))
+		return;
+	memcpy(cached, in, len);
+	cache->dirty |= 1 << part;
+}
+
+/*! Set the SI3 rest octets parameters; see osmo_gsm48_rest_octets_si3_encode(). */
+void osmo_gsm48_si_ro_cache_set_si3(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si_ro_info *si3)
+{
+	si_ro_cache_set(cache, OSMO_GSM48_SI_RO_SI3, &cache->si3.info, si3, sizeof(*si3));
+}
+
+/*! Set the SI4 rest octets parameters; see osmo_gsm48_rest_octets_si4_encode(). */
+void osmo_gsm48_si_ro_cache_set_si4(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si_ro_info *si4,
+				    int len)
+{
+	OSMO_ASSERT(len > 0 && len <= sizeof(cache->si4.ro));
+	if (cache->si4.len != len) {
+		cache->si4.len = len;
+		cache->dirty |= 1 << OSMO_GSM48_SI_RO_SI4;
+	}
+	si_ro_cache_set(cache, OSMO_GSM48_SI_RO_SI4, &cache->si4.info, si4, sizeof(*si4));
+}
+
+/*! Set the SI6 rest octets parameters; see osmo_gsm48_rest_octets_si6_encode(). */
+void osmo_gsm48_si_ro_cache_set_si6(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si6_ro_info *si6)
+{
+	si_ro_cache_set(cache, OSMO_GSM48_SI_RO_SI6, &cache->si6.info, si6, sizeof(*si6));
+}
+
+/*! Set the SI13 rest octets parameters; see osmo_gsm48_rest_octets_si13_encode(). */
+void osmo_gsm48_si_ro_cache_set_si13(struct osmo_gsm48_si_ro_cache *cache, const struct osmo_gsm48_si13_info *si13)
+{
+	si_ro_cache_set(cache, OSMO_GSM48_SI_RO_SI13, &cache->si13.info, si13, sizeof(*si13));
+}
+
+/* encode as many SI2quater messages as required to fit all neighbours */
+static int si_ro_cache_encode_si2quater(struct osmo_gsm48_si_ro_cache *cache)
+{
+	size_t e_count = si2q_earfcn_count(cache->si2quater.earfcn_list);
+	size_t u_offset = 0, e_offset = 0;
+	unsigned int i, count, pos;
+	struct bitvec bv;
+	int rc;
+
+	for (i = 0; i < SI2Q_MAX_NUM; i++) {
+		size_t u_prev = u_offset, e_prev = e_offset;
+
+		/* SI2quater_COUNT is not known yet, it is patched in below */
+		rc = osmo_gsm48_rest_octets_si2quater_encode(cache->si2quater.ro[i], i, SI2Q_MAX_NUM - 1,
+							     cache->si2quater.uarfcn_list, &u_offset,
+							     cache->si2quater.uarfcn_length,
+							     cache->si2quater.scramble_list,
+							     cache->si2quater.earfcn_list, &e_offset);
+		if (rc < 0)
+			return rc;
+		if (u_offset >= cache->si2quater.uarfcn_length && e_offset >= e_count)
+			break;
+		/* no space for even a single neighbour */
+		if (u_offset == u_prev && e_offset == e_prev)
+			return -ENOMEM;
+	}
+	if (i == SI2Q_MAX_NUM)
+		return -ENOMEM;
+
+	count = i + 1;
+	for (i = 0; i < count; i++) {
+		bv.data = cache->si2quater.ro[i];
+		bv.data_len = sizeof(cache->si2quater.ro[i]);
+		/* BA_IND, 3G_BA_IND, MP_CHANGE_MARK, SI2quater_INDEX */
+		pos = 7;
+		bitvec_write_field(&bv, &pos, count - 1, 4);
+	}
+	cache->si2quater.count = count;
+
+	return 0;
+}
+
+static int si_ro_cache_encode_part(struct osmo_gsm48_si_ro_cache *cache, enum osmo_gsm48_si_ro_part part)
+{
+	switch (part) {
+	case OSMO_GSM48_SI_RO_SI2QUATER:
+		return si_ro_cache_encode_si2quater(cache);
+	case OSMO_GSM48_SI_RO_SI3:
+		return osmo_gsm48_rest_octets_si3_encode(cache->si3.ro, &cache->si3.info);
+	case OSMO_GSM48_SI_RO_SI4:
+		memset(cache->si4.ro, 0, sizeof(cache->si4.ro));
+		return osmo_gsm48_rest_octets_si4_encode(cache->si4.ro, &cache->si4.info, cache->si4.len);
+	case OSMO_GSM48_SI_RO_SI6:
+		return osmo_gsm48_rest_octets_si6_encode(cache->si6.ro, &cache->si6.info);
+	case OSMO_GSM48_SI_RO_SI13:
+		return osmo_gsm48_rest_octets_si13_encode(cache->si13.ro, &cache->si13.info);
+	default:
+		return -EINVAL;
+	}
+}
+
+/*! Re-encode all dirty parts of a SI rest octets cache.
+ *  \param[inout] cache SI rest octets cache
+ *  \returns number of re-encoded parts; negative errno on error.
+ *
+ * Parts which fail to encode stay dirty. */
+int osmo_gsm48_si_ro_cache_encode(struct osmo_gsm48_si_ro_cache *cache)
+{
+	int part, rc, num = 0;
+
+	for (part = 0; part < _NUM_OSMO_GSM48_SI_RO_PART; part++) {
+		if (!(cache->dirty & (1 << part)))
+			continue;
+		rc = si_ro_cache_encode_part(cache, part);
+		if (rc < 0)
+			return rc;
+		cache->dirty &= ~(1 << part);
+		num++;
+	}
+
+	return num;
+}
+
+/* compare two arrays of the same length, either of which may be NULL */
+static bool si2q_array_equal(const void *a, const void *b, size_t len)
+{
+	if (a == b || !len)
+		return true;
+	if (!a || !b)
+		return false;
+	return !memcmp(a, b, len);
+}
+
+/* do both E-UTRAN neighbour lists have the same contents? */
+static bool si2q_earfcn_equal(const struct osmo_earfcn_si2q *a, const struct osmo_earfcn_si2q *b)
+{
+	if (a == b)
+		return true;
+	if (!a || !b)
+		return false;
+	return a->length == b->length
+		&& a->thresh_hi == b->thresh_hi
+		&& a->thresh_lo == b->thresh_lo
+		&& a->prio == b->prio
+		&& a->qrxlm == b->qrxlm
+		&& a->thresh_lo_valid == b->thresh_lo_valid
+		&& a->prio_valid == b->prio_valid
+		&& a->qrxlm_valid == b->qrxlm_valid
+		&& si2q_array_equal(a->arfcn, b->arfcn, a->length * sizeof(a->arfcn[0]))
+		&& si2q_array_equal(a->meas_bw, b->meas_bw, a->length * sizeof(a->meas_bw[0]));
+}
+
+/* do both caches have SI2quater neighbour lists with the same contents? */
+static bool si_ro_cache_same_si2quater(const struct osmo_gsm48_si_ro_cache *a,
+				       const struct osmo_gsm48_si_ro_cache *b)
+{
+	size_t len = a->si2quater.uarfcn_length;
+
+	return len == b->si2quater.uarfcn_length
+		&& si2q_array_equal(a->si2quater.uarfcn_list, b->si2quater.uarfcn_list,
+				    len * sizeof(a->si2quater.uarfcn_list[0]))
+		&& si2q_array_equal(a->si2quater.scramble_list, b->si2quater.scramble_list,
+				    len * sizeof(a->si2quater.scramble_list[0]))
+		&& si2q_earfcn_equal(a->si2quater.earfcn_list, b->si2quater.earfcn_list);
+}
+
+/*! Re-encode all dirty parts of a number of SI rest octets caches, e.g. of all cells at startup.
+ *  \param[inout] caches array of SI rest octets caches
+ *  \param[in] num_caches number of entries in caches
+ *  \returns number of re-encoded parts; negative errno on error.
+ *
+ * Cells with identical SI2quater neighbour lists (same contents, not necessarily
+ * the same list pointers) share the result of encoding them once. */
+int osmo_gsm48_si_ro_cache_encode_bulk(struct osmo_gsm48_si_ro_cache **caches, unsigned int num_caches)
+{
+	unsigned int i, j;
+	int rc, num = 0;
+
+	for (i = 0; i < num_caches; i++) {
+		struct osmo_gsm48_si_ro_cache *cache = caches[i];
+
+		if (cache->dirty & (1 << OSMO_GSM48_SI_RO_SI2QUATER)) {
+			/* caches before this one have been encoded already */
+			for (j = 0; j < i; j++) {
+				if (!si_ro_cache_same_si2quater(cache, caches[j]))
+					continue;
+				cache->si2quater.count = caches[j]->si2quater.count;
+				memcpy(cache->si2quater.ro, caches[j]->si2quater.ro,
+				       cache->si2quater.count * sizeof(cache->si2quater.ro[0]));
+				cache->dirty &= ~(1 << OSMO_GSM48_SI_RO_SI2QUATER);
+				num++;
+				break;
+			}
+		}
+
+		rc = osmo_gsm48_si_ro_cache_encode(cache);
+		if (rc < 0)
+			return rc;
+		num += rc;
+	}
+
+	return num;
+}
+
+
 /***********************************************************************
  * Decoder
  ***********************************************************************/
@@ -81,6 +81,8 @@
 //#include <openbsc/gsm_data.h>
 #include <osmocom/core/utils.h>
 #include <osmocom/core/bitvec.h>
+#include <osmocom/core/bit32gen.h>
+#include <osmocom/core/bit64gen.h>
 #include <osmocom/gsm/gsm_utils.h>
 #include <osmocom/gsm/meas_rep.h>
 #include <osmocom/gsm/protocol/gsm_04_08.h>
@@ -95,6 +97,7 @@
 #include <inttypes.h>
 #include <time.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include "../../config.h"
 
@@ -171,18 +174,95 @@ static unsigned char gsm_7bit_alphabet[] = {
 	0xff, 0x5b, 0x0e, 0x1c, 0x09, 0xff, 0x1f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x5d,
 	0xff, 0xff, 0xff, 0xff, 0x5c, 0xff, 0x0b, 0xff, 0xff, 0xff, 0x5e, 0xff, 0xff, 0x1e, 0x7f,
 	0xff, 0xff, 0xff, 0x7b, 0x0f, 0x1d, 0xff, 0x04, 0x05, 0xff, 0xff, 0x07, 0xff, 0xff, 0xff,
-	0xff, 0x7d, 0x08, 0xff, 0xff, 0xff, 0x7c, 0xff, 0x0c, 0x06, 0xff, 0xff, 0x7e, 0xff, 0xff
+	0xff, 0x7d, 0x08, 0xff, 0xff, 0xff, 0x7c, 0xff, 0x0c, 0x06, 0xff, 0xff, 0x7e, 0xff, 0xff,
+	0xff
 };
 
-/* GSM 03.38 6.2.1 Character lookup for decoding */
-static int gsm_septet_lookup(uint8_t ch)
+/* GSM 03.38 6.2.1 Character lookup for decoding: reverse of gsm_7bit_alphabet,
+ * the first matching entry for each septet */
+static uint8_t gsm_septet_alphabet[128];
+
+static __attribute__((constructor)) void on_dso_load_gsm_7bit(void)
 {
-	int i = 0;
-	for (; i < sizeof(gsm_7bit_alphabet); i++) {
-		if (gsm_7bit_alphabet[i] == ch)
-			return i;
+	int i;
+
+	memset(gsm_septet_alphabet, 0xff, sizeof(gsm_septet_alphabet));
+	for (i = sizeof(gsm_7bit_alphabet) - 1; i >= 0; i--) {
+		if (gsm_7bit_alphabet[i] < ARRAY_SIZE(gsm_septet_alphabet))
+			gsm_septet_alphabet[gsm_7bit_alphabet[i]] = i;
 	}
-	return -1;
+}
+
+/* Pack 8 septets into 7 octets (56 bits, LSB first) in one 64-bit word */
+static inline uint64_t gsm_septets_pack8(const uint8_t *septets)
+{
+	uint64_t x = osmo_load64le(septets) & 0x7f7f7f7f7f7f7f7fULL;
+
+	x = (x & 0x007f007f007f007fULL) | ((x & 0x7f007f007f007f00ULL) >> 1);
+	x = (x & 0x00003fff00003fffULL) | ((x & 0x3fff00003fff0000ULL) >> 2);
+	x = (x & 0x000000000fffffffULL) | ((x & 0x0fffffff00000000ULL) >> 4);
+	return x;
+}
+
+/* Unpack 7 octets into 8 septets, reverse of gsm_septets_pack8() */
+static inline void gsm_septets_unpack8(uint8_t *septets, const uint8_t *octets)
+{
+	uint64_t x = osmo_load64le_ext(octets, 7);
+
+	x = (x & 0x000000000fffffffULL) | ((x << 4) & 0x0fffffff00000000ULL);
+	x = (x & 0x00003fff00003fffULL) | ((x << 2) & 0x3fff00003fff0000ULL);
+	x = (x & 0x007f007f007f007fULL) | ((x << 1) & 0x7f007f007f007f00ULL);
+	osmo_store64le(x, septets);
+}
+
+/* Septet packing state: septets are collected in a block of 8 and written as
+ * 7 octets at once, following an initial number of padding bits */
+struct gsm_septet_packer {
+	uint8_t *out;
+	uint64_t acc;		/* pending bits, LSB first */
+	unsigned int nbits;	/* number of pending bits, < 8 between blocks */
+	uint8_t block[8];
+	unsigned int nblock;
+};
+
+static inline void gsm_septet_packer_init(struct gsm_septet_packer *pk, uint8_t *out, unsigned int padding)
+{
+	pk->out = out;
+	pk->acc = 0;
+	pk->nbits = padding;
+	pk->nblock = 0;
+}
+
+static inline void gsm_septet_packer_put(struct gsm_septet_packer *pk, uint8_t septet)
+{
+	pk->block[pk->nblock++] = septet;
+	if (pk->nblock < 8)
+		return;
+
+	pk->acc |= gsm_septets_pack8(pk->block) << pk->nbits;
+	osmo_store64le_ext(pk->acc, pk->out, 7);
+	pk->out += 7;
+	pk->acc >>= 56;
+	pk->nblock = 0;
+}
+
+/* flush the remaining septets and pending bits, return the end of the output */
+static inline uint8_t *gsm_septet_packer_finish(struct gsm_septet_packer *pk)
+{
+	unsigned int i;
+
+	for (i = 0; i < pk->nblock; i++) {
+		pk->acc |= (uint64_t)(pk->block[i] & 0x7f) << pk->nbits;
+		pk->nbits += 7;
+	}
+	for (; pk->nbits >= 8; pk->nbits -= 8) {
+		*pk->out++ = pk->acc;
+		pk->acc >>= 8;
+	}
+	if (pk->nbits)
+		*pk->out++ = pk->acc;
+
+	return pk->out;
 }
 
 /*! Compute number of octets from number of septets.
@@ -207,10 +287,14 @@ uint8_t gsm_get_octet_len(const uint8_t sept_len){
 int gsm_7bit_decode_n_hdr(char *text, size_t n, const uint8_t *user_data, uint8_t septet_l, uint8_t ud_hdr_ind)
 {
 	unsigned shift = 0;
-	uint8_t c7, c8, next_is_ext = 0, lu, ru;
+	uint8_t c7, c8, next_is_ext = 0;
 	const uint8_t maxlen = gsm_get_octet_len(septet_l);
 	const char *text_buf_begin = text;
 	const char *text_buf_end = text + n;
+	/* up to 255 septets in 224 octets, unpacked 8 septets from 7 octets at a time */
+	uint8_t octets[224 + 7] = { 0 };
+	uint8_t septets[256 + 8];
+	unsigned int num_septets = (maxlen + 6) / 7 * 8;
 
 	OSMO_ASSERT (n > 0);
 
@@ -223,24 +307,14 @@ int gsm_7bit_decode_n_hdr(char *text, size_t n, const uint8_t *user_data, uint8_
 		septet_l = septet_l - shift;
 	}
 
-	unsigned i, l, r;
-	for (i = 0; i < septet_l && text != text_buf_end - 1; i++) {
+	/* octets beyond maxlen are never read, but treated as 0 */
+	memcpy(octets, user_data, maxlen);
+	unsigned i;
+	for (i = 0; i < num_septets; i += 8)
+		gsm_septets_unpack8(septets + i, octets + i / 8 * 7);
 
-		l = ((i + shift) * 7 + 7) >> 3;
-		r = ((i + shift) * 7) >> 3;
-
-		/* the left side index is always >= right side index
-		sometimes it even gets beyond array boundary
-		check for that explicitly and force 0 instead
-		 */
-		if (l >= maxlen)
-			lu = 0;
-		else
-			lu = user_data[l] << (7 - (((i + shift) * 7 + 7) & 7));
-
-		ru = user_data[r] >> (((i + shift) * 7) & 7);
-
-		c7 = (lu | ru) & 0x7f;
+	for (i = 0; i < septet_l && text != text_buf_end - 1; i++) {
+		c7 = i + shift < num_septets ? septets[i + shift] : 0;
 
 		if (next_is_ext) {
 			/* this is an extension character */
@@ -250,7 +324,7 @@ int gsm_7bit_decode_n_hdr(char *text, size_t n, const uint8_t *user_data, uint8_
 			next_is_ext = 1;
 			continue;
 		} else {
-			c8 = gsm_septet_lookup(c7);
+			c8 = gsm_septet_alphabet[c7];
 		}
 
 		*(text++) = c8;
@@ -280,6 +354,25 @@ int gsm_7bit_decode_n_ussd(char *text, size_t n, const uint8_t *user_data, uint8
 	return nchars;
 }
 
+/* characters which are encoded as escape (0x1b) + extension character */
+static inline bool gsm_7bit_is_ext(uint8_t ch)
+{
+	switch (ch) {
+	case 0x0c:
+	case 0x5e:
+	case 0x7b:
+	case 0x7d:
+	case 0x5c:
+	case 0x5b:
+	case 0x7e:
+	case 0x5d:
+	case 0x7c:
+		return true;
+	default:
+		return false;
+	}
+}
+
 /*! Encode a ASCII characterrs as 7-bit GSM alphabet (TS 03.38)
  *
  *  This function converts a zero-terminated input string \a data from
@@ -291,28 +384,13 @@ int gsm_7bit_decode_n_ussd(char *text, size_t n, const uint8_t *user_data, uint8
  *  \returns number of octets used in \a result */
 int gsm_septet_encode(uint8_t *result, const char *data)
 {
-	int i, y = 0;
+	int y = 0;
 	uint8_t ch;
-	for (i = 0; i < strlen(data); i++) {
-		ch = data[i];
-		switch(ch){
-		/* fall-through for extension characters */
-		case 0x0c:
-		case 0x5e:
-		case 0x7b:
-		case 0x7d:
-		case 0x5c:
-		case 0x5b:
-		case 0x7e:
-		case 0x5d:
-		case 0x7c:
+
+	for (; (ch = *data); data++) {
+		if (gsm_7bit_is_ext(ch))
 			result[y++] = 0x1b;
-		/* fall-through */
-		default:
-			result[y] = gsm_7bit_alphabet[ch];
-			break;
-		}
-		y++;
+		result[y++] = gsm_7bit_alphabet[ch];
 	}
 
 	return y;
@@ -326,47 +404,14 @@ int gsm_septet_encode(uint8_t *result, const char *data)
  *  \returns number of bytes used in \a result */
 int gsm_septets2octets(uint8_t *result, const uint8_t *rdata, uint8_t septet_len, uint8_t padding)
 {
-	int i = 0, z = 0;
-	uint8_t cb, nb;
-	int shift = 0;
-	uint8_t *data = calloc(septet_len + 1, sizeof(uint8_t));
-
-	if (padding) {
-		shift = 7 - padding;
-		/* the first zero is needed for padding */
-		memcpy(data + 1, rdata, septet_len);
-		septet_len++;
-	} else
-		memcpy(data, rdata, septet_len);
-
-	for (i = 0; i < septet_len; i++) {
-		if (shift == 7) {
-			/*
-			 * special end case with the. This is necessary if the
-			 * last septet fits into the previous octet. E.g. 48
-			 * non-extension characters:
-			 *   ....ag ( a = 1100001, g = 1100111)
-			 * result[40] = 100001 XX, result[41] = 1100111 1 */
-			if (i + 1 < septet_len) {
-				shift = 0;
-				continue;
-			} else if (i + 1 == septet_len)
-				break;
-		}
-
-		cb = (data[i] & 0x7f) >> shift;
-		if (i + 1 < septet_len) {
-			nb = (data[i + 1] & 0x7f) << (7 - shift);
-			cb = cb | nb;
-		}
-
-		result[z++] = cb;
-		shift++;
-	}
+	struct gsm_septet_packer pk;
+	int i;
 
-	free(data);
+	gsm_septet_packer_init(&pk, result, padding);
+	for (i = 0; i < septet_len; i++)
+		gsm_septet_packer_put(&pk, rdata[i]);
 
-	return z;
+	return gsm_septet_packer_finish(&pk) - result;
 }
 
 /*! GSM 7-bit alphabet TS 03.38 6.2.1 Character packing
@@ -377,28 +422,28 @@ int gsm_septets2octets(uint8_t *result, const uint8_t *rdata, uint8_t septet_len
  *  \returns number of septets encoded */
 int gsm_7bit_encode_n(uint8_t *result, size_t n, const char *data, int *octets)
 {
-	int y = 0;
-	int o;
+	struct gsm_septet_packer pk;
+	size_t y = 0;
 	size_t max_septets = n * 8 / 7;
+	uint8_t ch;
 
-	/* prepare for the worst case, every character expanding to two bytes */
-	uint8_t *rdata = calloc(strlen(data) * 2, sizeof(uint8_t));
-	y = gsm_septet_encode(rdata, data);
-
-	if (y > max_septets) {
-		/*
-		 * Limit the number of septets to avoid the generation
-		 * of more than n octets.
-		 */
-		y = max_septets;
+	/* translate and pack in one go, limiting the number of septets to
+	 * avoid the generation of more than n octets */
+	gsm_septet_packer_init(&pk, result, 0);
+	for (; (ch = *data) && y < max_septets; data++) {
+		if (gsm_7bit_is_ext(ch)) {
+			gsm_septet_packer_put(&pk, 0x1b);
+			if (++y == max_septets)
+				break;
+		}
+		gsm_septet_packer_put(&pk, gsm_7bit_alphabet[ch]);
+		y++;
 	}
 
-	o = gsm_septets2octets(result, rdata, y, 0);
-
 	if (octets)
-		*octets = o;
-
-	free(rdata);
+		*octets = gsm_septet_packer_finish(&pk) - result;
+	else
+		gsm_septet_packer_finish(&pk);
 
 	/*
 	 * We don't care about the number of octets, because they are not
@@ -437,21 +482,67 @@ int gsm_7bit_encode_n_ussd(uint8_t *result, size_t n, const char *data, int *oct
 	return y;
 }
 
-/*! Generate random identifier
- *  We use /dev/urandom (default when GRND_RANDOM flag is not set).
- *  Both /dev/(u)random numbers are coming from the same CSPRNG anyway (at least on GNU/Linux >= 4.8).
- *  See also RFC4086.
- *  \param[out] out Buffer to be filled with random data
- *  \param[in] len Number of random bytes required
- *  \returns 0 on success, or a negative error code on error.
- */
-int osmo_get_rand_id(uint8_t *out, size_t len)
+/*! Count the septets needed to encode a string in the GSM 7-bit alphabet
+ *  \param[in] data zero-terminated input string, latin1
+ *  \returns number of septets (including escapes) or -1 if \a data contains
+ *	     characters that are not part of the GSM 7-bit alphabet, in which
+ *	     case it needs to be sent as UCS2 */
+int gsm_septet_count(const char *data)
+{
+	int y = 0;
+	uint8_t ch;
+
+	for (; (ch = *data); data++) {
+		if (gsm_7bit_alphabet[ch] == 0xff)
+			return -1;
+		y += gsm_7bit_is_ext(ch) ? 2 : 1;
+	}
+
+	return y;
+}
+
+/*! Encode a latin1 string as UCS2 (big endian, TS 03.38 Section 5)
+ *  \param[out] result Caller-provided output buffer
+ *  \param[in] n Maximum length of \a result in bytes
+ *  \param[in] data zero-terminated input string, latin1
+ *  \returns number of bytes written to \a result */
+int gsm_ucs2_encode_n(uint8_t *result, size_t n, const char *data)
+{
+	size_t y = 0;
+
+	for (; *data && y + 2 <= n; data++) {
+		result[y++] = 0;
+		result[y++] = (uint8_t)*data;
+	}
+
+	return y;
+}
+
+/*! Decode UCS2 (big endian, TS 03.38 Section 5) to a latin1 string
+ *  Characters outside of latin1 are replaced by '?'.
+ *  \param[out] text Caller-provided output text buffer
+ *  \param[in] n Length of \a text, requires n >= 1
+ *  \param[in] ucs2 UCS2 encoded input data
+ *  \param[in] len Length of \a ucs2 in bytes
+ *  \returns number of bytes written to \a text, excluding the terminating \0 */
+int gsm_ucs2_decode_n(char *text, size_t n, const uint8_t *ucs2, size_t len)
+{
+	size_t i, y = 0;
+
+	OSMO_ASSERT(n > 0);
+
+	for (i = 0; i + 1 < len && y < n - 1; i += 2)
+		text[y++] = ucs2[i] ? '?' : ucs2[i + 1];
+	text[y] = '\0';
+
+	return y;
+}
+
+/* Read random data from the operating system (or GnuTLS as fallback), len <= 256 */
+static int rand_from_os(uint8_t *out, size_t len)
 {
 	int rc = -ENOTSUP;
 
-	/* this function is intended for generating short identifiers only, not arbitrary-length random data */
-	if (len > OSMO_MAX_RAND_ID_LEN)
-               return -E2BIG;
 #if (!EMBEDDED)
 #ifdef HAVE_GLIBC_GETRANDOM
 	rc = getrandom(out, len, GRND_NONBLOCK);
@@ -472,7 +563,7 @@ int osmo_get_rand_id(uint8_t *out, size_t len)
 	}
 
 	/* getrandom() failed partially due to signal interruption:
-	   this should never happen (according to getrandom(2)) as long as OSMO_MAX_RAND_ID_LEN < 256
+	   this should never happen (according to getrandom(2)) as long as len <= 256
 	   because we do not set GRND_RANDOM but it's better to be paranoid and check anyway */
 	if (rc != len)
                return -EAGAIN;
@@ -480,6 +571,176 @@ int osmo_get_rand_id(uint8_t *out, size_t len)
 	return 0;
 }
 
+/* Random identifiers are served from a per-thread ChaCha20 keystream (RFC 8439)
+ * instead of doing a system call for each of them.  After each refill of the
+ * buffer, the key is replaced by the first block of the new keystream and used
+ * bytes are wiped ("fast key erasure"), so that earlier output cannot be
+ * recovered from the state.  The key is mixed with fresh data from the operating
+ * system every RAND_DRBG_RESEED_BYTES, and replaced entirely after fork(). */
+#define RAND_DRBG_BLOCKS	8
+#define RAND_DRBG_KEY_LEN	32
+#define RAND_DRBG_RESEED_BYTES	(1024 * 1024)
+
+struct rand_drbg {
+	uint32_t key[8];
+	uint8_t buf[RAND_DRBG_BLOCKS * 64];
+	/* position of the next unused byte in buf */
+	unsigned int pos;
+	/* bytes generated since the last reseed */
+	unsigned int generated;
+	/* value of rand_drbg_fork_gen at the time of seeding */
+	unsigned int fork_gen;
+	bool seeded;
+};
+
+static __thread struct rand_drbg rand_drbg;
+/* incremented in the child after each fork() */
+static volatile unsigned int rand_drbg_fork_gen;
+
+#define CHACHA_QR(a, b, c, d) do {				\
+		a += b; d ^= a; d = (d << 16) | (d >> 16);	\
+		c += d; b ^= c; b = (b << 12) | (b >> 20);	\
+		a += b; d ^= a; d = (d << 8) | (d >> 24);	\
+		c += d; b ^= c; b = (b << 7) | (b >> 25);	\
+	} while (0)
+
+/* Generate nblocks blocks of ChaCha20 keystream with an all zero nonce */
+static void chacha20_blocks(uint8_t *out, const uint32_t *key, unsigned int nblocks)
+{
+	uint32_t in[16] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+	uint32_t x[16];
+	unsigned int b, i;
+
+	memcpy(&in[4], key, RAND_DRBG_KEY_LEN);
+	for (b = 0; b < nblocks; b++, out += 64) {
+		in[12] = b;
+		memcpy(x, in, sizeof(x));
+		for (i = 0; i < 10; i++) {
+			CHACHA_QR(x[0], x[4], x[8], x[12]);
+			CHACHA_QR(x[1], x[5], x[9], x[13]);
+			CHACHA_QR(x[2], x[6], x[10], x[14]);
+			CHACHA_QR(x[3], x[7], x[11], x[15]);
+			CHACHA_QR(x[0], x[5], x[10], x[15]);
+			CHACHA_QR(x[1], x[6], x[11], x[12]);
+			CHACHA_QR(x[2], x[7], x[8], x[13]);
+			CHACHA_QR(x[3], x[4], x[9], x[14]);
+		}
+		for (i = 0; i < 16; i++)
+			osmo_store32le(x[i] + in[i], out + i * 4);
+	}
+}
+
+/* Mix fresh random data from the operating system into the key, replacing it
+ * entirely if the state is not (or no longer) valid */
+static int rand_drbg_reseed(struct rand_drbg *st)
+{
+	uint8_t seed[RAND_DRBG_KEY_LEN];
+	unsigned int i;
+	int rc;
+
+	rc = rand_from_os(seed, sizeof(seed));
+	if (rc < 0)
+		return rc;
+
+	if (!st->seeded || st->fork_gen != rand_drbg_fork_gen)
+		memset(st->key, 0, sizeof(st->key));
+	for (i = 0; i < ARRAY_SIZE(st->key); i++)
+		st->key[i] ^= osmo_load32le(seed + i * 4);
+	memset(seed, 0, sizeof(seed));
+
+	st->pos = sizeof(st->buf);
+	st->generated = 0;
+	st->fork_gen = rand_drbg_fork_gen;
+	st->seeded = true;
+	return 0;
+}
+
+static void rand_drbg_refill(struct rand_drbg *st)
+{
+	unsigned int i;
+
+	chacha20_blocks(st->buf, st->key, RAND_DRBG_BLOCKS);
+	for (i = 0; i < ARRAY_SIZE(st->key); i++)
+		st->key[i] = osmo_load32le(st->buf + i * 4);
+	memset(st->buf, 0, RAND_DRBG_KEY_LEN);
+	st->pos = RAND_DRBG_KEY_LEN;
+}
+
+static int rand_drbg_generate(uint8_t *out, size_t len)
+{
+	struct rand_drbg *st = &rand_drbg;
+	size_t chunk;
+	int rc;
+
+	if (!st->seeded || st->fork_gen != rand_drbg_fork_gen) {
+		rc = rand_drbg_reseed(st);
+		if (rc < 0)
+			return rc;
+	}
+
+	while (len) {
+		if (st->pos == sizeof(st->buf)) {
+			/* keep on using the current key if the reseed fails, it is retried
+			 * with the next refill */
+			if (st->generated >= RAND_DRBG_RESEED_BYTES)
+				rand_drbg_reseed(st);
+			rand_drbg_refill(st);
+		}
+		chunk = OSMO_MIN(len, sizeof(st->buf) - st->pos);
+		memcpy(out, st->buf + st->pos, chunk);
+		memset(st->buf + st->pos, 0, chunk);
+		st->pos += chunk;
+		st->generated += chunk;
+		out += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+#if (!EMBEDDED)
+static void rand_drbg_atfork_child(void)
+{
+	rand_drbg_fork_gen++;
+}
+
+static __attribute__((constructor)) void on_dso_load_rand_drbg(void)
+{
+	pthread_atfork(NULL, NULL, rand_drbg_atfork_child);
+}
+#endif /* !EMBEDDED */
+
+/*! Generate random identifier
+ *  The identifiers are taken from a per-thread ChaCha20 based generator, which
+ *  is seeded and periodically reseeded from /dev/urandom (default when
+ *  GRND_RANDOM flag is not set) and reseeded in the child after fork().
+ *  Both /dev/(u)random numbers are coming from the same CSPRNG anyway (at least on GNU/Linux >= 4.8).
+ *  See also RFC4086.
+ *  \param[out] out Buffer to be filled with random data
+ *  \param[in] len Number of random bytes required
+ *  \returns 0 on success, or a negative error code on error.
+ */
+int osmo_get_rand_id(uint8_t *out, size_t len)
+{
+	/* this function is intended for generating short identifiers only, not arbitrary-length random data */
+	if (len > OSMO_MAX_RAND_ID_LEN)
+               return -E2BIG;
+
+	return rand_drbg_generate(out, len);
+}
+
+/*! Generate an arbitrary amount of random data
+ *  Like osmo_get_rand_id(), but without length limit, e.g. to generate many
+ *  RANDs for authentication vectors at once.
+ *  \param[out] out Buffer to be filled with random data
+ *  \param[in] len Number of random bytes required
+ *  \returns 0 on success, or a negative error code on error.
+ */
+int osmo_get_rand(uint8_t *out, size_t len)
+{
+	return rand_drbg_generate(out, len);
+}
+
 /*! Build the RSL uplink measurement IE (3GPP TS 08.58 § 9.3.25)
  *  \param[in] mru Unidirectional measurement report structure
  *  \param[in] dtxd_used Indicates if DTXd was used during measurement report
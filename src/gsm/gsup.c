@@ -914,4 +914,9 @@ const struct value_string osmo_gsup_message_class_names[] = {
 	{}
 };
 
+static __attribute__((constructor)) void on_dso_load_gsup(void)
+{
+	value_string_index(osmo_gsup_message_type_names);
+}
+
 /*! @} */
@@ -57,69 +57,76 @@ static bool osmo_i460_has_single_64k_schan(struct osmo_i460_timeslot *ts)
  * Demultiplexer
  ***********************************************************************/
 
+/* unpacked bits of each possible input byte, LSB first */
+#define LSB_UBITS(x)	{ (x) & 1, ((x) >> 1) & 1, ((x) >> 2) & 1, ((x) >> 3) & 1, \
+			  ((x) >> 4) & 1, ((x) >> 5) & 1, ((x) >> 6) & 1, ((x) >> 7) & 1 }
+#define LSB_UBITS4(x)	LSB_UBITS(x), LSB_UBITS(x + 1), LSB_UBITS(x + 2), LSB_UBITS(x + 3)
+#define LSB_UBITS16(x)	LSB_UBITS4(x), LSB_UBITS4(x + 4), LSB_UBITS4(x + 8), LSB_UBITS4(x + 12)
+#define LSB_UBITS64(x)	LSB_UBITS16(x), LSB_UBITS16(x + 16), LSB_UBITS16(x + 32), LSB_UBITS16(x + 48)
+static const ubit_t lsb_ubits[256][8] = {
+	LSB_UBITS64(0), LSB_UBITS64(64), LSB_UBITS64(128), LSB_UBITS64(192)
+};
+
+/* number of bits per B-channel byte occupied by a sub-channel of the given rate */
+static const uint8_t rate_num_bits[] = {
+	[OSMO_I460_RATE_NONE]	= 0,
+	[OSMO_I460_RATE_64k]	= 8,
+	[OSMO_I460_RATE_32k]	= 4,
+	[OSMO_I460_RATE_16k]	= 2,
+	[OSMO_I460_RATE_8k]	= 1,
+};
+
+/* hand the (full) output buffer of a sub-channel to the user */
+static void demux_subchan_flush(struct osmo_i460_subchan *schan)
+{
+	struct osmo_i460_subchan_demux *demux = &schan->demux;
+
+	if (demux->out_cb_bits)
+		demux->out_cb_bits(demux->user_data, demux->out_bitbuf, demux->out_idx);
+	else {
+		/* pack bits into bytes */
+		OSMO_ASSERT((demux->out_idx % 8) == 0);
+		unsigned int num_bytes = demux->out_idx / 8;
+		uint8_t bytes[num_bytes];
+		osmo_ubit2pbit(bytes, demux->out_bitbuf, demux->out_idx);
+		demux->out_cb_bytes(demux->user_data, bytes, num_bytes);
+	}
+	demux->out_idx = 0;
+}
+
 /* append a single bit to a sub-channel */
 static void demux_subchan_append_bit(struct osmo_i460_subchan *schan, uint8_t bit)
 {
 	struct osmo_i460_subchan_demux *demux = &schan->demux;
 
-	OSMO_ASSERT(demux->out_bitbuf);
 	OSMO_ASSERT(demux->out_idx < demux->out_bitbuf_size);
 
 	demux->out_bitbuf[demux->out_idx++] = bit ? 1 : 0;
 
-	if (demux->out_idx >= demux->out_bitbuf_size) {
-		if (demux->out_cb_bits)
-			demux->out_cb_bits(demux->user_data, demux->out_bitbuf, demux->out_idx);
-		else {
-			/* pack bits into bytes */
-			OSMO_ASSERT((demux->out_idx % 8) == 0);
-			unsigned int num_bytes = demux->out_idx / 8;
-			uint8_t bytes[num_bytes];
-			osmo_ubit2pbit(bytes, demux->out_bitbuf, demux->out_idx);
-			demux->out_cb_bytes(demux->user_data, bytes, num_bytes);
-		}
-		demux->out_idx = 0;
-	}
+	if (demux->out_idx >= demux->out_bitbuf_size)
+		demux_subchan_flush(schan);
 }
 
-/* extract those bits relevant to this schan of each byte in 'data' */
-static void demux_subchan_extract_bits(struct osmo_i460_subchan *schan, const uint8_t *data, size_t data_len)
+/* append those bits of 'inbyte' relevant to this schan */
+static inline void demux_subchan_append_byte(struct osmo_i460_subchan *schan, uint8_t inbyte)
 {
-	int i;
-
-	for (i = 0; i < data_len; i++) {
-		uint8_t inbyte = data[i];
-		uint8_t inbits = inbyte >> schan->bit_offset;
-
-		/* extract the bits relevant to the given schan */
-		switch (schan->rate) {
-		case OSMO_I460_RATE_8k:
-			demux_subchan_append_bit(schan, inbits & 0x01);
-			break;
-		case OSMO_I460_RATE_16k:
-			demux_subchan_append_bit(schan, inbits & 0x01);
-			demux_subchan_append_bit(schan, inbits & 0x02);
-			break;
-		case OSMO_I460_RATE_32k:
-			demux_subchan_append_bit(schan, inbits & 0x01);
-			demux_subchan_append_bit(schan, inbits & 0x02);
-			demux_subchan_append_bit(schan, inbits & 0x04);
-			demux_subchan_append_bit(schan, inbits & 0x08);
-			break;
-		case OSMO_I460_RATE_64k:
-			demux_subchan_append_bit(schan, inbits & 0x01);
-			demux_subchan_append_bit(schan, inbits & 0x02);
-			demux_subchan_append_bit(schan, inbits & 0x04);
-			demux_subchan_append_bit(schan, inbits & 0x08);
-			demux_subchan_append_bit(schan, inbits & 0x10);
-			demux_subchan_append_bit(schan, inbits & 0x20);
-			demux_subchan_append_bit(schan, inbits & 0x40);
-			demux_subchan_append_bit(schan, inbits & 0x80);
-			break;
-		default:
-			OSMO_ASSERT(0);
-		}
+	struct osmo_i460_subchan_demux *demux = &schan->demux;
+	unsigned int num_bits = rate_num_bits[schan->rate];
+	const ubit_t *bits = lsb_ubits[(uint8_t)(inbyte >> schan->bit_offset)];
+	unsigned int i;
+
+	/* slow path if the output buffer fills up in the middle of this byte */
+	if (demux->out_idx + num_bits > demux->out_bitbuf_size) {
+		for (i = 0; i < num_bits; i++)
+			demux_subchan_append_bit(schan, bits[i]);
+		return;
 	}
+
+	memcpy(demux->out_bitbuf + demux->out_idx, bits, num_bits);
+	demux->out_idx += num_bits;
+
+	if (demux->out_idx >= demux->out_bitbuf_size)
+		demux_subchan_flush(schan);
 }
 
 /*! Data from E1 timeslot into de-multiplexer
@@ -128,9 +135,11 @@ static void demux_subchan_extract_bits(struct osmo_i460_subchan *schan, const ui
  *  \param[in] data_len length of data in bytes */
 void osmo_i460_demux_in(struct osmo_i460_timeslot *ts, const uint8_t *data, size_t data_len)
 {
+	struct osmo_i460_subchan *active[ARRAY_SIZE(ts->schan)];
+	unsigned int num_active = 0;
 	struct osmo_i460_subchan *schan;
 	struct osmo_i460_subchan_demux *demux;
-	int i;
+	int i, j;
 
 	/* fast path if entire 64k slot is used */
 	if (osmo_i460_has_single_64k_schan(ts)) {
@@ -146,12 +155,18 @@ void osmo_i460_demux_in(struct osmo_i460_timeslot *ts, const uint8_t *data, size
 		return;
 	}
 
-	/* Slow path iterating over all lchans */
 	for (i = 0; i < ARRAY_SIZE(ts->schan); i++) {
 		schan = &ts->schan[i];
 		if (schan->rate == OSMO_I460_RATE_NONE)
 			continue;
-		demux_subchan_extract_bits(schan, data, data_len);
+		OSMO_ASSERT(schan->demux.out_bitbuf);
+		active[num_active++] = schan;
+	}
+
+	/* single pass over the input, splitting each byte into all active sub-channels */
+	for (i = 0; i < data_len; i++) {
+		for (j = 0; j < num_active; j++)
+			demux_subchan_append_byte(active[j], data[i]);
 	}
 }
 
@@ -196,41 +211,36 @@ static ubit_t mux_schan_provide_bit(struct osmo_i460_subchan *schan)
  *  \returns bits of given sub-channel */
 static uint8_t mux_subchan_provide_bits(struct osmo_i460_subchan *schan, uint8_t *mask)
 {
+	struct osmo_i460_subchan_mux *mux = &schan->mux;
+	unsigned int num_bits = rate_num_bits[schan->rate];
 	uint8_t outbits = 0;
-	uint8_t outmask;
-
-	switch (schan->rate) {
-	case OSMO_I460_RATE_8k:
-		outbits = mux_schan_provide_bit(schan);
-		outmask = 0x01;
-		break;
-	case OSMO_I460_RATE_16k:
-		outbits |= mux_schan_provide_bit(schan) << 1;
-		outbits |= mux_schan_provide_bit(schan) << 0;
-		outmask = 0x03;
-		break;
-	case OSMO_I460_RATE_32k:
-		outbits |= mux_schan_provide_bit(schan) << 3;
-		outbits |= mux_schan_provide_bit(schan) << 2;
-		outbits |= mux_schan_provide_bit(schan) << 1;
-		outbits |= mux_schan_provide_bit(schan) << 0;
-		outmask = 0x0F;
-		break;
-	case OSMO_I460_RATE_64k:
-		outbits |= mux_schan_provide_bit(schan) << 7;
-		outbits |= mux_schan_provide_bit(schan) << 6;
-		outbits |= mux_schan_provide_bit(schan) << 5;
-		outbits |= mux_schan_provide_bit(schan) << 4;
-		outbits |= mux_schan_provide_bit(schan) << 3;
-		outbits |= mux_schan_provide_bit(schan) << 2;
-		outbits |= mux_schan_provide_bit(schan) << 1;
-		outbits |= mux_schan_provide_bit(schan) << 0;
-		outmask = 0xFF;
-		break;
-	default:
-		OSMO_ASSERT(0);
+	struct msgb *msg;
+	unsigned int i;
+
+	OSMO_ASSERT(num_bits);
+
+	if (llist_empty(&mux->tx_queue)) {
+		/* if we don't have anything to transmit, return '1' bits */
+		outbits = 0xff >> (8 - num_bits);
+	} else {
+		msg = llist_entry(mux->tx_queue.next, struct msgb, list);
+		if (msgb_length(msg) >= num_bits) {
+			/* fast path: all bits for this byte are in the first msgb */
+			const ubit_t *bits = msgb_data(msg);
+			for (i = 0; i < num_bits; i++)
+				outbits |= bits[i] << (num_bits - 1 - i);
+			msgb_pull(msg, num_bits);
+			if (msgb_length(msg) <= 0) {
+				llist_del(&msg->list);
+				talloc_free(msg);
+			}
+		} else {
+			for (i = 0; i < num_bits; i++)
+				outbits |= mux_schan_provide_bit(schan) << (num_bits - 1 - i);
+		}
 	}
-	*mask = outmask << schan->bit_offset;
+
+	*mask = (0xff >> (8 - num_bits)) << schan->bit_offset;
 	return outbits << schan->bit_offset;
 }
 
@@ -85,6 +85,8 @@
 #include <osmocom/gsm/lapd_core.h>
 #include <osmocom/gsm/rsl.h>
 
+#include "../usdt.h"
+
 /* TS 04.06 Table 4 / Section 3.8.1 */
 #define LAPD_U_SABM	0x7
 #define LAPD_U_SABME	0xf
@@ -128,6 +130,14 @@ static inline uint8_t do_mod(uint8_t x, uint8_t m)
 	return x & (m - 1);
 }
 
+/* hand a frame to the physical layer */
+static inline int lapd_send_ph_data_req(struct lapd_datalink *dl, struct lapd_msg_ctx *nctx,
+					struct msgb *msg)
+{
+	OSMO_TRACE3(lapd_tx, dl, nctx->sapi, msgb_length(msg));
+	return dl->send_ph_data_req(nctx, msg);
+}
+
 static inline uint8_t inc_mod(uint8_t x, uint8_t m)
 {
 	return (x + 1) & (m - 1);
@@ -449,7 +459,7 @@ static int lapd_send_ua(struct lapd_msg_ctx *lctx, uint8_t len, uint8_t *data)
 	nctx.length = len;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* send DM response */
@@ -470,7 +480,7 @@ static int lapd_send_dm(struct lapd_msg_ctx *lctx)
 	nctx.length = 0;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* send RR response / command */
@@ -492,7 +502,7 @@ static int lapd_send_rr(struct lapd_msg_ctx *lctx, uint8_t f_bit, uint8_t cmd)
 	nctx.length = 0;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* send RNR response / command */
@@ -514,7 +524,7 @@ static int lapd_send_rnr(struct lapd_msg_ctx *lctx, uint8_t f_bit, uint8_t cmd)
 	nctx.length = 0;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* send REJ response */
@@ -536,7 +546,7 @@ static int lapd_send_rej(struct lapd_msg_ctx *lctx, uint8_t f_bit)
 	nctx.length = 0;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* resend SABM or DISC message */
@@ -568,7 +578,7 @@ static int lapd_send_resend(struct lapd_datalink *dl)
 	if (length)
 		memcpy(msg->l3h, dl->tx_hist[h].msg->data, length);
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* reestablish link */
@@ -675,7 +685,7 @@ static void lapd_t200_cb(void *data)
 				msg->l3h = msgb_put(msg, length);
 				memcpy(msg->l3h, dl->tx_hist[h].msg->data,
 					length);
-				dl->send_ph_data_req(&nctx, msg);
+				lapd_send_ph_data_req(dl, &nctx, msg);
 			} else {
 			/* OR send appropriate supervision frame with P=1 */
 				if (!dl->own_busy && !dl->seq_err_cond) {
@@ -1631,6 +1641,8 @@ int lapd_ph_data_ind(struct msgb *msg, struct lapd_msg_ctx *lctx)
 {
 	int rc;
 
+	OSMO_TRACE4(lapd_rx, lctx->dl, lctx->sapi, lctx->format, msgb_length(msg));
+
 	switch (lctx->format) {
 	case LAPD_FORM_U:
 		rc = lapd_rx_u(msg, lctx);
@@ -1669,7 +1681,7 @@ static int lapd_udata_req(struct osmo_dlsap_prim *dp, struct lapd_msg_ctx *lctx)
 	nctx.length = msg->len;
 	nctx.more = 0;
 
-	return dl->send_ph_data_req(&nctx, msg);
+	return lapd_send_ph_data_req(dl, &nctx, msg);
 }
 
 /* request link establishment */
@@ -1724,7 +1736,7 @@ static int lapd_est_req(struct osmo_dlsap_prim *dp, struct lapd_msg_ctx *lctx)
 	lapd_dl_newstate(dl, LAPD_STATE_SABM_SENT);
 
 	/* Tramsmit and start T200 */
-	dl->send_ph_data_req(&nctx, msg);
+	lapd_send_ph_data_req(dl, &nctx, msg);
 	lapd_start_t200(dl);
 
 	return 0;
@@ -1891,7 +1903,7 @@ static int lapd_send_i(struct lapd_msg_ctx *lctx, int line)
 		lapd_start_t200(dl);
 	}
 
-	dl->send_ph_data_req(&nctx, msg);
+	lapd_send_ph_data_req(dl, &nctx, msg);
 
 	rc = 0; /* we sent something */
 	goto next_frame;
@@ -1986,7 +1998,7 @@ static int lapd_res_req(struct osmo_dlsap_prim *dp, struct lapd_msg_ctx *lctx)
 	lapd_dl_newstate(dl, LAPD_STATE_SABM_SENT);
 
 	/* Tramsmit and start T200 */
-	dl->send_ph_data_req(&nctx, msg);
+	lapd_send_ph_data_req(dl, &nctx, msg);
 	lapd_start_t200(dl);
 
 	return 0;
@@ -2050,7 +2062,7 @@ static int lapd_rel_req(struct osmo_dlsap_prim *dp, struct lapd_msg_ctx *lctx)
 	lapd_dl_newstate(dl, LAPD_STATE_DISC_SENT);
 
 	/* Tramsmit and start T200 */
-	dl->send_ph_data_req(&nctx, msg);
+	lapd_send_ph_data_req(dl, &nctx, msg);
 	lapd_start_t200(dl);
 
 	return 0;
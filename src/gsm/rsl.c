@@ -631,4 +631,12 @@ const struct value_string rsl_act_type_names[] = {
 	{ 0, NULL }
 };
 
+static __attribute__((constructor)) void on_dso_load_rsl(void)
+{
+	value_string_index(rsl_err_vals);
+	value_string_index(rsl_msgt_names);
+	value_string_index(rsl_ipac_msgt_names);
+	value_string_index(rsl_rlm_cause_strs);
+}
+
 /*! @} */
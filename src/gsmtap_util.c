@@ -23,16 +23,21 @@
  *
  */
 
+#define _GNU_SOURCE
 #include "../config.h"
 
 #include <osmocom/core/gsmtap_util.h>
 #include <osmocom/core/logging.h>
 #include <osmocom/core/gsmtap.h>
 #include <osmocom/core/msgb.h>
+#include <osmocom/core/pcapng.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/select.h>
 #include <osmocom/core/socket.h>
 #include <osmocom/core/byteswap.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/stats.h>
+#include <osmocom/core/utils.h>
 #include <osmocom/gsm/protocol/gsm_04_08.h>
 #include <osmocom/gsm/rsl.h>
 
@@ -158,6 +163,23 @@ void chantype_gsmtap2rsl(uint8_t gsmtap_chantype, uint8_t *rsl_chantype,
 	*link_id = gsmtap_chantype & GSMTAP_CHANNEL_ACCH ? 0x40 : 0x00;
 }
 
+static void gsmtap_fill_hdr(struct gsmtap_hdr *gh, uint8_t type, uint16_t arfcn, uint8_t ts,
+			    uint8_t chan_type, uint8_t ss, uint32_t fn, int8_t signal_dbm,
+			    uint8_t snr)
+{
+	gh->version = GSMTAP_VERSION;
+	gh->hdr_len = sizeof(*gh)/4;
+	gh->type = type;
+	gh->timeslot = ts;
+	gh->sub_slot = ss;
+	gh->arfcn = osmo_htons(arfcn);
+	gh->snr_db = snr;
+	gh->signal_dbm = signal_dbm;
+	gh->frame_number = osmo_htonl(fn);
+	gh->sub_type = chan_type;
+	gh->antenna_nr = 0;
+}
+
 /*! create an arbitrary type GSMTAP message
  *  \param[in] type The GSMTAP_TYPE_xxx constant of the message to create
  *  \param[in] arfcn GSM ARFCN (Channel Number)
@@ -181,7 +203,6 @@ struct msgb *gsmtap_makemsg_ex(uint8_t type, uint16_t arfcn, uint8_t ts, uint8_t
 {
 	struct msgb *msg;
 	struct gsmtap_hdr *gh;
-	uint8_t *dst;
 
 	if (chan_type == GSMTAP_CHANNEL_UNKNOWN)
 		return NULL;
@@ -190,22 +211,9 @@ struct msgb *gsmtap_makemsg_ex(uint8_t type, uint16_t arfcn, uint8_t ts, uint8_t
 	if (!msg)
 		return NULL;
 
-	gh = (struct gsmtap_hdr *) msgb_put(msg, sizeof(*gh));
-
-	gh->version = GSMTAP_VERSION;
-	gh->hdr_len = sizeof(*gh)/4;
-	gh->type = type;
-	gh->timeslot = ts;
-	gh->sub_slot = ss;
-	gh->arfcn = osmo_htons(arfcn);
-	gh->snr_db = snr;
-	gh->signal_dbm = signal_dbm;
-	gh->frame_number = osmo_htonl(fn);
-	gh->sub_type = chan_type;
-	gh->antenna_nr = 0;
-
-	dst = msgb_put(msg, len);
-	memcpy(dst, data, len);
+	gh = (struct gsmtap_hdr *) msgb_put(msg, sizeof(*gh) + len);
+	gsmtap_fill_hdr(gh, type, arfcn, ts, chan_type, ss, fn, signal_dbm, snr);
+	memcpy(gh + 1, data, len);
 
 	return msg;
 }
@@ -236,6 +244,7 @@ struct msgb *gsmtap_makemsg(uint16_t arfcn, uint8_t ts, uint8_t chan_type,
 #ifdef HAVE_SYS_SOCKET_H
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
 /*! Create a new (sending) GSMTAP source socket 
@@ -293,6 +302,202 @@ int gsmtap_source_add_sink_fd(int gsmtap_fd)
 	return -ENODEV;
 }
 
+static const struct rate_ctr_desc gsmtap_ring_ctr_description[] = {
+	[GSMTAP_RING_CTR_ENQUEUED]	= { "enqueued",		"Messages put into the ring" },
+	[GSMTAP_RING_CTR_SENT]		= { "sent",		"Messages sent from the ring" },
+	[GSMTAP_RING_CTR_DROP_FULL]	= { "drop:full",	"Messages dropped because the ring was full" },
+	[GSMTAP_RING_CTR_DROP_LEN]	= { "drop:length",	"Messages dropped because they exceeded the slot size" },
+	[GSMTAP_RING_CTR_FILTERED]	= { "filtered",		"Messages dropped by a filter rule" },
+	[GSMTAP_RING_CTR_SAMPLED]	= { "sampled",		"Messages skipped by a sampling rule" },
+	[GSMTAP_RING_CTR_TX_ERR]	= { "tx_err",		"Messages that could not be sent" },
+};
+
+static const struct rate_ctr_group_desc gsmtap_ring_ctrg_desc = {
+	.group_name_prefix = "gsmtap",
+	.group_description = "GSMTAP ring statistics",
+	.num_ctr = ARRAY_SIZE(gsmtap_ring_ctr_description),
+	.ctr_desc = gsmtap_ring_ctr_description,
+	.class_id = OSMO_STATS_CLASS_GLOBAL,
+};
+
+#define GSMTAP_RING_MAX_RULES	16
+/* maximum number of messages per sendmmsg() */
+#define GSMTAP_RING_BATCH	32
+
+struct gsmtap_ring_rule {
+	int type;
+	int arfcn;
+	unsigned int one_in_n;
+	unsigned int count;
+};
+
+/* Preallocated ring of fixed size slots.  Messages are added and sent from
+ * the same thread, so the free running head and tail indices need no
+ * locking. */
+struct gsmtap_ring {
+	uint8_t *slots;
+	uint16_t *len;
+	unsigned int num_slots;		/* power of 2 */
+	unsigned int slot_size;
+	unsigned int head;		/* next slot to fill */
+	unsigned int tail;		/* next slot to send */
+
+	struct gsmtap_ring_rule rules[GSMTAP_RING_MAX_RULES];
+	unsigned int num_rules;
+};
+
+/* returns the counter to increment if the message is to be skipped, or -1 */
+static int ring_check_rules(struct gsmtap_ring *ring, uint8_t type, uint16_t arfcn)
+{
+	unsigned int i;
+
+	arfcn &= GSMTAP_ARFCN_MASK;
+	for (i = 0; i < ring->num_rules; i++) {
+		struct gsmtap_ring_rule *rule = &ring->rules[i];
+
+		if ((rule->type >= 0 && rule->type != type) ||
+		    (rule->arfcn >= 0 && rule->arfcn != arfcn))
+			continue;
+		if (!rule->one_in_n)
+			return GSMTAP_RING_CTR_FILTERED;
+		if (rule->count++ % rule->one_in_n)
+			return GSMTAP_RING_CTR_SAMPLED;
+		return -1;
+	}
+	return -1;
+}
+
+/* returns the slot to fill with up to len bytes, or NULL if the message is dropped */
+static uint8_t *ring_slot_get(struct gsmtap_inst *gti, uint8_t type, uint16_t arfcn, unsigned int len)
+{
+	struct gsmtap_ring *ring = gti->ring;
+	int ctr;
+
+	ctr = ring_check_rules(ring, type, arfcn);
+	if (ctr >= 0) {
+		rate_ctr_inc(&gti->ctrg->ctr[ctr]);
+		return NULL;
+	}
+	if (len > ring->slot_size) {
+		rate_ctr_inc(&gti->ctrg->ctr[GSMTAP_RING_CTR_DROP_LEN]);
+		return NULL;
+	}
+	if (ring->head - ring->tail == ring->num_slots) {
+		rate_ctr_inc(&gti->ctrg->ctr[GSMTAP_RING_CTR_DROP_FULL]);
+		return NULL;
+	}
+	return ring->slots + (ring->head & (ring->num_slots - 1)) * ring->slot_size;
+}
+
+static void ring_slot_commit(struct gsmtap_inst *gti, unsigned int len)
+{
+	struct gsmtap_ring *ring = gti->ring;
+
+	ring->len[ring->head & (ring->num_slots - 1)] = len;
+	ring->head++;
+	rate_ctr_inc(&gti->ctrg->ctr[GSMTAP_RING_CTR_ENQUEUED]);
+	gti->wq.bfd.when |= OSMO_FD_WRITE;
+}
+
+/*! Send all messages queued in the ring of a GSMTAP instance
+ *  \param[in] gti GSMTAP instance created by gsmtap_source_init_ring()
+ *  \returns number of messages sent; negative in case of error
+ *
+ * This is called from the select loop whenever the socket is writable and
+ * the ring is not empty, so there is normally no need to call it directly. */
+int gsmtap_ring_flush(struct gsmtap_inst *gti)
+{
+	struct gsmtap_ring *ring;
+	int sent = 0;
+
+	if (!gti || !gti->ring)
+		return -ENODEV;
+	ring = gti->ring;
+
+	while (ring->tail != ring->head) {
+		unsigned int num = ring->head - ring->tail;
+		int rc;
+#ifdef HAVE_SENDMMSG
+		struct mmsghdr mmsg[GSMTAP_RING_BATCH];
+		struct iovec iov[GSMTAP_RING_BATCH];
+		unsigned int i;
+
+		if (num > GSMTAP_RING_BATCH)
+			num = GSMTAP_RING_BATCH;
+		/* a batch must not wrap around the end of the ring */
+		if (num > ring->num_slots - (ring->tail & (ring->num_slots - 1)))
+			num = ring->num_slots - (ring->tail & (ring->num_slots - 1));
+
+		memset(mmsg, 0, sizeof(mmsg[0]) * num);
+		for (i = 0; i < num; i++) {
+			unsigned int slot = (ring->tail + i) & (ring->num_slots - 1);
+			iov[i].iov_base = ring->slots + slot * ring->slot_size;
+			iov[i].iov_len = ring->len[slot];
+			mmsg[i].msg_hdr.msg_iov = &iov[i];
+			mmsg[i].msg_hdr.msg_iovlen = 1;
+		}
+		rc = sendmmsg(gsmtap_inst_fd(gti), mmsg, num, MSG_DONTWAIT);
+#else
+		unsigned int slot = ring->tail & (ring->num_slots - 1);
+
+		rc = send(gsmtap_inst_fd(gti), ring->slots + slot * ring->slot_size, ring->len[slot],
+			  MSG_DONTWAIT);
+		if (rc >= 0)
+			rc = 1;
+#endif
+		if (rc < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			/* e.g. ECONNREFUSED: drop the message and go on */
+			rate_ctr_inc(&gti->ctrg->ctr[GSMTAP_RING_CTR_TX_ERR]);
+			rc = 1;
+		} else {
+			rate_ctr_add(&gti->ctrg->ctr[GSMTAP_RING_CTR_SENT], rc);
+			sent += rc;
+		}
+		ring->tail += rc;
+	}
+
+	if (ring->tail == ring->head)
+		gti->wq.bfd.when &= ~OSMO_FD_WRITE;
+	return sent;
+}
+
+/* Callback from select layer if we can write to the socket of a ring */
+static int gsmtap_ring_fd_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	if (what & OSMO_FD_WRITE)
+		gsmtap_ring_flush(ofd->data);
+	return 0;
+}
+
+/*! Add a filter or sampling rule to a GSMTAP instance with a ring
+ *  \param[in] gti GSMTAP instance created by gsmtap_source_init_ring()
+ *  \param[in] type GSMTAP_TYPE_* to match, or -1 for any type
+ *  \param[in] arfcn ARFCN (without flags) to match, or -1 for any ARFCN
+ *  \param[in] one_in_n send only every n-th matching message; 0 to drop all
+ *		matching messages, 1 to send all of them
+ *  \returns 0 on success; negative in case of error
+ *
+ * Rules are checked in the order they were added, the first matching rule
+ * applies.  Messages not matching any rule are sent. */
+int gsmtap_ring_add_rule(struct gsmtap_inst *gti, int type, int arfcn, unsigned int one_in_n)
+{
+	struct gsmtap_ring_rule *rule;
+
+	if (!gti || !gti->ring)
+		return -ENODEV;
+	if (gti->ring->num_rules >= ARRAY_SIZE(gti->ring->rules))
+		return -ENOSPC;
+
+	rule = &gti->ring->rules[gti->ring->num_rules++];
+	rule->type = type;
+	rule->arfcn = arfcn;
+	rule->one_in_n = one_in_n;
+	rule->count = 0;
+	return 0;
+}
+
 /*! Send a \ref msgb through a GSMTAP source
  *  \param[in] gti GSMTAP instance
  *  \param[in] msg message buffer
@@ -306,6 +511,35 @@ int gsmtap_sendmsg(struct gsmtap_inst *gti, struct msgb *msg)
 	if (!gti)
 		return -ENODEV;
 
+	if (gti->pcapng) {
+		const struct sockaddr_in sin = {
+			.sin_family = AF_INET,
+			.sin_port = osmo_htons(GSMTAP_UDP_PORT),
+			.sin_addr.s_addr = osmo_htonl(INADDR_LOOPBACK),
+		};
+
+		/* dropped messages are counted by the writer */
+		osmo_pcapng_write_udp4(gti->pcapng, &sin, &sin, msg->data, msg->len);
+		msgb_free(msg);
+		return 0;
+	}
+
+	if (gti->ring) {
+		const struct gsmtap_hdr *gh = (const struct gsmtap_hdr *) msg->data;
+		uint8_t *slot;
+
+		if (msg->len < sizeof(*gh))
+			return -EINVAL;
+		slot = ring_slot_get(gti, gh->type, osmo_ntohs(gh->arfcn), msg->len);
+		if (slot) {
+			memcpy(slot, msg->data, msg->len);
+			ring_slot_commit(gti, msg->len);
+		}
+		/* dropped messages are counted, not reported to the caller */
+		msgb_free(msg);
+		return 0;
+	}
+
 	if (gti->ofd_wq_mode)
 		return osmo_wqueue_enqueue(&gti->wq, msg);
 	else {
@@ -339,6 +573,21 @@ int gsmtap_send_ex(struct gsmtap_inst *gti, uint8_t type, uint16_t arfcn, uint8_
 	if (!gti)
 		return -ENODEV;
 
+	/* write directly into the ring, without a msgb */
+	if (gti->ring) {
+		struct gsmtap_hdr *gh;
+
+		if (chan_type == GSMTAP_CHANNEL_UNKNOWN)
+			return -ENOMEM;
+		gh = (struct gsmtap_hdr *) ring_slot_get(gti, type, arfcn, sizeof(*gh) + len);
+		if (gh) {
+			gsmtap_fill_hdr(gh, type, arfcn, ts, chan_type, ss, fn, signal_dbm, snr);
+			memcpy(gh + 1, data, len);
+			ring_slot_commit(gti, sizeof(*gh) + len);
+		}
+		return 0;
+	}
+
 	msg = gsmtap_makemsg_ex(type, arfcn, ts, chan_type, ss, fn, signal_dbm,
 			     snr, data, len);
 	if (!msg)
@@ -419,7 +668,7 @@ int gsmtap_source_add_sink(struct gsmtap_inst *gti)
 	if (fd < 0)
 		return fd;
 
-	if (gti->ofd_wq_mode) {
+	if (gti->ofd_wq_mode || gti->ring) {
 		struct osmo_fd *sink_ofd;
 
 		sink_ofd = &gti->sink_ofd;
@@ -478,6 +727,103 @@ struct gsmtap_inst *gsmtap_source_init(const char *host, uint16_t port,
 	return gti;
 }
 
+/*! Open GSMTAP source socket with a preallocated ring of messages
+ *  \param[in] host host name or IP address in string format
+ *  \param[in] port UDP port number in host byte order
+ *  \param[in] num_slots number of messages in the ring, rounded up to a power of 2
+ *  \param[in] slot_size maximum size of a message including the GSMTAP header
+ *  \return callee-allocated \ref gsmtap_inst
+ *
+ * Like gsmtap_source_init() in osmo_wqueue mode, but gsmtap_send_ex() and
+ * gsmtap_sendmsg() copy messages into the ring, which is sent in batches
+ * from the select loop.  No memory is allocated per message.  Messages
+ * that do not fit into the ring are dropped and counted in the \a ctrg
+ * of the instance.  See gsmtap_ring_add_rule() for filtering and sampling.
+ */
+struct gsmtap_inst *gsmtap_source_init_ring(const char *host, uint16_t port,
+					     unsigned int num_slots, unsigned int slot_size)
+{
+	static unsigned int ctrg_idx = 0;
+	struct gsmtap_inst *gti;
+	struct gsmtap_ring *ring;
+	int fd, rc;
+
+	if (!num_slots || num_slots > (1 << 20) || slot_size < sizeof(struct gsmtap_hdr) ||
+	    slot_size > UINT16_MAX)
+		return NULL;
+
+	fd = gsmtap_source_init_fd(host, port);
+	if (fd < 0)
+		return NULL;
+
+	gti = talloc_zero(NULL, struct gsmtap_inst);
+	if (!gti)
+		goto out_close;
+	gti->sink_ofd.fd = -1;
+	INIT_LLIST_HEAD(&gti->wq.msg_queue);
+
+	gti->ring = ring = talloc_zero(gti, struct gsmtap_ring);
+	if (!ring)
+		goto out_free;
+	ring->num_slots = 1;
+	while (ring->num_slots < num_slots)
+		ring->num_slots <<= 1;
+	ring->slot_size = slot_size;
+	ring->slots = talloc_size(ring, ring->num_slots * slot_size);
+	ring->len = talloc_array(ring, uint16_t, ring->num_slots);
+	gti->ctrg = rate_ctr_group_alloc(gti, &gsmtap_ring_ctrg_desc, ctrg_idx);
+	if (!ring->slots || !ring->len || !gti->ctrg)
+		goto out_free;
+	ctrg_idx++;
+
+	osmo_fd_setup(&gti->wq.bfd, fd, 0, gsmtap_ring_fd_cb, gti, 0);
+	rc = osmo_fd_register(&gti->wq.bfd);
+	if (rc < 0)
+		goto out_free;
+
+	return gti;
+
+out_free:
+	if (gti)
+		rate_ctr_group_free(gti->ctrg);
+	talloc_free(gti);
+out_close:
+	close(fd);
+	return NULL;
+}
+
+/*! Create a GSMTAP source that writes into PCAP-NG files instead of a socket
+ *  \param[in] path name of the capture file
+ *  \param[in] max_file_bytes rotate files at this size, see osmo_pcapng_writer_alloc()
+ *  \param[in] max_files number of files to keep, 0 for all
+ *  \return callee-allocated \ref gsmtap_inst
+ *
+ * Messages are captured as UDP datagrams from and to 127.0.0.1 port
+ * GSMTAP_UDP_PORT, so that they look like GSMTAP received from the network.
+ * The files are written by a background thread, see \ref pcapng.  The
+ * instance has no socket, so gsmtap_inst_fd() returns -1.
+ */
+struct gsmtap_inst *gsmtap_source_init_pcapng(const char *path, size_t max_file_bytes,
+					       unsigned int max_files)
+{
+	struct gsmtap_inst *gti;
+
+	gti = talloc_zero(NULL, struct gsmtap_inst);
+	if (!gti)
+		return NULL;
+	gti->wq.bfd.fd = -1;
+	gti->sink_ofd.fd = -1;
+	INIT_LLIST_HEAD(&gti->wq.msg_queue);
+
+	gti->pcapng = osmo_pcapng_writer_alloc(gti, path, max_file_bytes, max_files);
+	if (!gti->pcapng) {
+		talloc_free(gti);
+		return NULL;
+	}
+
+	return gti;
+}
+
 #endif /* HAVE_SYS_SOCKET_H */
 
 const struct value_string gsmtap_gsm_channel_names[] = {
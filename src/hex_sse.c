@@ -0,0 +1,152 @@
+/*! \file hex_sse.c
+ * Accelerated hexdump, hexdump with single character delimiter, hexparse
+ * and ubit dump
+ * for architectures with SSSE3 support. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+/* Convert 16 byte blocks to 32 lower case hex digits each.
+ * Returns the number of bytes converted, a multiple of 16. */
+size_t osmo_hex_enc_sse(char *out, const uint8_t *in, size_t len)
+{
+	const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+					  '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	const __m128i mask = _mm_set1_epi8(0x0f);
+	size_t i;
+
+	for (i = 0; i + 16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (in + i));
+		__m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+		__m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+
+		_mm_storeu_si128((__m128i *) (out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+
+	return i;
+}
+
+/* Convert 16 byte blocks to 48 characters each: two lower case hex digits
+ * followed by delim for every byte.  Returns the number of bytes converted, a
+ * multiple of 16. */
+size_t osmo_hex_enc_delim_sse(char *out, const uint8_t *in, size_t len, char delim)
+{
+	const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+					  '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	const __m128i mask = _mm_set1_epi8(0x0f);
+	/* positions of the digit pairs of bytes 0-7 (p0) and 8-15 (p1) in each
+	 * 16 character part of the output; -128 selects zero */
+	const __m128i p0_out0 = _mm_setr_epi8(0, 1, -128, 2, 3, -128, 4, 5, -128, 6, 7, -128, 8, 9, -128, 10);
+	const __m128i p0_out1 = _mm_setr_epi8(11, -128, 12, 13, -128, 14, 15, -128,
+					      -128, -128, -128, -128, -128, -128, -128, -128);
+	const __m128i p1_out1 = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+					      0, 1, -128, 2, 3, -128, 4, 5);
+	const __m128i p1_out2 = _mm_setr_epi8(-128, 6, 7, -128, 8, 9, -128, 10, 11, -128, 12, 13, -128, 14, 15, -128);
+	/* delim at the positions left zero above */
+	const __m128i d = _mm_set1_epi8(delim);
+	const __m128i d_out0 = _mm_and_si128(d, _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0));
+	const __m128i d_out1 = _mm_and_si128(d, _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0));
+	const __m128i d_out2 = _mm_and_si128(d, _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1));
+	size_t i;
+
+	for (i = 0; i + 16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (in + i));
+		__m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+		__m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+		__m128i p0 = _mm_unpacklo_epi8(hi, lo);
+		__m128i p1 = _mm_unpackhi_epi8(hi, lo);
+		char *o = out + 3 * i;
+
+		_mm_storeu_si128((__m128i *) o, _mm_or_si128(_mm_shuffle_epi8(p0, p0_out0), d_out0));
+		_mm_storeu_si128((__m128i *) (o + 16),
+				 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(p0, p0_out1), _mm_shuffle_epi8(p1, p1_out1)),
+					      d_out1));
+		_mm_storeu_si128((__m128i *) (o + 32), _mm_or_si128(_mm_shuffle_epi8(p1, p1_out2), d_out2));
+	}
+
+	return i;
+}
+
+/* Nibble values of 16 characters; all bits of *valid are set if they are all hex digits */
+static inline __m128i hex_dec_nibbles(__m128i c, int *valid)
+{
+	__m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+	__m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	__m128i is_d = _mm_and_si128(_mm_cmpgt_epi8(d, _mm_set1_epi8(-1)),
+				     _mm_cmplt_epi8(d, _mm_set1_epi8(10)));
+	__m128i is_l = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8(-1)),
+				     _mm_cmplt_epi8(l, _mm_set1_epi8(6)));
+
+	*valid = _mm_movemask_epi8(_mm_or_si128(is_d, is_l));
+	return _mm_or_si128(_mm_and_si128(is_d, d),
+			    _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+/* Convert blocks of 32 hex digits to 16 bytes each, up to the first block
+ * containing anything else than hex digits.  len is the number of characters
+ * available in in.  Returns the number of bytes written, a multiple of 16. */
+size_t osmo_hex_dec_sse(uint8_t *out, const char *in, size_t len)
+{
+	/* high nibble times 16 plus low nibble */
+	const __m128i weights = _mm_set1_epi16(0x0110);
+	size_t i;
+
+	for (i = 0; i + 32 <= len; i += 32) {
+		int valid0, valid1;
+		__m128i n0 = hex_dec_nibbles(_mm_loadu_si128((const __m128i *) (in + i)), &valid0);
+		__m128i n1 = hex_dec_nibbles(_mm_loadu_si128((const __m128i *) (in + i + 16)), &valid1);
+
+		if ((valid0 & valid1) != 0xffff)
+			break;
+		_mm_storeu_si128((__m128i *) (out + i / 2),
+				 _mm_packus_epi16(_mm_maddubs_epi16(n0, weights),
+						  _mm_maddubs_epi16(n1, weights)));
+	}
+
+	return i / 2;
+}
+
+/* Convert 16 unpacked bits at a time to '0', '1', '?' (0xff) or 'E' (anything else).
+ * Returns the number of bits converted, a multiple of 16. */
+size_t osmo_ubit_dump_sse(char *out, const uint8_t *bits, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i + 16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (bits + i));
+		__m128i is0 = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+		__m128i is1 = _mm_cmpeq_epi8(v, _mm_set1_epi8(1));
+		__m128i isff = _mm_cmpeq_epi8(v, _mm_set1_epi8(-1));
+		__m128i other = _mm_andnot_si128(_mm_or_si128(_mm_or_si128(is0, is1), isff),
+						 _mm_set1_epi8('E'));
+		__m128i r = _mm_or_si128(_mm_or_si128(_mm_and_si128(is0, _mm_set1_epi8('0')),
+						      _mm_and_si128(is1, _mm_set1_epi8('1'))),
+					 _mm_or_si128(_mm_and_si128(isff, _mm_set1_epi8('?')), other));
+
+		_mm_storeu_si128((__m128i *) (out + i), r);
+	}
+
+	return i;
+}
@@ -0,0 +1,92 @@
+/*! \file hex_sse_avx.c
+ * Accelerated hexdump and hexparse
+ * for architectures with both SSSE3 and AVX2 support. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#include <immintrin.h>
+
+/* Convert 32 byte blocks to 64 lower case hex digits each.
+ * Returns the number of bytes converted, a multiple of 32. */
+size_t osmo_hex_enc_sse_avx(char *out, const uint8_t *in, size_t len)
+{
+	const __m256i lut = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+					     '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+					     '0', '1', '2', '3', '4', '5', '6', '7',
+					     '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+	size_t i;
+
+	for (i = 0; i + 32 <= len; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (in + i));
+		__m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+		__m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+		/* unpack works within 128 bit lanes, put the lanes back in order */
+		__m256i r0 = _mm256_unpacklo_epi8(hi, lo);
+		__m256i r1 = _mm256_unpackhi_epi8(hi, lo);
+
+		_mm256_storeu_si256((__m256i *) (out + 2 * i), _mm256_permute2x128_si256(r0, r1, 0x20));
+		_mm256_storeu_si256((__m256i *) (out + 2 * i + 32), _mm256_permute2x128_si256(r0, r1, 0x31));
+	}
+
+	return i;
+}
+
+/* Nibble values of 32 characters; all bits of *valid are set if they are all hex digits */
+static inline __m256i hex_dec_nibbles(__m256i c, int *valid)
+{
+	__m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+	__m256i l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	__m256i is_d = _mm256_and_si256(_mm256_cmpgt_epi8(d, _mm256_set1_epi8(-1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8(10), d));
+	__m256i is_l = _mm256_and_si256(_mm256_cmpgt_epi8(l, _mm256_set1_epi8(-1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8(6), l));
+
+	*valid = _mm256_movemask_epi8(_mm256_or_si256(is_d, is_l));
+	return _mm256_or_si256(_mm256_and_si256(is_d, d),
+			       _mm256_and_si256(is_l, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+}
+
+/* Convert blocks of 64 hex digits to 32 bytes each, up to the first block
+ * containing anything else than hex digits.  len is the number of characters
+ * available in in.  Returns the number of bytes written, a multiple of 32. */
+size_t osmo_hex_dec_sse_avx(uint8_t *out, const char *in, size_t len)
+{
+	/* high nibble times 16 plus low nibble */
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+	size_t i;
+
+	for (i = 0; i + 64 <= len; i += 64) {
+		int valid0, valid1;
+		__m256i n0 = hex_dec_nibbles(_mm256_loadu_si256((const __m256i *) (in + i)), &valid0);
+		__m256i n1 = hex_dec_nibbles(_mm256_loadu_si256((const __m256i *) (in + i + 32)), &valid1);
+		__m256i r;
+
+		if ((valid0 & valid1) != -1)
+			break;
+		/* pack works within 128 bit lanes, put the lanes back in order */
+		r = _mm256_packus_epi16(_mm256_maddubs_epi16(n0, weights), _mm256_maddubs_epi16(n1, weights));
+		_mm256_storeu_si256((__m256i *) (out + i / 2), _mm256_permute4x64_epi64(r, 0xd8));
+	}
+
+	return i / 2;
+}
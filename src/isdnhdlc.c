@@ -28,6 +28,7 @@
 
 #include <osmocom/core/crc16.h>
 #include <osmocom/core/bits.h>
+#include <osmocom/core/utils.h>
 #include <osmocom/core/isdnhdlc.h>
 
 enum {
@@ -44,6 +45,97 @@ enum {
 
 #define crc_ccitt_byte osmo_crc16_ccitt_byte
 
+/* Byte-wise (de)stuffing tables, indexed by the number of consecutive '1'
+ * bits preceding the byte (0..5) and the byte itself.  They are used for
+ * the bulk of the frame payload; flags, aborts and idle are still handled
+ * by the per-bit state machines below. */
+
+/* receive direction: input byte is processed MSB first */
+struct hdlc_rx_lut_entry {
+	/* de-stuffed data bits, first received bit in LSB */
+	uint8_t bits;
+	/* number of valid bits in 'bits' */
+	uint8_t num_bits:4;
+	/* number of consecutive '1' bits after this byte */
+	uint8_t bits1:3;
+	/* byte contains six or more consecutive '1' bits (flag / abort) */
+	uint8_t slow:1;
+};
+
+/* transmit direction: input byte is processed LSB first */
+struct hdlc_tx_lut_entry {
+	/* stuffed output bits, first transmitted bit in MSB of num_bits */
+	uint16_t bits;
+	/* number of valid bits in 'bits' (8..10) */
+	uint8_t num_bits;
+	/* number of consecutive '1' bits after this byte; 5 means a zero bit
+	 * still needs to be stuffed before the next data bit */
+	uint8_t bits1;
+};
+
+static struct hdlc_rx_lut_entry hdlc_rx_lut[6][256];
+static struct hdlc_tx_lut_entry hdlc_tx_lut[6][256];
+
+static void hdlc_lut_init(void)
+{
+	unsigned int bits1_in, byte, i;
+
+	for (bits1_in = 0; bits1_in < 6; bits1_in++) {
+		for (byte = 0; byte < 256; byte++) {
+			struct hdlc_rx_lut_entry *rx = &hdlc_rx_lut[bits1_in][byte];
+			struct hdlc_tx_lut_entry *tx = &hdlc_tx_lut[bits1_in][byte];
+			unsigned int bits1, bits = 0, num_bits = 0;
+
+			/* de-stuffing, see HDLC_GET_DATA */
+			bits1 = bits1_in;
+			for (i = 0; i < 8; i++) {
+				if (byte & (0x80 >> i)) {
+					if (++bits1 >= 6) {
+						rx->slow = 1;
+						break;
+					}
+					bits |= 1 << num_bits++;
+				} else {
+					if (bits1 != 5)
+						num_bits++;
+					bits1 = 0;
+				}
+			}
+			if (!rx->slow) {
+				rx->bits = bits;
+				rx->num_bits = num_bits;
+				rx->bits1 = bits1;
+			}
+
+			/* stuffing, see HDLC_SEND_DATA */
+			bits1 = bits1_in;
+			bits = num_bits = 0;
+			for (i = 0; i < 8; i++) {
+				if (bits1 == 5) {
+					bits <<= 1;
+					num_bits++;
+					bits1 = 0;
+				}
+				bits <<= 1;
+				num_bits++;
+				if (byte & (1 << i)) {
+					bits |= 1;
+					bits1++;
+				} else
+					bits1 = 0;
+			}
+			tx->bits = bits;
+			tx->num_bits = num_bits;
+			tx->bits1 = bits1;
+		}
+	}
+}
+
+static __attribute__((constructor)) void on_dso_load_isdnhdlc(void)
+{
+	hdlc_lut_init();
+}
+
 void osmo_isdnhdlc_rcv_init(struct osmo_isdnhdlc_vars *hdlc, uint32_t features)
 {
 	memset(hdlc, 0, sizeof(*hdlc));
@@ -224,6 +316,32 @@ int osmo_isdnhdlc_decode(struct osmo_isdnhdlc_vars *hdlc, const uint8_t *src, in
 			hdlc->bit_shift--;
 			break;
 		case HDLC_GET_DATA:
+			/* fast path: de-stuff a complete byte at once unless it
+			 * contains a flag / abort or overflows the destination */
+			if (hdlc->bit_shift == 8 && hdlc->hdlc_bits1 < 6 && !status) {
+				const struct hdlc_rx_lut_entry *e = &hdlc_rx_lut[hdlc->hdlc_bits1][hdlc->cbin];
+				if (!e->slow && (hdlc->data_bits + e->num_bits < 8 || hdlc->dstpos < dsize)) {
+					unsigned int bits = e->bits, num_bits = e->num_bits;
+					unsigned int n = OSMO_MIN(num_bits, 8 - hdlc->data_bits);
+
+					hdlc->shift_reg = (hdlc->shift_reg >> n) | ((bits << (8 - n)) & 0xff);
+					hdlc->data_bits += n;
+					if (hdlc->data_bits == 8) {
+						hdlc->data_received = 1;
+						hdlc->crc = crc_ccitt_byte(hdlc->crc, hdlc->shift_reg);
+						dst[hdlc->dstpos++] = hdlc->shift_reg;
+						/* remaining bits start the next byte */
+						bits >>= n;
+						n = num_bits - n;
+						hdlc->shift_reg = (hdlc->shift_reg >> n) | ((bits << (8 - n)) & 0xff);
+						hdlc->data_bits = n;
+					}
+					hdlc->hdlc_bits1 = e->bits1;
+					hdlc->cbin = 0;
+					hdlc->bit_shift = 0;
+					break;
+				}
+			}
 			if (hdlc->cbin & 0x80) {
 				hdlc->hdlc_bits1++;
 				switch (hdlc->hdlc_bits1) {
@@ -458,6 +576,31 @@ int osmo_isdnhdlc_encode(struct osmo_isdnhdlc_vars *hdlc, const uint8_t *src, ui
 			}
 			break;
 		case HDLC_SEND_DATA:
+			/* fast path: stuff a complete byte at once if the result
+			 * is guaranteed to fit into the destination */
+			if (hdlc->bit_shift == 8 && !hdlc->do_adapt56 && dsize >= 2) {
+				const struct hdlc_tx_lut_entry *e = &hdlc_tx_lut[hdlc->hdlc_bits1][hdlc->shift_reg];
+				unsigned int acc = (hdlc->cbin << e->num_bits) | e->bits;
+
+				hdlc->crc = crc_ccitt_byte(hdlc->crc, hdlc->shift_reg);
+				hdlc->data_bits += e->num_bits;
+				while (hdlc->data_bits >= 8) {
+					hdlc->data_bits -= 8;
+					hdlc->cbin = acc >> hdlc->data_bits;
+					/* the code is for bitreverse streams */
+					if (hdlc->do_bitreverse == 0)
+						*dst++ = osmo_revbytebits_8(hdlc->cbin);
+					else
+						*dst++ = hdlc->cbin;
+					len++;
+					dsize--;
+				}
+				hdlc->cbin = acc;
+				hdlc->hdlc_bits1 = e->bits1;
+				hdlc->shift_reg = 0;
+				hdlc->bit_shift = 0;
+				break;
+			}
 			hdlc->cbin <<= 1;
 			hdlc->data_bits++;
 			if (hdlc->hdlc_bits1 == 5) {
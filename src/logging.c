@@ -30,6 +30,7 @@
  * \file logging.c */
 
 #include "../config.h"
+#include "usdt.h"
 
 #include <stdarg.h>
 #include <stdlib.h>
@@ -583,6 +584,8 @@ void osmo_vlogp(int subsys, int level, const char *file, int line,
 
 	subsys = map_subsys(subsys);
 
+	OSMO_TRACE4(log, subsys, level, file, line);
+
 	log_tgt_mutex_lock();
 
 	llist_for_each_entry(tar, &osmo_log_target_list, entry) {
@@ -0,0 +1,294 @@
+/*! \file loop_stats.c
+ * Main loop latency and per-callback profiling. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*! \addtogroup loop_stats
+ *  @{
+ *  Opt-in profiling of the \ref osmo_select_main loop.
+ *
+ *  Once enabled with \ref osmo_loop_stats_enable, the execution time of
+ *  every \ref osmo_fd and \ref osmo_timer_list call-back dispatched by
+ *  the calling thread is measured with CLOCK_MONOTONIC and accumulated
+ *  in a log2 histogram per call-back function (and file descriptor).
+ *  The time spent blocking in select() and the remaining busy time of
+ *  each loop iteration are recorded the same way, and the most recent
+ *  values are published as \ref osmo_stat_item in the "main_loop" group.
+ *
+ *  Call-backs running longer than the slow threshold are logged on
+ *  DLGLOBAL, so that the offender is visible right away.  The collected
+ *  statistics can be inspected by the "show main-loop stats" VTY command.
+ *
+ * \file loop_stats.c */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <osmocom/core/loop_stats.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/stat_item.h>
+#include <osmocom/core/stats.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+
+#include "loop_stats_hooks.h"
+
+static const struct osmo_stat_item_desc loop_stat_item_desc[] = {
+	[OSMO_LOOP_STAT_BUSY] = { "iteration:busy", "Time spent processing in one main loop iteration",
+				  "us", 16, 0 },
+	[OSMO_LOOP_STAT_WAIT] = { "iteration:wait", "Time spent waiting in select() in one main loop iteration",
+				  "us", 16, 0 },
+	[OSMO_LOOP_STAT_CB_MAX] = { "callback:max", "Longest call-back execution in one main loop iteration",
+				    "us", 16, 0 },
+	[OSMO_LOOP_STAT_SLOW] = { "callback:slow", "Total number of call-backs above the slow threshold",
+				  OSMO_STAT_ITEM_NO_UNIT, 16, 0 },
+};
+
+static const struct osmo_stat_item_group_desc loop_statg_desc = {
+	.group_name_prefix = "main_loop",
+	.group_description = "Main loop profiling",
+	.class_id = OSMO_STATS_CLASS_GLOBAL,
+	.num_items = ARRAY_SIZE(loop_stat_item_desc),
+	.item_desc = loop_stat_item_desc,
+};
+
+static struct osmo_loop_stats *loop_stats;
+static struct osmo_stat_item_group *loop_statg;
+/* longest call-back of the current iteration */
+static uint32_t iter_cb_max_us;
+/* profiling is enabled, tested inline by the hooks in select.c and timer.c */
+bool _osmo_loop_stats_active;
+/* only the loop of the thread that enabled profiling is recorded */
+static __thread bool loop_stats_thread;
+
+static uint32_t elapsed_us(const struct timespec *start, const struct timespec *end)
+{
+	int64_t us = (int64_t)(end->tv_sec - start->tv_sec) * 1000000
+		     + (end->tv_nsec - start->tv_nsec) / 1000;
+
+	if (us < 0)
+		return 0;
+	if (us > UINT32_MAX)
+		return UINT32_MAX;
+	return us;
+}
+
+static unsigned int hist_bucket(uint32_t us)
+{
+	unsigned int b;
+
+	if (!us)
+		return 0;
+	b = 32 - __builtin_clz(us);
+	return OSMO_MIN(b, OSMO_LOOP_STATS_HIST_BUCKETS - 1);
+}
+
+static struct osmo_loop_cb_stats *cb_stats_find(enum osmo_loop_cb_type type, const void *cb, int fd)
+{
+	unsigned int i, idx;
+
+	idx = (((uintptr_t)cb >> 4) ^ ((unsigned int)fd * 31) ^ type) % OSMO_LOOP_STATS_MAX_CBS;
+	for (i = 0; i < OSMO_LOOP_STATS_MAX_CBS; i++) {
+		struct osmo_loop_cb_stats *cs = &loop_stats->cbs[(idx + i) % OSMO_LOOP_STATS_MAX_CBS];
+		if (!cs->count) {
+			cs->type = type;
+			cs->cb = cb;
+			cs->fd = fd;
+			return cs;
+		}
+		if (cs->type == type && cs->cb == cb && cs->fd == fd)
+			return cs;
+	}
+	return NULL;
+}
+
+/*! Enable profiling of the main loop run by the calling thread.
+ *  \param[in] ctx talloc context to allocate the statistics from
+ *  \param[in] slow_threshold_us log call-backs running longer than this, 0 to never log
+ *  \returns 0 on success; -EBUSY if another thread is profiled, -ENOMEM on error */
+int osmo_loop_stats_enable(void *ctx, unsigned int slow_threshold_us)
+{
+	if (loop_stats) {
+		if (!loop_stats_thread)
+			return -EBUSY;
+		loop_stats->slow_threshold_us = slow_threshold_us;
+		return 0;
+	}
+
+	loop_stats = talloc_zero(ctx, struct osmo_loop_stats);
+	if (!loop_stats)
+		return -ENOMEM;
+	loop_statg = osmo_stat_item_group_alloc(loop_stats, &loop_statg_desc, 0);
+	if (!loop_statg) {
+		talloc_free(loop_stats);
+		loop_stats = NULL;
+		return -ENOMEM;
+	}
+
+	loop_stats->slow_threshold_us = slow_threshold_us;
+	loop_stats_thread = true;
+	_osmo_loop_stats_active = true;
+	return 0;
+}
+
+/*! Disable main loop profiling and free all statistics. */
+void osmo_loop_stats_disable(void)
+{
+	if (!loop_stats)
+		return;
+	osmo_stat_item_group_free(loop_statg);
+	loop_statg = NULL;
+	talloc_free(loop_stats);
+	loop_stats = NULL;
+	loop_stats_thread = false;
+	_osmo_loop_stats_active = false;
+}
+
+/*! Is main loop profiling enabled? */
+bool osmo_loop_stats_enabled(void)
+{
+	return loop_stats != NULL;
+}
+
+/*! Clear all statistics collected so far, keeping the slow threshold. */
+void osmo_loop_stats_reset(void)
+{
+	unsigned int slow_threshold_us;
+
+	if (!loop_stats)
+		return;
+	slow_threshold_us = loop_stats->slow_threshold_us;
+	memset(loop_stats, 0, sizeof(*loop_stats));
+	loop_stats->slow_threshold_us = slow_threshold_us;
+	iter_cb_max_us = 0;
+}
+
+/*! Set the execution time above which call-backs are logged as slow.
+ *  \param[in] slow_threshold_us threshold in microseconds, 0 to never log */
+void osmo_loop_stats_set_slow_threshold(unsigned int slow_threshold_us)
+{
+	if (loop_stats)
+		loop_stats->slow_threshold_us = slow_threshold_us;
+}
+
+/*! Get the statistics collected so far.
+ *  \returns statistics; NULL if profiling is not enabled */
+const struct osmo_loop_stats *osmo_loop_stats_get(void)
+{
+	return loop_stats;
+}
+
+/*! Get the upper (exclusive) bound of a histogram bucket.
+ *  \param[in] bucket histogram bucket index
+ *  \returns bound in microseconds; 0 for the last, unbounded bucket */
+unsigned int osmo_loop_stats_hist_bucket_us(unsigned int bucket)
+{
+	if (bucket >= OSMO_LOOP_STATS_HIST_BUCKETS - 1)
+		return 0;
+	return 1U << bucket;
+}
+
+/*! Start timing a call-back or loop iteration, see _osmo_loop_stats_start().
+ *  \param[out] ts start time
+ *  \returns true if the calling thread is profiled and \a ts was filled */
+bool _osmo_loop_stats_start_timing(struct timespec *ts)
+{
+	if (!loop_stats_thread || !loop_stats)
+		return false;
+	osmo_clock_gettime(CLOCK_MONOTONIC, ts);
+	return true;
+}
+
+/*! Record the execution time of a call-back started by _osmo_loop_stats_start().
+ *  \param[in] type kind of call-back
+ *  \param[in] cb call-back function
+ *  \param[in] fd file descriptor of an \ref osmo_fd, -1 for timers
+ *  \param[in] start time returned by _osmo_loop_stats_start() */
+void _osmo_loop_stats_cb_end(enum osmo_loop_cb_type type, const void *cb, int fd,
+			     const struct timespec *start)
+{
+	struct osmo_loop_cb_stats *cs;
+	struct timespec now;
+	uint32_t us;
+
+	/* the call-back may have disabled profiling */
+	if (!loop_stats)
+		return;
+
+	osmo_clock_gettime(CLOCK_MONOTONIC, &now);
+	us = elapsed_us(start, &now);
+	if (us > iter_cb_max_us)
+		iter_cb_max_us = us;
+
+	cs = cb_stats_find(type, cb, fd);
+	if (!cs) {
+		loop_stats->untracked++;
+	} else {
+		cs->count++;
+		cs->total_us += us;
+		if (us > cs->max_us)
+			cs->max_us = us;
+		cs->hist[hist_bucket(us)]++;
+	}
+
+	if (loop_stats->slow_threshold_us && us > loop_stats->slow_threshold_us) {
+		loop_stats->slow++;
+		if (cs)
+			cs->slow++;
+		if (type == OSMO_LOOP_CB_FD)
+			LOGP(DLGLOBAL, LOGL_NOTICE, "slow fd %d call-back %p took %u us\n", fd, cb, us);
+		else
+			LOGP(DLGLOBAL, LOGL_NOTICE, "slow timer call-back %p took %u us\n", cb, us);
+	}
+}
+
+/*! Record one main loop iteration.
+ *  \param[in] start start of the iteration
+ *  \param[in] poll_start time select() was entered
+ *  \param[in] poll_end time select() returned */
+void _osmo_loop_stats_iter_end(const struct timespec *start, const struct timespec *poll_start,
+			       const struct timespec *poll_end)
+{
+	struct timespec now;
+	uint32_t wait_us, busy_us;
+
+	if (!loop_stats)
+		return;
+
+	osmo_clock_gettime(CLOCK_MONOTONIC, &now);
+	wait_us = elapsed_us(poll_start, poll_end);
+	busy_us = elapsed_us(start, poll_start) + elapsed_us(poll_end, &now);
+
+	loop_stats->iterations++;
+	loop_stats->wait_us += wait_us;
+	loop_stats->busy_us += busy_us;
+	if (busy_us > loop_stats->busy_max_us)
+		loop_stats->busy_max_us = busy_us;
+	loop_stats->wait_hist[hist_bucket(wait_us)]++;
+	loop_stats->busy_hist[hist_bucket(busy_us)]++;
+
+	osmo_stat_item_set(loop_statg->items[OSMO_LOOP_STAT_BUSY], OSMO_MIN(busy_us, INT32_MAX));
+	osmo_stat_item_set(loop_statg->items[OSMO_LOOP_STAT_WAIT], OSMO_MIN(wait_us, INT32_MAX));
+	osmo_stat_item_set(loop_statg->items[OSMO_LOOP_STAT_CB_MAX], OSMO_MIN(iter_cb_max_us, INT32_MAX));
+	osmo_stat_item_set(loop_statg->items[OSMO_LOOP_STAT_SLOW], OSMO_MIN(loop_stats->slow, INT32_MAX));
+	iter_cb_max_us = 0;
+}
+
+/*! @} */
@@ -0,0 +1,32 @@
+/*! \file loop_stats_hooks.h
+ * Main loop profiling hooks called from select.c and timer.c.
+ *
+ * The check whether profiling is enabled at all is inlined, so that with
+ * profiling disabled each call-back and loop iteration only costs the test of
+ * one global flag.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <osmocom/core/loop_stats.h>
+
+/* set while main loop profiling is enabled, see loop_stats.c */
+extern bool _osmo_loop_stats_active;
+
+bool _osmo_loop_stats_start_timing(struct timespec *ts);
+void _osmo_loop_stats_cb_end(enum osmo_loop_cb_type type, const void *cb, int fd,
+			     const struct timespec *start);
+void _osmo_loop_stats_iter_end(const struct timespec *start, const struct timespec *poll_start,
+			       const struct timespec *poll_end);
+
+/* Start timing a call-back or loop iteration.
+ * Returns true if the calling thread is profiled and ts was filled. */
+static inline bool _osmo_loop_stats_start(struct timespec *ts)
+{
+	if (!_osmo_loop_stats_active)
+		return false;
+	return _osmo_loop_stats_start_timing(ts);
+}
@@ -64,6 +64,8 @@
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/logging.h>
 
+#include "usdt.h"
+
 /*! Allocate a new message buffer from given talloc cotext
  * \param[in] ctx talloc context from which to allocate
  * \param[in] size Length in octets, including headroom
@@ -94,6 +96,7 @@ struct msgb *msgb_alloc_c(const void *ctx, uint16_t size, const char *name)
 	msg->head = msg->_data;
 	msg->tail = msg->_data;
 
+	OSMO_TRACE3(msgb_alloc, msg, size, name);
 	return msg;
 }
 
@@ -120,6 +123,7 @@ struct msgb *msgb_alloc(uint16_t size, const char *name)
  */
 void msgb_free(struct msgb *m)
 {
+	OSMO_TRACE1(msgb_free, m);
 	talloc_free(m);
 }
 
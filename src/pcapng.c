@@ -0,0 +1,517 @@
+/*! \file pcapng.c
+ * In-process PCAP-NG capture file writer. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+
+#include <osmocom/core/bit16gen.h>
+#include <osmocom/core/pcapng.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+
+/*! \addtogroup pcapng
+ *  @{
+ *  Capture packets into PCAP-NG files, without going through the network.
+ *
+ *  Packets are appended to one of two large buffers by the caller.  Once it
+ *  is full, or after at most PCAPNG_FLUSH_INTERVAL_S seconds, the buffer is
+ *  handed to a background thread that writes it to the current file, while
+ *  the caller continues with the other buffer.  If the background thread
+ *  has not finished the previous buffer by then, packets are dropped rather
+ *  than blocking the caller.
+ *
+ * \file pcapng.c */
+
+#define PCAPNG_BUF_SIZE		(1 << 20)
+#define PCAPNG_FLUSH_INTERVAL_S	1
+#define PCAPNG_MAX_IF		8
+
+#define PCAPNG_BT_SHB		0x0a0d0d0a
+#define PCAPNG_BT_IDB		0x00000001
+#define PCAPNG_BT_EPB		0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1a2b3c4d
+
+#define PCAPNG_SHB_LEN		28
+#define PCAPNG_IDB_LEN		20
+#define PCAPNG_EPB_LEN(cap_len)	(32 + (((cap_len) + 3) & ~3))
+
+struct pcapng_buf {
+	uint8_t *data;
+	size_t len;
+	/* start a new file before writing the buffer */
+	bool new_file;
+};
+
+struct osmo_pcapng_writer {
+	char *path;
+	size_t max_file_bytes;
+	unsigned int max_files;
+
+	/* only used by the caller */
+	struct pcapng_buf bufs[2];
+	struct pcapng_buf *active;
+	size_t file_bytes;
+	bool file_has_packets;
+	uint16_t linktypes[PCAPNG_MAX_IF];
+	unsigned int num_if;
+	struct osmo_timer_list flush_timer;
+	uint64_t packets;
+	uint64_t dropped;
+
+	/* shared with the writer thread */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	struct pcapng_buf *pending;
+	bool stop;
+	uint64_t bytes;
+	uint64_t write_errors;
+	unsigned int files;
+
+	/* only used by the writer thread */
+	pthread_t thread;
+	int fd;
+};
+
+static void put_u16(uint8_t **p, uint16_t v)
+{
+	memcpy(*p, &v, sizeof(v));
+	*p += sizeof(v);
+}
+
+static void put_u32(uint8_t **p, uint32_t v)
+{
+	memcpy(*p, &v, sizeof(v));
+	*p += sizeof(v);
+}
+
+static void buf_put_idb(struct pcapng_buf *buf, uint16_t linktype)
+{
+	uint8_t *p = buf->data + buf->len;
+
+	put_u32(&p, PCAPNG_BT_IDB);
+	put_u32(&p, PCAPNG_IDB_LEN);
+	put_u16(&p, linktype);
+	put_u16(&p, 0);
+	put_u32(&p, 0);			/* no snap length limit */
+	put_u32(&p, PCAPNG_IDB_LEN);
+	buf->len += PCAPNG_IDB_LEN;
+}
+
+/* start a new file (section) in the active buffer */
+static void start_file(struct osmo_pcapng_writer *w)
+{
+	struct pcapng_buf *buf = w->active;
+	uint8_t *p = buf->data + buf->len;
+	unsigned int i;
+
+	put_u32(&p, PCAPNG_BT_SHB);
+	put_u32(&p, PCAPNG_SHB_LEN);
+	put_u32(&p, PCAPNG_BYTE_ORDER_MAGIC);
+	put_u16(&p, 1);			/* major version */
+	put_u16(&p, 0);			/* minor version */
+	put_u32(&p, 0xffffffff);	/* section length unknown */
+	put_u32(&p, 0xffffffff);
+	put_u32(&p, PCAPNG_SHB_LEN);
+	buf->len += PCAPNG_SHB_LEN;
+	buf->new_file = true;
+
+	/* all interfaces known so far */
+	for (i = 0; i < w->num_if; i++)
+		buf_put_idb(buf, w->linktypes[i]);
+
+	w->file_bytes = buf->len;
+	w->file_has_packets = false;
+}
+
+/* hand the active buffer to the writer thread, unless it is still busy */
+static int handoff(struct osmo_pcapng_writer *w)
+{
+	pthread_mutex_lock(&w->mutex);
+	if (w->pending) {
+		pthread_mutex_unlock(&w->mutex);
+		return -EBUSY;
+	}
+	w->pending = w->active;
+	pthread_cond_signal(&w->cond);
+	pthread_mutex_unlock(&w->mutex);
+
+	w->active = (w->active == &w->bufs[0]) ? &w->bufs[1] : &w->bufs[0];
+	return 0;
+}
+
+static void open_next_file(struct osmo_pcapng_writer *w)
+{
+	char name[PATH_MAX];
+
+	if (w->fd >= 0)
+		close(w->fd);
+
+	if (!w->max_file_bytes) {
+		OSMO_STRLCPY_ARRAY(name, w->path);
+	} else {
+		if (w->max_files && w->files >= w->max_files) {
+			snprintf(name, sizeof(name), "%s.%u", w->path, w->files - w->max_files);
+			unlink(name);
+		}
+		snprintf(name, sizeof(name), "%s.%u", w->path, w->files);
+	}
+
+	w->fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	pthread_mutex_lock(&w->mutex);
+	if (w->fd < 0)
+		w->write_errors++;
+	w->files++;
+	pthread_mutex_unlock(&w->mutex);
+}
+
+static void write_buf(struct osmo_pcapng_writer *w, struct pcapng_buf *buf)
+{
+	size_t written = 0;
+	ssize_t rc = 0;
+
+	if (buf->new_file)
+		open_next_file(w);
+
+	while (w->fd >= 0 && written < buf->len) {
+		rc = write(w->fd, buf->data + written, buf->len - written);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0)
+			break;
+		written += rc;
+	}
+
+	pthread_mutex_lock(&w->mutex);
+	w->bytes += written;
+	if (written < buf->len)
+		w->write_errors++;
+	pthread_mutex_unlock(&w->mutex);
+
+	buf->len = 0;
+	buf->new_file = false;
+}
+
+static void *writer_thread(void *data)
+{
+	struct osmo_pcapng_writer *w = data;
+
+	pthread_mutex_lock(&w->mutex);
+	while (1) {
+		struct pcapng_buf *buf;
+
+		while (!w->pending && !w->stop)
+			pthread_cond_wait(&w->cond, &w->mutex);
+		if (!w->pending)
+			break;
+
+		buf = w->pending;
+		pthread_mutex_unlock(&w->mutex);
+		write_buf(w, buf);
+		pthread_mutex_lock(&w->mutex);
+		w->pending = NULL;
+		pthread_cond_broadcast(&w->cond);
+	}
+	pthread_mutex_unlock(&w->mutex);
+
+	return NULL;
+}
+
+static void flush_timer_cb(void *data)
+{
+	osmo_pcapng_writer_flush(data);
+}
+
+/*! Hand all buffered packets to the writer thread
+ *  \param[in] w PCAP-NG writer
+ *  \returns 0 on success; -EBUSY if the writer thread is still busy
+ *
+ * This is done periodically from a timer, so there is normally no need to
+ * call it directly. */
+int osmo_pcapng_writer_flush(struct osmo_pcapng_writer *w)
+{
+	int rc;
+
+	if (!w->active->len)
+		return 0;
+
+	rc = handoff(w);
+	if (rc < 0)
+		osmo_timer_schedule(&w->flush_timer, PCAPNG_FLUSH_INTERVAL_S, 0);
+	return rc;
+}
+
+/* wait until the writer thread is idle */
+static void wait_idle(struct osmo_pcapng_writer *w)
+{
+	pthread_mutex_lock(&w->mutex);
+	while (w->pending)
+		pthread_cond_wait(&w->cond, &w->mutex);
+	pthread_mutex_unlock(&w->mutex);
+}
+
+/*! Write all buffered packets and wait until they are written
+ *  \param[in] w PCAP-NG writer
+ *
+ * Unlike all other functions of the writer, this blocks the caller. */
+void osmo_pcapng_writer_sync(struct osmo_pcapng_writer *w)
+{
+	wait_idle(w);
+	if (w->active->len)
+		OSMO_ASSERT(handoff(w) == 0);
+	wait_idle(w);
+}
+
+/* Reserve an Enhanced Packet Block in the active buffer and return a pointer
+ * to its cap_len bytes of packet data, or NULL if the packet is dropped */
+static uint8_t *epb_alloc(struct osmo_pcapng_writer *w, uint16_t linktype, size_t cap_len)
+{
+	struct pcapng_buf *buf;
+	struct timeval tv;
+	uint64_t ts;
+	size_t need = PCAPNG_EPB_LEN(cap_len);
+	unsigned int if_id;
+	uint8_t *p, *trailer;
+
+	for (if_id = 0; if_id < w->num_if; if_id++) {
+		if (w->linktypes[if_id] == linktype)
+			break;
+	}
+	if (if_id == w->num_if) {
+		if (w->num_if == PCAPNG_MAX_IF)
+			goto drop;
+		need += PCAPNG_IDB_LEN;
+	}
+	if (need + PCAPNG_SHB_LEN + PCAPNG_MAX_IF * PCAPNG_IDB_LEN > PCAPNG_BUF_SIZE)
+		goto drop;
+
+	if (w->max_file_bytes && w->file_has_packets && w->file_bytes + need > w->max_file_bytes) {
+		if (handoff(w) < 0)
+			goto drop;
+		start_file(w);
+	} else if (w->active->len + need > PCAPNG_BUF_SIZE) {
+		if (handoff(w) < 0)
+			goto drop;
+	}
+	buf = w->active;
+
+	if (if_id == w->num_if) {
+		w->linktypes[w->num_if++] = linktype;
+		buf_put_idb(buf, linktype);
+		w->file_bytes += PCAPNG_IDB_LEN;
+	}
+
+	osmo_gettimeofday(&tv, NULL);
+	ts = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+
+	need = PCAPNG_EPB_LEN(cap_len);
+	p = buf->data + buf->len;
+	put_u32(&p, PCAPNG_BT_EPB);
+	put_u32(&p, need);
+	put_u32(&p, if_id);
+	put_u32(&p, ts >> 32);
+	put_u32(&p, ts);
+	put_u32(&p, cap_len);
+	put_u32(&p, cap_len);
+	/* zero the padding and append the trailing block length */
+	memset(p + cap_len, 0, need - 32 - cap_len);
+	trailer = buf->data + buf->len + need - 4;
+	put_u32(&trailer, need);
+
+	buf->len += need;
+	w->file_bytes += need;
+	w->file_has_packets = true;
+	w->packets++;
+
+	if (!osmo_timer_pending(&w->flush_timer))
+		osmo_timer_schedule(&w->flush_timer, PCAPNG_FLUSH_INTERVAL_S, 0);
+	return p;
+
+drop:
+	w->dropped++;
+	return NULL;
+}
+
+/*! Write a packet to a PCAP-NG capture
+ *  \param[in] w PCAP-NG writer
+ *  \param[in] linktype link-layer header type of the packet (LINKTYPE_*)
+ *  \param[in] data packet data
+ *  \param[in] len length of data
+ *  \returns 0 on success; -ENOBUFS if the packet was dropped */
+int osmo_pcapng_write(struct osmo_pcapng_writer *w, uint16_t linktype,
+		      const uint8_t *data, size_t len)
+{
+	uint8_t *p = epb_alloc(w, linktype, len);
+
+	if (!p)
+		return -ENOBUFS;
+	memcpy(p, data, len);
+	return 0;
+}
+
+/*! Write a UDP datagram to a PCAP-NG capture, with synthesized IPv4 and UDP headers
+ *  \param[in] w PCAP-NG writer
+ *  \param[in] src source address and port
+ *  \param[in] dst destination address and port
+ *  \param[in] data UDP payload, e.g. a GSMTAP or NS-IP message
+ *  \param[in] len length of data
+ *  \returns 0 on success; -ENOBUFS if the packet was dropped */
+int osmo_pcapng_write_udp4(struct osmo_pcapng_writer *w, const struct sockaddr_in *src,
+			   const struct sockaddr_in *dst, const uint8_t *data, size_t len)
+{
+	uint16_t ip_len = 20 + 8 + len;
+	uint32_t csum = 0;
+	uint8_t *p, *ip;
+	unsigned int i;
+
+	if (len > UINT16_MAX - 20 - 8)
+		return -EINVAL;
+	p = ip = epb_alloc(w, OSMO_PCAPNG_LINKTYPE_RAW, ip_len);
+	if (!p)
+		return -ENOBUFS;
+
+	*p++ = 0x45;			/* IPv4, 20 bytes header */
+	*p++ = 0;
+	osmo_store16be(ip_len, p); p += 2;
+	osmo_store16be(0, p); p += 2;	/* identification */
+	osmo_store16be(0x4000, p); p += 2; /* don't fragment */
+	*p++ = 64;			/* TTL */
+	*p++ = IPPROTO_UDP;
+	osmo_store16be(0, p); p += 2;	/* checksum, see below */
+	memcpy(p, &src->sin_addr, 4); p += 4;
+	memcpy(p, &dst->sin_addr, 4); p += 4;
+	for (i = 0; i < 20; i += 2)
+		csum += osmo_load16be(ip + i);
+	while (csum >> 16)
+		csum = (csum & 0xffff) + (csum >> 16);
+	osmo_store16be(~csum, ip + 10);
+
+	memcpy(p, &src->sin_port, 2); p += 2;
+	memcpy(p, &dst->sin_port, 2); p += 2;
+	osmo_store16be(8 + len, p); p += 2;
+	osmo_store16be(0, p); p += 2;	/* no UDP checksum */
+
+	memcpy(p, data, len);
+	return 0;
+}
+
+/*! Get the statistics of a PCAP-NG writer
+ *  \param[in] w PCAP-NG writer
+ *  \param[out] st statistics */
+void osmo_pcapng_writer_get_stats(struct osmo_pcapng_writer *w, struct osmo_pcapng_stats *st)
+{
+	st->packets = w->packets;
+	st->dropped = w->dropped;
+	pthread_mutex_lock(&w->mutex);
+	st->bytes = w->bytes;
+	st->write_errors = w->write_errors;
+	st->files = w->files;
+	pthread_mutex_unlock(&w->mutex);
+}
+
+static int pcapng_writer_talloc_destructor(struct osmo_pcapng_writer *w)
+{
+	osmo_timer_del(&w->flush_timer);
+
+	/* write everything, then stop the writer thread */
+	osmo_pcapng_writer_sync(w);
+	pthread_mutex_lock(&w->mutex);
+	w->stop = true;
+	pthread_cond_signal(&w->cond);
+	pthread_mutex_unlock(&w->mutex);
+	pthread_join(w->thread, NULL);
+
+	if (w->fd >= 0)
+		close(w->fd);
+	pthread_cond_destroy(&w->cond);
+	pthread_mutex_destroy(&w->mutex);
+	return 0;
+}
+
+/*! Allocate a PCAP-NG writer and start its writer thread
+ *  \param[in] ctx talloc context
+ *  \param[in] path name of the capture file
+ *  \param[in] max_file_bytes start a new file when a file would exceed this size;
+ *		the files are then named path.0, path.1, ... 0 to write a single file
+ *  \param[in] max_files keep only the last max_files files, 0 to keep all
+ *  \returns newly allocated writer; NULL on error
+ *
+ * The files are created by the writer thread when the first packets are
+ * written to them.  Free the writer with osmo_pcapng_writer_free() or
+ * talloc_free() to write all remaining packets. */
+struct osmo_pcapng_writer *osmo_pcapng_writer_alloc(void *ctx, const char *path,
+						    size_t max_file_bytes, unsigned int max_files)
+{
+	struct osmo_pcapng_writer *w;
+	unsigned int i;
+
+	w = talloc_zero(ctx, struct osmo_pcapng_writer);
+	if (!w)
+		return NULL;
+	w->path = talloc_strdup(w, path);
+	w->max_file_bytes = max_file_bytes;
+	w->max_files = max_files;
+	w->fd = -1;
+	for (i = 0; i < ARRAY_SIZE(w->bufs); i++) {
+		w->bufs[i].data = talloc_size(w, PCAPNG_BUF_SIZE);
+		if (!w->bufs[i].data)
+			goto out_free;
+	}
+	if (!w->path)
+		goto out_free;
+	w->active = &w->bufs[0];
+	start_file(w);
+	osmo_timer_setup(&w->flush_timer, flush_timer_cb, w);
+
+	pthread_mutex_init(&w->mutex, NULL);
+	pthread_cond_init(&w->cond, NULL);
+	if (pthread_create(&w->thread, NULL, writer_thread, w)) {
+		pthread_cond_destroy(&w->cond);
+		pthread_mutex_destroy(&w->mutex);
+		goto out_free;
+	}
+	talloc_set_destructor(w, pcapng_writer_talloc_destructor);
+
+	return w;
+
+out_free:
+	talloc_free(w);
+	return NULL;
+}
+
+/*! Write all remaining packets, stop the writer thread and free a PCAP-NG writer
+ *  \param[in] w PCAP-NG writer */
+void osmo_pcapng_writer_free(struct osmo_pcapng_writer *w)
+{
+	talloc_free(w);
+}
+
+/*! @} */
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <osmocom/core/bits.h>
+#include <osmocom/core/utils.h>
 #include <osmocom/core/prbs.h>
 
 /*! \brief PRBS-7 according ITU-T O.150 */
@@ -76,3 +77,227 @@ int osmo_prbs_get_ubits(ubit_t *out, unsigned int out_len, struct osmo_prbs_stat
 
 	return i;
 }
+
+/* The LFSR is linear, so the 64 output bits and the state after 64 steps
+ * are the XOR of the contributions of each individual state bit.  Those
+ * contributions are pre-computed for the well-known sequences. */
+struct prbs_leap64 {
+	const struct osmo_prbs *prbs;
+	/*! 64 output bits (first bit in MSB) generated from each state bit */
+	uint64_t out[64];
+	/*! state after 64 steps, starting from each state bit */
+	uint64_t next[64];
+};
+
+static struct prbs_leap64 prbs_leap64[4];
+
+static void prbs_leap64_init(struct prbs_leap64 *leap, const struct osmo_prbs *prbs)
+{
+	struct osmo_prbs_state st;
+	unsigned int i, j;
+
+	leap->prbs = prbs;
+	for (j = 0; j < prbs->len; j++) {
+		st.prbs = prbs;
+		st.state = (uint64_t)1 << j;
+		leap->out[j] = 0;
+		for (i = 0; i < 64; i++)
+			leap->out[j] = (leap->out[j] << 1) | osmo_prbs_get_ubit(&st);
+		leap->next[j] = st.state;
+	}
+}
+
+static __attribute__((constructor)) void on_dso_load_prbs(void)
+{
+	prbs_leap64_init(&prbs_leap64[0], &osmo_prbs7);
+	prbs_leap64_init(&prbs_leap64[1], &osmo_prbs9);
+	prbs_leap64_init(&prbs_leap64[2], &osmo_prbs11);
+	prbs_leap64_init(&prbs_leap64[3], &osmo_prbs15);
+}
+
+static const struct prbs_leap64 *prbs_leap64_find(const struct osmo_prbs *prbs)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(prbs_leap64); i++) {
+		if (prbs_leap64[i].prbs == prbs)
+			return &prbs_leap64[i];
+	}
+	return NULL;
+}
+
+/*! \brief Get the next 64 bits out of given PRBS instance
+ *  \param[inout] state PRBS generator state
+ *  \returns next 64 bits of the sequence, first bit in the MSB
+ *
+ * For the PRBS sequences defined in this file, this uses pre-computed
+ * leap-forward matrices instead of clocking the LFSR 64 times. */
+uint64_t osmo_prbs_get_u64(struct osmo_prbs_state *state)
+{
+	const struct prbs_leap64 *leap = prbs_leap64_find(state->prbs);
+	uint64_t st = state->state;
+	uint64_t out = 0, next = 0;
+	unsigned int i;
+
+	if (!leap) {
+		for (i = 0; i < 64; i++)
+			out = (out << 1) | osmo_prbs_get_ubit(state);
+		return out;
+	}
+
+	for (i = 0; st; i++, st >>= 1) {
+		if (st & 1) {
+			out ^= leap->out[i];
+			next ^= leap->next[i];
+		}
+	}
+	state->state = next;
+
+	return out;
+}
+
+/*! \brief Fill buffer of packed bits with next bits out of given PRBS instance
+ *  \param[out] out output buffer of (num_bits + 7) / 8 bytes, MSB first
+ *  \param[in] num_bits number of bits to generate
+ *  \param[inout] state PRBS generator state
+ *  \returns number of bits generated */
+int osmo_prbs_get_pbits(pbit_t *out, unsigned int num_bits, struct osmo_prbs_state *state)
+{
+	unsigned int i;
+
+	for (i = 0; i + 64 <= num_bits; i += 64)
+		osmo_store64be(osmo_prbs_get_u64(state), out + i / 8);
+
+	if (i < num_bits)
+		memset(out + i / 8, 0, (num_bits - i + 7) / 8);
+	for (; i < num_bits; i++) {
+		if (osmo_prbs_get_ubit(state))
+			out[i / 8] |= 0x80 >> (i % 8);
+	}
+
+	return num_bits;
+}
+
+/* BER checker: number of consecutive correctly predicted bits required to lock */
+#define PRBS_BER_LOCK_BITS	32
+/* BER checker: size of the loss-of-sync detection window and the number of
+ * bit errors within it (25%) after which we consider synchronization lost */
+#define PRBS_BER_WIN_BITS	256
+#define PRBS_BER_WIN_ERRORS	64
+
+/*! \brief Initialize the given caller-allocated PRBS bit error rate checker
+ *  \param[out] ber BER checker state to initialize
+ *  \param[in] prbs PRBS sequence which is expected in the received bits
+ *
+ * The checker synchronizes itself to the received bit stream at an arbitrary
+ * position in the sequence, counts bit errors while synchronized, and
+ * re-synchronizes if the error rate indicates loss of synchronization. */
+void osmo_prbs_ber_init(struct osmo_prbs_ber *ber, const struct osmo_prbs *prbs)
+{
+	memset(ber, 0, sizeof(*ber));
+	ber->prbs = prbs;
+	ber->gen.prbs = prbs;
+}
+
+/* state of the LFSR after having generated the bits in ber->hist */
+static uint64_t prbs_ber_hist2state(const struct osmo_prbs_ber *ber)
+{
+	uint64_t state = 0;
+	unsigned int i;
+
+	for (i = 0; i < ber->prbs->len; i++) {
+		if (ber->hist & ((uint64_t)1 << i))
+			state ^= ber->prbs->coeff >> i;
+	}
+	return state;
+}
+
+/* feed one received bit into a BER checker which is not locked */
+static void prbs_ber_search_bit(struct osmo_prbs_ber *ber, ubit_t bit)
+{
+	const struct osmo_prbs *prbs = ber->prbs;
+	uint64_t mask = ((uint64_t)1 << prbs->len) - 1;
+
+	if (ber->hist_len >= prbs->len) {
+		/* predict next bit from the previous ones */
+		ubit_t predicted = __builtin_parityll(ber->hist & prbs->coeff);
+		if (bit == predicted)
+			ber->match_count++;
+		else
+			ber->match_count = 0;
+	} else
+		ber->hist_len++;
+
+	ber->hist = ((ber->hist << 1) | bit) & mask;
+
+	/* an all-zero LFSR state is never part of the sequence */
+	if (ber->match_count >= PRBS_BER_LOCK_BITS && ber->hist) {
+		ber->gen.state = prbs_ber_hist2state(ber);
+		ber->locked = true;
+		ber->win_bits = 0;
+		ber->win_errors = 0;
+	}
+}
+
+/* account for checked bits / errors while locked, detect loss of sync */
+static void prbs_ber_account(struct osmo_prbs_ber *ber, unsigned int num_bits, unsigned int num_errors)
+{
+	ber->num_bits += num_bits;
+	ber->num_errors += num_errors;
+	ber->win_bits += num_bits;
+	ber->win_errors += num_errors;
+
+	if (ber->win_errors >= PRBS_BER_WIN_ERRORS) {
+		ber->locked = false;
+		ber->num_sync_loss++;
+		ber->hist = 0;
+		ber->hist_len = 0;
+		ber->match_count = 0;
+	} else if (ber->win_bits >= PRBS_BER_WIN_BITS) {
+		ber->win_bits = 0;
+		ber->win_errors = 0;
+	}
+}
+
+static void prbs_ber_rx_bit(struct osmo_prbs_ber *ber, ubit_t bit)
+{
+	if (!ber->locked) {
+		prbs_ber_search_bit(ber, bit);
+		return;
+	}
+	prbs_ber_account(ber, 1, bit != osmo_prbs_get_ubit(&ber->gen));
+}
+
+/*! \brief Feed unpacked received bits into a PRBS bit error rate checker
+ *  \param[inout] ber BER checker state
+ *  \param[in] in received unpacked bits
+ *  \param[in] num_bits number of bits in 'in' */
+void osmo_prbs_ber_rx_ubits(struct osmo_prbs_ber *ber, const ubit_t *in, unsigned int num_bits)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_bits; i++)
+		prbs_ber_rx_bit(ber, in[i] ? 1 : 0);
+}
+
+/*! \brief Feed packed received bits into a PRBS bit error rate checker
+ *  \param[inout] ber BER checker state
+ *  \param[in] in received packed bits, MSB first
+ *  \param[in] num_bits number of bits in 'in'
+ *
+ * While locked, the received bits are compared 64 bits at a time. */
+void osmo_prbs_ber_rx_pbits(struct osmo_prbs_ber *ber, const pbit_t *in, unsigned int num_bits)
+{
+	unsigned int i = 0;
+
+	while (i < num_bits) {
+		if (ber->locked && (i % 8) == 0 && num_bits - i >= 64) {
+			uint64_t errors = osmo_load64be(in + i / 8) ^ osmo_prbs_get_u64(&ber->gen);
+			prbs_ber_account(ber, 64, __builtin_popcountll(errors));
+			i += 64;
+		} else {
+			prbs_ber_rx_bit(ber, (in[i / 8] >> (7 - i % 8)) & 1);
+			i++;
+		}
+	}
+}
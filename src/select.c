@@ -40,6 +40,8 @@
 #include <osmocom/core/utils.h>
 
 #include "../config.h"
+#include "usdt.h"
+#include "loop_stats_hooks.h"
 
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
@@ -218,13 +220,24 @@ restart:
 		}
 
 		if (flags) {
+			struct timespec ts;
+			int (*cb)(struct osmo_fd *fd, unsigned int what) = ufd->cb;
+			int fd = ufd->fd;
+			bool prof;
+
 			work = 1;
 			/* make sure to clear any log context before processing the next incoming message
 			 * as part of some file descriptor callback.  This effectively prevents "context
 			 * leaking" from processing of one message into processing of the next message as part
 			 * of one iteration through the list of file descriptors here.  See OS#3813 */
 			log_reset_context();
-			ufd->cb(ufd, flags);
+			prof = _osmo_loop_stats_start(&ts);
+			OSMO_TRACE3(fd_cb_enter, fd, flags, cb);
+			cb(ufd, flags);
+			OSMO_TRACE3(fd_cb_return, fd, flags, cb);
+			/* ufd may have been free'd by its call-back, use the saved values */
+			if (prof)
+				_osmo_loop_stats_cb_end(OSMO_LOOP_CB_FD, cb, fd, &ts);
 		}
 		/* ugly, ugly hack. If more than one filedescriptor was
 		 * unregistered, they might have been consecutive and
@@ -242,6 +255,8 @@ static int _osmo_select_main(int polling)
 	fd_set readset, writeset, exceptset;
 	int rc;
 	struct timeval no_time = {0, 0};
+	struct timespec ts_start, ts_poll_start, ts_poll_end;
+	bool prof = _osmo_loop_stats_start(&ts_start);
 
 	FD_ZERO(&readset);
 	FD_ZERO(&writeset);
@@ -252,9 +267,13 @@ static int _osmo_select_main(int polling)
 
 	if (!polling)
 		osmo_timers_prepare();
+	if (prof)
+		osmo_clock_gettime(CLOCK_MONOTONIC, &ts_poll_start);
 	rc = select(maxfd+1, &readset, &writeset, &exceptset, polling ? &no_time : osmo_timers_nearest());
 	if (rc < 0)
 		return 0;
+	if (prof)
+		osmo_clock_gettime(CLOCK_MONOTONIC, &ts_poll_end);
 
 	/* fire timers */
 	osmo_timers_update();
@@ -262,7 +281,11 @@ static int _osmo_select_main(int polling)
 	OSMO_ASSERT(osmo_ctx->select);
 
 	/* call registered callback functions */
-	return osmo_fd_disp_fds(&readset, &writeset, &exceptset);
+	rc = osmo_fd_disp_fds(&readset, &writeset, &exceptset);
+
+	if (prof)
+		_osmo_loop_stats_iter_end(&ts_start, &ts_poll_start, &ts_poll_end);
+	return rc;
 }
 
 /*! select main loop integration
@@ -153,6 +153,17 @@ static int socket_helper(const struct addrinfo *rp, unsigned int flags)
 	return sfd;
 }
 
+static int socket_set_reuseport(int sfd)
+{
+#ifdef SO_REUSEPORT
+	int on = 1;
+	return setsockopt(sfd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#else
+	errno = ENOTSUP;
+	return -1;
+#endif
+}
+
 #ifdef HAVE_LIBSCTP
 /* Fill buf with a string representation of the address set, in the form:
  * buf_len == 0: "()"
@@ -294,6 +305,13 @@ int osmo_sock_init2(uint16_t family, uint16_t type, uint8_t proto,
 				}
 			}
 
+			if (flags & OSMO_SOCK_F_REUSEPORT && socket_set_reuseport(sfd) < 0) {
+				LOGP(DLGLOBAL, LOGL_ERROR, "cannot set SO_REUSEPORT: %s:%u: %s\n",
+				     local_host, local_port, strerror(errno));
+				close(sfd);
+				continue;
+			}
+
 			if (bind(sfd, rp->ai_addr, rp->ai_addrlen) == -1) {
 				LOGP(DLGLOBAL, LOGL_ERROR, "unable to bind socket: %s:%u: %s\n",
 					local_host, local_port, strerror(errno));
@@ -489,6 +507,19 @@ int osmo_sock_init2_multiaddr(uint16_t family, uint16_t type, uint8_t proto,
 			return rc;
 		}
 
+		if (flags & OSMO_SOCK_F_REUSEPORT) {
+			rc = socket_set_reuseport(sfd);
+			if (rc < 0) {
+				multiaddr_snprintf(strbuf, sizeof(strbuf), local_hosts, local_hosts_cnt);
+				LOGP(DLGLOBAL, LOGL_ERROR, "cannot set SO_REUSEPORT: %s:%u: %s\n",
+				     strbuf, local_port, strerror(errno));
+				for (i = 0; i < local_hosts_cnt; i++)
+					freeaddrinfo(result[i]);
+				close(sfd);
+				return rc;
+			}
+		}
+
 		/* Build array of addresses taking first of same family for each host.
 		   TODO: Ideally we should use backtracking storing last used
 		   indexes and trying next combination if connect() fails .*/
@@ -643,6 +674,12 @@ int osmo_sock_init(uint16_t family, uint16_t type, uint8_t proto,
 					continue;
 				}
 			}
+			if (flags & OSMO_SOCK_F_REUSEPORT && socket_set_reuseport(sfd) < 0) {
+				LOGP(DLGLOBAL, LOGL_ERROR, "cannot set SO_REUSEPORT: %s:%u: %s\n",
+				     host, port, strerror(errno));
+				close(sfd);
+				continue;
+			}
 			if (bind(sfd, rp->ai_addr, rp->ai_addrlen) == -1) {
 				LOGP(DLGLOBAL, LOGL_ERROR, "unable to bind socket:"
 					"%s:%u: %s\n",
@@ -910,6 +947,13 @@ int osmo_sock_unix_init(uint16_t type, uint8_t proto,
 		     (OSMO_SOCK_F_BIND | OSMO_SOCK_F_CONNECT))
 		return -EINVAL;
 
+	/* SO_REUSEPORT load balancing only exists for IP sockets */
+	if (flags & OSMO_SOCK_F_REUSEPORT) {
+		LOGP(DLGLOBAL, LOGL_ERROR, "OSMO_SOCK_F_REUSEPORT is not supported for unix domain sockets: %s\n",
+		     socket_path);
+		return -EINVAL;
+	}
+
 	local.sun_family = AF_UNIX;
 	/* When an AF_UNIX socket is bound, sun_path should be NUL-terminated. See unix(7) man page. */
 	if (osmo_strlcpy(local.sun_path, socket_path, sizeof(local.sun_path)) >= sizeof(local.sun_path)) {
@@ -39,6 +39,9 @@
 #include <osmocom/core/timer_compat.h>
 #include <osmocom/core/linuxlist.h>
 
+#include "usdt.h"
+#include "loop_stats_hooks.h"
+
 /* These store the amount of time that we wait until next timer expires. */
 static __thread struct timeval nearest;
 static __thread struct timeval *nearest_p;
@@ -253,8 +256,18 @@ int osmo_timers_update(void)
 restart:
 	llist_for_each_entry(this, &timer_eviction_list, list) {
 		osmo_timer_del(this);
-		if (this->cb)
-			this->cb(this->data);
+		if (this->cb) {
+			struct timespec ts;
+			void (*cb)(void *data) = this->cb;
+
+			bool prof = _osmo_loop_stats_start(&ts);
+
+			OSMO_TRACE2(timer_cb_enter, this, cb);
+			cb(this->data);
+			OSMO_TRACE2(timer_cb_return, this, cb);
+			if (prof)
+				_osmo_loop_stats_cb_end(OSMO_LOOP_CB_TIMER, cb, -1, &ts);
+		}
 		work = 1;
 		goto restart;
 	}
@@ -0,0 +1,48 @@
+/*! \file usdt.h
+ * Static tracepoints on libosmocore hot paths.
+ *
+ * When configured with --enable-usdt, the OSMO_TRACE*() macros expand to
+ * USDT probes of provider "libosmocore" as defined by <sys/sdt.h>, which
+ * bpftrace, perf and SystemTap can attach to at run-time, e.g.:
+ *
+ *   bpftrace -e 'usdt:libosmocore.so:libosmocore:msgb_alloc { @[str(arg2)] = count(); }'
+ *
+ * Each probe is a single nop in the instruction stream until a tracer is
+ * attached.  Without --enable-usdt the macros expand to nothing and the
+ * probe arguments are not evaluated at all.
+ *
+ * Probes and their arguments:
+ *   msgb_alloc(msg, size, name), msgb_free(msg)
+ *   fd_cb_enter(fd, what, cb), fd_cb_return(fd, what, cb)
+ *   timer_cb_enter(timer, cb), timer_cb_return(timer, cb)
+ *   fsm_state_chg(fi, fsm_name, old_state, new_state)
+ *   fsm_dispatch_enter(fi, fsm_name, state, event), fsm_dispatch_return(fi, event)
+ *   log(subsys, level, file, line)
+ *   lapd_rx(dl, sapi, format, len), lapd_tx(dl, sapi, len)
+ *   ns_rx(nsei, pdu_type, len), ns_tx(nsei, pdu_type, len)
+ *   bssgp_rx(nsei, bvci, pdu_type, len), bssgp_tx(nsei, bvci, pdu_type, len)
+ */
+
+#pragma once
+
+#include "../config.h"
+
+#ifdef HAVE_USDT
+
+#include <sys/sdt.h>
+
+#define OSMO_TRACE(name)			DTRACE_PROBE(libosmocore, name)
+#define OSMO_TRACE1(name, a1)			DTRACE_PROBE1(libosmocore, name, a1)
+#define OSMO_TRACE2(name, a1, a2)		DTRACE_PROBE2(libosmocore, name, a1, a2)
+#define OSMO_TRACE3(name, a1, a2, a3)		DTRACE_PROBE3(libosmocore, name, a1, a2, a3)
+#define OSMO_TRACE4(name, a1, a2, a3, a4)	DTRACE_PROBE4(libosmocore, name, a1, a2, a3, a4)
+
+#else
+
+#define OSMO_TRACE(name)			do { } while (0)
+#define OSMO_TRACE1(name, a1)			do { } while (0)
+#define OSMO_TRACE2(name, a1, a2)		do { } while (0)
+#define OSMO_TRACE3(name, a1, a2, a3)		do { } while (0)
+#define OSMO_TRACE4(name, a1, a2, a3, a4)	do { } while (0)
+
+#endif /* HAVE_USDT */
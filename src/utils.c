@@ -27,13 +27,18 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <pthread.h>
 
 #include <osmocom/core/utils.h>
 #include <osmocom/core/bit64gen.h>
 
+#include "../config.h"
+
 
 /*! \addtogroup utils
  * @{
@@ -65,6 +70,288 @@ const char *get_value_string(const struct value_string *vs, uint32_t val)
 	return namebuf;
 }
 
+/* Lookup index of value_string arrays.
+ *
+ * Name functions like get_value_string() are called for every log line.  A
+ * value_string array registered with value_string_index() gets an index: a
+ * direct map from value to entry if the values are reasonably dense,
+ * otherwise an array of (value, entry) sorted by value, plus a hash table of
+ * the case-folded strings for get_string_value().  Indexes are kept in a
+ * process wide table keyed by the array address.  They are only added, under
+ * vs_index_mutex, and never changed or freed afterwards, so lookups need no
+ * locking.  All other arrays are searched linearly.
+ *
+ * The libraries register their own name tables (RSL, TS 04.08, TS 08.08,
+ * GSUP, NS, BSSGP) from constructors, and osmo_fsm_register() registers the
+ * event names of each FSM. */
+
+/* value_string arrays with fewer entries are searched linearly */
+#define VS_INDEX_MIN_ENTRIES	8
+/* number of value_string arrays that can be indexed, power of 2 */
+#define VS_INDEX_SLOTS		256
+/* number of slots probed for an array */
+#define VS_INDEX_PROBES		8
+
+enum vs_index_kind {
+	VS_INDEX_DENSE,
+	VS_INDEX_SORTED,
+};
+
+struct vs_index_ent {
+	uint32_t value;
+	uint32_t idx;
+};
+
+struct vs_index {
+	const struct value_string *vs;
+	/* number of entries before the terminator */
+	uint32_t num;
+	enum vs_index_kind kind;
+	/* DENSE: value of map[0] */
+	uint32_t min;
+	/* DENSE: entries in map; SORTED: entries in sorted */
+	uint32_t len;
+	/* DENSE: entry index + 1 by value - min, 0 if there is none */
+	uint32_t *map;
+	/* SORTED: first entry of each value, sorted by value */
+	struct vs_index_ent *sorted;
+	/* reverse lookup: entry index + 1 by case-folded string hash, 0 if unused */
+	uint32_t *rhash;
+	uint32_t rhash_mask;
+};
+
+static pthread_mutex_t vs_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static void *vs_index_ctx;
+static struct vs_index *vs_index_slots[VS_INDEX_SLOTS];
+
+static inline bool vs_is_end(const struct value_string *vs)
+{
+	return vs->value == 0 && vs->str == NULL;
+}
+
+static inline unsigned int vs_index_hash(const struct value_string *vs)
+{
+	return (((uintptr_t)vs >> 3) * 2654435761u) >> 8;
+}
+
+static int vs_index_ent_cmp(const void *a, const void *b)
+{
+	const struct vs_index_ent *ea = a, *eb = b;
+
+	if (ea->value != eb->value)
+		return ea->value < eb->value ? -1 : 1;
+	return ea->idx < eb->idx ? -1 : (ea->idx > eb->idx);
+}
+
+static uint32_t vs_str_hash(const char *str)
+{
+	uint32_t h = 2166136261u;
+
+	for (; *str; str++)
+		h = (h ^ (uint8_t)tolower((unsigned char)*str)) * 16777619u;
+	return h;
+}
+
+static int vs_index_build_rhash(struct vs_index *vsi)
+{
+	const struct value_string *vs = vsi->vs;
+	uint32_t size = 16, i, j;
+
+	while (size < 2 * vsi->num)
+		size <<= 1;
+	vsi->rhash = talloc_zero_array(vsi, uint32_t, size);
+	if (!vsi->rhash)
+		return -ENOMEM;
+	vsi->rhash_mask = size - 1;
+
+	for (i = 0; i < vsi->num; i++) {
+		if (!vs[i].str)
+			continue;
+		for (j = vs_str_hash(vs[i].str) & vsi->rhash_mask; vsi->rhash[j]; j = (j + 1) & vsi->rhash_mask) {
+			/* the first entry of a string wins, as in a linear search */
+			if (!strcasecmp(vs[vsi->rhash[j] - 1].str, vs[i].str))
+				break;
+		}
+		if (!vsi->rhash[j])
+			vsi->rhash[j] = i + 1;
+	}
+	return 0;
+}
+
+static struct vs_index *vs_index_build(const struct value_string *vs, uint32_t num)
+{
+	struct vs_index *vsi;
+	uint32_t i, min, max;
+	uint64_t span;
+
+	if (!vs_index_ctx) {
+		vs_index_ctx = talloc_named_const(NULL, 0, "value_string_index");
+		if (!vs_index_ctx)
+			return NULL;
+	}
+
+	vsi = talloc_zero(vs_index_ctx, struct vs_index);
+	if (!vsi)
+		return NULL;
+	vsi->vs = vs;
+	vsi->num = num;
+
+	min = max = vs[0].value;
+	for (i = 1; i < num; i++) {
+		min = OSMO_MIN(min, vs[i].value);
+		max = OSMO_MAX(max, vs[i].value);
+	}
+	span = (uint64_t)max - min + 1;
+
+	if (span <= 2 * (uint64_t)num + 32) {
+		vsi->map = talloc_zero_array(vsi, uint32_t, span);
+		if (!vsi->map)
+			goto free_vsi;
+		/* the first entry of a value wins, as in a linear search */
+		for (i = 0; i < num; i++) {
+			if (!vsi->map[vs[i].value - min])
+				vsi->map[vs[i].value - min] = i + 1;
+		}
+		vsi->min = min;
+		vsi->len = span;
+		vsi->kind = VS_INDEX_DENSE;
+	} else {
+		uint32_t n = 0;
+
+		vsi->sorted = talloc_array(vsi, struct vs_index_ent, num);
+		if (!vsi->sorted)
+			goto free_vsi;
+		for (i = 0; i < num; i++)
+			vsi->sorted[i] = (struct vs_index_ent){ .value = vs[i].value, .idx = i };
+		qsort(vsi->sorted, num, sizeof(vsi->sorted[0]), vs_index_ent_cmp);
+		/* keep only the first entry of each value */
+		for (i = 0; i < num; i++) {
+			if (n && vsi->sorted[n - 1].value == vsi->sorted[i].value)
+				continue;
+			vsi->sorted[n++] = vsi->sorted[i];
+		}
+		vsi->len = n;
+		vsi->kind = VS_INDEX_SORTED;
+	}
+
+	if (vs_index_build_rhash(vsi) < 0)
+		goto free_vsi;
+
+	return vsi;
+
+free_vsi:
+	talloc_free(vsi);
+	return NULL;
+}
+
+/*! Build a lookup index for a value_string array
+ *  \param[in] vs Array of value_string tuples
+ *  \returns 0 on success, negative on error
+ *
+ * After this call, get_value_string(), get_value_string_or_null() and
+ * get_string_value() find entries of \a vs by a direct map, a binary search
+ * or a hash lookup instead of a linear search.  The results are the same: the
+ * first entry of a duplicated value or string wins.  Arrays with fewer than 8
+ * entries are not indexed, and calling this again for the same array has no
+ * effect.  On error, lookups keep using the linear search.
+ *
+ * The index is kept, keyed by the address of \a vs, for the lifetime of the
+ * process.  Only pass arrays that are never modified or freed afterwards,
+ * typically static const tables; lookups on an array re-generated at the same
+ * address would return stale results.  This function is thread-safe.
+ */
+int value_string_index(const struct value_string *vs)
+{
+	unsigned int h, i;
+	struct vs_index **slot;
+	struct vs_index *vsi;
+	uint32_t num;
+	int rc = -ENOSPC;
+
+	if (!vs)
+		return -EINVAL;
+
+	for (num = 0; !vs_is_end(&vs[num]); num++);
+	if (num < VS_INDEX_MIN_ENTRIES)
+		return 0;
+
+	h = vs_index_hash(vs);
+	pthread_mutex_lock(&vs_index_mutex);
+	for (i = 0; i < VS_INDEX_PROBES; i++) {
+		slot = &vs_index_slots[(h + i) & (VS_INDEX_SLOTS - 1)];
+		if (*slot && (*slot)->vs == vs) {
+			rc = 0;
+			break;
+		}
+		if (*slot)
+			continue;
+		vsi = vs_index_build(vs, num);
+		if (!vsi) {
+			rc = -ENOMEM;
+			break;
+		}
+		/* publish the index only once it is complete */
+		__atomic_store_n(slot, vsi, __ATOMIC_RELEASE);
+		rc = 0;
+		break;
+	}
+	pthread_mutex_unlock(&vs_index_mutex);
+	return rc;
+}
+
+/* Find the index of a value_string array, NULL if it has none. */
+static const struct vs_index *vs_index_lookup(const struct value_string *vs)
+{
+	unsigned int h = vs_index_hash(vs);
+	unsigned int i;
+
+	for (i = 0; i < VS_INDEX_PROBES; i++) {
+		const struct vs_index *vsi = __atomic_load_n(&vs_index_slots[(h + i) & (VS_INDEX_SLOTS - 1)],
+							     __ATOMIC_ACQUIRE);
+		if (!vsi)
+			return NULL;
+		if (vsi->vs == vs)
+			return vsi;
+	}
+	return NULL;
+}
+
+/*! Return whether a value_string array has a lookup index
+ *  \param[in] vs Array of value_string tuples
+ *  \returns true if value_string_index() has built an index for \a vs
+ */
+bool value_string_indexed(const struct value_string *vs)
+{
+	return vs && vs_index_lookup(vs);
+}
+
+/* Returns the entry index + 1 of val, 0 if there is none. */
+static uint32_t vs_index_find(const struct vs_index *vsi, uint32_t val)
+{
+	uint32_t lo, hi;
+
+	switch (vsi->kind) {
+	case VS_INDEX_DENSE:
+		if (val - vsi->min >= vsi->len)
+			return 0;
+		return vsi->map[val - vsi->min];
+	case VS_INDEX_SORTED:
+		lo = 0;
+		hi = vsi->len;
+		while (lo < hi) {
+			uint32_t mid = lo + (hi - lo) / 2;
+			if (vsi->sorted[mid].value < val)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo < vsi->len && vsi->sorted[lo].value == val)
+			return vsi->sorted[lo].idx + 1;
+		return 0;
+	}
+	return 0;
+}
+
 /*! get human-readable string or NULL for given value
  *  \param[in] vs Array of value_string tuples
  *  \param[in] val Value to be converted
@@ -73,16 +360,24 @@ const char *get_value_string(const struct value_string *vs, uint32_t val)
 const char *get_value_string_or_null(const struct value_string *vs,
 				     uint32_t val)
 {
-	int i;
+	const struct vs_index *vsi;
+	uint32_t i;
+	int j;
 
 	if (!vs)
 		return NULL;
 
-	for (i = 0;; i++) {
-		if (vs[i].value == 0 && vs[i].str == NULL)
+	vsi = vs_index_lookup(vs);
+	if (vsi) {
+		i = vs_index_find(vsi, val);
+		return i ? vs[i - 1].str : NULL;
+	}
+
+	for (j = 0;; j++) {
+		if (vs_is_end(&vs[j]))
 			break;
-		if (vs[i].value == val)
-			return vs[i].str;
+		if (vs[j].value == val)
+			return vs[j].str;
 	}
 
 	return NULL;
@@ -95,10 +390,21 @@ const char *get_value_string_or_null(const struct value_string *vs,
  */
 int get_string_value(const struct value_string *vs, const char *str)
 {
+	const struct vs_index *vsi = vs_index_lookup(vs);
 	int i;
 
+	if (vsi) {
+		uint32_t j;
+
+		for (j = vs_str_hash(str) & vsi->rhash_mask; vsi->rhash[j]; j = (j + 1) & vsi->rhash_mask) {
+			if (!strcasecmp(vs[vsi->rhash[j] - 1].str, str))
+				return vs[vsi->rhash[j] - 1].value;
+		}
+		return -EINVAL;
+	}
+
 	for (i = 0;; i++) {
-		if (vs[i].value == 0 && vs[i].str == NULL)
+		if (vs_is_end(&vs[i]))
 			break;
 		if (!strcasecmp(vs[i].str, str))
 			return vs[i].value;
@@ -234,6 +540,126 @@ int osmo_str2bcd(uint8_t *dst, size_t dst_size, const char *digits, int start_ni
 	return end_nibble / 2;
 }
 
+/* Table-driven and SIMD accelerated hex conversion.
+ *
+ * hexdumps are produced for every logged PDU, so the conversion uses a table
+ * of all 256 two-digit strings, and SSSE3 / AVX2 nibble-to-ASCII conversion
+ * of whole blocks where the CPU supports it.  hexdumps with a single
+ * character delimiter, as by osmo_hexdump(), use SSSE3 only; delimiters of
+ * more than one character are always converted by the table-driven code.  The SIMD functions only handle
+ * complete blocks and return the amount processed; the rest is converted by
+ * the table-driven code, which produces identical output. */
+
+#if defined(HAVE_SSSE3)
+size_t osmo_hex_enc_sse(char *out, const uint8_t *in, size_t len);
+size_t osmo_hex_enc_delim_sse(char *out, const uint8_t *in, size_t len, char delim);
+size_t osmo_hex_dec_sse(uint8_t *out, const char *in, size_t len);
+size_t osmo_ubit_dump_sse(char *out, const uint8_t *bits, size_t len);
+#endif
+
+#if defined(HAVE_SSSE3) && defined(HAVE_AVX2)
+size_t osmo_hex_enc_sse_avx(char *out, const uint8_t *in, size_t len);
+size_t osmo_hex_dec_sse_avx(uint8_t *out, const char *in, size_t len);
+#endif
+
+#define HEX_ROW(h) h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" \
+		   h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+/* two hex digits for each byte value */
+static const char hex_pairs[] =
+	HEX_ROW("0") HEX_ROW("1") HEX_ROW("2") HEX_ROW("3")
+	HEX_ROW("4") HEX_ROW("5") HEX_ROW("6") HEX_ROW("7")
+	HEX_ROW("8") HEX_ROW("9") HEX_ROW("a") HEX_ROW("b")
+	HEX_ROW("c") HEX_ROW("d") HEX_ROW("e") HEX_ROW("f");
+
+#define HEX_INVAL	-1
+#define HEX_SPACE	-2
+/* nibble value of each character, or HEX_INVAL / HEX_SPACE */
+static const int8_t hex_nibbles[256] = {
+	[0 ... 255] = HEX_INVAL,
+	[' '] = HEX_SPACE, ['\t'] = HEX_SPACE, ['\n'] = HEX_SPACE, ['\r'] = HEX_SPACE,
+	['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
+	['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+	['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15,
+	['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15,
+};
+
+/* character of each unpacked bit value */
+static const char ubit_chars[256] = {
+	[0 ... 255] = 'E',
+	[0] = '0', [1] = '1', [0xff] = '?',
+};
+
+static size_t (*hex_enc_simd)(char *out, const uint8_t *in, size_t len);
+static size_t (*hex_enc_delim_simd)(char *out, const uint8_t *in, size_t len, char delim);
+static size_t (*hex_dec_simd)(uint8_t *out, const char *in, size_t len);
+static size_t (*ubit_dump_simd)(char *out, const uint8_t *bits, size_t len);
+/* minimum input length for the SIMD functions */
+static size_t hex_enc_simd_min, hex_dec_simd_min;
+static int hex_simd_init_complete;
+
+static void hex_simd_init(void)
+{
+#if defined(HAVE_SSSE3)
+	int ssse3_supported = 0;
+	int avx2_supported = 0;
+
+#ifdef HAVE___BUILTIN_CPU_SUPPORTS
+	ssse3_supported = __builtin_cpu_supports("ssse3");
+#if defined(HAVE_AVX2)
+	avx2_supported = __builtin_cpu_supports("avx2");
+#endif
+#endif
+
+	if (ssse3_supported) {
+		hex_enc_simd = osmo_hex_enc_sse;
+		hex_enc_simd_min = 16;
+		hex_enc_delim_simd = osmo_hex_enc_delim_sse;
+		hex_dec_simd = osmo_hex_dec_sse;
+		hex_dec_simd_min = 32;
+		ubit_dump_simd = osmo_ubit_dump_sse;
+	}
+#if defined(HAVE_AVX2)
+	if (ssse3_supported && avx2_supported) {
+		hex_enc_simd = osmo_hex_enc_sse_avx;
+		hex_enc_simd_min = 32;
+		hex_dec_simd = osmo_hex_dec_sse_avx;
+		hex_dec_simd_min = 64;
+	}
+#endif
+#endif
+	hex_simd_init_complete = 1;
+}
+
+/* Write two hex digits and delim per byte, without terminating nul */
+static void hex_enc_delim(char *out, const uint8_t *in, size_t len, char delim)
+{
+	size_t i = 0;
+
+	if (!hex_simd_init_complete)
+		hex_simd_init();
+	if (hex_enc_delim_simd && len >= 16)
+		i = hex_enc_delim_simd(out, in, len, delim);
+
+	for (; i < len; i++) {
+		memcpy(out + 3 * i, &hex_pairs[2 * in[i]], 2);
+		out[3 * i + 2] = delim;
+	}
+}
+
+/* Write two hex digits per byte, without delimiter or terminating nul */
+static void hex_enc(char *out, const uint8_t *in, size_t len)
+{
+	size_t i = 0;
+
+	if (!hex_simd_init_complete)
+		hex_simd_init();
+	if (hex_enc_simd && len >= hex_enc_simd_min)
+		i = hex_enc_simd(out, in, len);
+
+	for (; i < len; i++)
+		memcpy(out + 2 * i, &hex_pairs[2 * in[i]], 2);
+}
+
 /*! Parse a string containing hexadecimal digits
  *  \param[in] str string containing ASCII encoded hexadecimal digits
  *  \param[out] b output buffer
@@ -243,29 +669,44 @@ int osmo_str2bcd(uint8_t *dst, size_t dst_size, const char *digits, int start_ni
 int osmo_hexparse(const char *str, uint8_t *b, int max_len)
 
 {
-	char c;
-	uint8_t v;
-	const char *strpos;
+	size_t str_len = strlen(str);
+	size_t i, simd_from = 0;
 	unsigned int nibblepos = 0;
+	int8_t v;
 
 	memset(b, 0x00, max_len);
 
-	for (strpos = str; (c = *strpos); strpos++) {
+	if (!hex_simd_init_complete)
+		hex_simd_init();
+
+	for (i = 0; i < str_len; i++) {
+		/* convert runs of hex digits starting at an octet boundary in blocks */
+		if (hex_dec_simd && i >= simd_from && !(nibblepos & 1)
+		    && str_len - i >= hex_dec_simd_min && nibblepos < (max_len << 1)) {
+			size_t n = hex_dec_simd(b + (nibblepos >> 1), str + i,
+						OSMO_MIN(str_len - i, (size_t)(max_len << 1) - nibblepos));
+			if (n) {
+				i += 2 * n;
+				nibblepos += 2 * n;
+				if (i >= str_len)
+					break;
+			} else {
+				/* no complete block here, don't retry before the next one */
+				simd_from = i + hex_dec_simd_min;
+			}
+		}
+
+		v = hex_nibbles[(uint8_t)str[i]];
+
 		/* skip whitespace */
-		if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+		if (v == HEX_SPACE)
 			continue;
 
 		/* If the buffer is too small, error out */
 		if (nibblepos >= (max_len << 1))
 			return -1;
 
-		if (c >= '0' && c <= '9')
-			v = c - '0';
-		else if (c >= 'a' && c <= 'f')
-			v = 10 + (c - 'a');
-		else if (c >= 'A' && c <= 'F')
-			v = 10 + (c - 'A');
-		else
+		if (v == HEX_INVAL)
 			return -1;
 
 		b[nibblepos >> 1] |= v << (nibblepos & 1 ? 0 : 4);
@@ -281,7 +722,6 @@ int osmo_hexparse(const char *str, uint8_t *b, int max_len)
 }
 
 static __thread char hexd_buff[4096];
-static const char hex_chars[] = "0123456789abcdef";
 
 /*! Convert binary sequence to hexadecimal ASCII string.
  *  \param[out] out_buf  Output buffer to write the resulting string to.
@@ -302,32 +742,41 @@ static const char hex_chars[] = "0123456789abcdef";
 const char *osmo_hexdump_buf(char *out_buf, size_t out_buf_size, const unsigned char *buf, int len, const char *delim,
 			     bool delim_after_last)
 {
-	int i;
 	char *cur = out_buf;
-	size_t delim_len;
+	size_t delim_len, step, avail, n, n_delim, i;
 
 	if (!out_buf || !out_buf_size)
 		return "";
 
 	delim = delim ? : "";
 	delim_len = strlen(delim);
+	step = 2 + delim_len;
+	avail = out_buf_size - 1;
+
+	/* Number of bytes that fit, each one followed by delim.  Without delim_after_last, the last byte may also
+	 * fit without its delim; if not all bytes fit, the string ends in a delim either way. */
+	n = len > 0 ? OSMO_MIN((size_t)len, avail / step) : 0;
+	n_delim = n;
+	if (len > 0 && !delim_after_last && n >= (size_t)len - 1 && avail - ((size_t)len - 1) * step >= 2) {
+		n = len;
+		n_delim = len - 1;
+	}
 
-	for (i = 0; i < len; i++) {
-		const char *delimp = delim;
-		int len_remain = out_buf_size - (cur - out_buf) - 1;
-		if (len_remain < (2 + delim_len)
-		    && !(!delim_after_last && i == (len - 1) && len_remain >= 2))
-			break;
-
-		*cur++ = hex_chars[buf[i] >> 4];
-		*cur++ = hex_chars[buf[i] & 0xf];
-
-		if (i == (len - 1) && !delim_after_last)
-			break;
-
-		while (len_remain > 1 && *delimp) {
-			*cur++ = *delimp++;
-			len_remain--;
+	if (!delim_len) {
+		hex_enc(cur, buf, n);
+		cur += 2 * n;
+	} else if (delim_len == 1) {
+		/* the last delim is overwritten by the nul if there is none */
+		hex_enc_delim(cur, buf, n, delim[0]);
+		cur += 3 * n - (n - n_delim);
+	} else {
+		for (i = 0; i < n; i++) {
+			memcpy(cur, &hex_pairs[2 * buf[i]], 2);
+			cur += 2;
+			if (i < n_delim) {
+				memcpy(cur, delim, delim_len);
+				cur += delim_len;
+			}
 		}
 	}
 	*cur = '\0';
@@ -343,31 +792,19 @@ const char *osmo_hexdump_buf(char *out_buf, size_t out_buf_size, const unsigned
  */
 char *osmo_ubit_dump_buf(char *buf, size_t buf_len, const uint8_t *bits, unsigned int len)
 {
-	int i;
+	size_t i = 0;
 
 	if (len > buf_len-1)
 		len = buf_len-1;
-	memset(buf, 0, buf_len);
 
-	for (i = 0; i < len; i++) {
-		char outch;
-		switch (bits[i]) {
-		case 0:
-			outch = '0';
-			break;
-		case 0xff:
-			outch = '?';
-			break;
-		case 1:
-			outch = '1';
-			break;
-		default:
-			outch = 'E';
-			break;
-		}
-		buf[i] = outch;
-	}
-	buf[buf_len-1] = 0;
+	if (!hex_simd_init_complete)
+		hex_simd_init();
+	if (ubit_dump_simd)
+		i = ubit_dump_simd(buf, bits, len);
+
+	for (; i < len; i++)
+		buf[i] = ubit_chars[bits[i]];
+	buf[len] = '\0';
 	return buf;
 }
 
@@ -468,7 +905,6 @@ char *osmo_osmo_hexdump_nospc(const unsigned char *buf, int len)
 	__attribute__((weak, alias("osmo_hexdump_nospc")));
 #endif
 
-#include "../config.h"
 #ifdef HAVE_CTYPE_H
 #include <ctype.h>
 /*! Convert an entire string to lower case
@@ -24,6 +24,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "../../config.h"
 
@@ -37,11 +38,13 @@
 #include <osmocom/core/stats.h>
 #include <osmocom/core/counter.h>
 #include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/loop_stats.h>
 
 #define CFG_STATS_STR "Configure stats sub-system\n"
 #define CFG_REPORTER_STR "Configure a stats reporter\n"
 
 #define SHOW_STATS_STR "Show statistical values\n"
+#define MAIN_LOOP_STR "Main loop profiling\n" "Main loop statistics\n"
 
 /*! \file stats_vty.c
  *  VTY interface for statsd / statistic items
@@ -392,6 +395,101 @@ DEFUN(show_stats_level,
 	return CMD_SUCCESS;
 }
 
+static void vty_out_loop_hist(struct vty *vty, const char *prefix, const uint32_t *hist)
+{
+	unsigned int i;
+
+	vty_out(vty, "%s", prefix);
+	for (i = 0; i < OSMO_LOOP_STATS_HIST_BUCKETS; i++) {
+		if (!hist[i])
+			continue;
+		if (i == OSMO_LOOP_STATS_HIST_BUCKETS - 1)
+			vty_out(vty, " >=%uus:%u", osmo_loop_stats_hist_bucket_us(i - 1), hist[i]);
+		else
+			vty_out(vty, " <%uus:%u", osmo_loop_stats_hist_bucket_us(i), hist[i]);
+	}
+	vty_out(vty, "%s", VTY_NEWLINE);
+}
+
+DEFUN(show_main_loop_stats,
+      show_main_loop_stats_cmd,
+      "show main-loop stats",
+      SHOW_STR MAIN_LOOP_STR)
+{
+	const struct osmo_loop_stats *ls = osmo_loop_stats_get();
+	unsigned int i;
+
+	if (!ls) {
+		vty_out(vty, "%% Main loop profiling is disabled%s", VTY_NEWLINE);
+		return CMD_WARNING;
+	}
+
+	vty_out(vty, "Main loop: %" PRIu64 " iterations, busy %" PRIu64 " us (max %u us), waiting %" PRIu64 " us%s",
+		ls->iterations, ls->busy_us, ls->busy_max_us, ls->wait_us, VTY_NEWLINE);
+	vty_out_loop_hist(vty, "  busy:", ls->busy_hist);
+	vty_out_loop_hist(vty, "  wait:", ls->wait_hist);
+	vty_out(vty, "Slow call-backs (above %u us): %" PRIu64 ", untracked call-backs: %" PRIu64 "%s",
+		ls->slow_threshold_us, ls->slow, ls->untracked, VTY_NEWLINE);
+
+	for (i = 0; i < OSMO_LOOP_STATS_MAX_CBS; i++) {
+		const struct osmo_loop_cb_stats *cs = &ls->cbs[i];
+		if (!cs->count)
+			continue;
+		if (cs->type == OSMO_LOOP_CB_FD)
+			vty_out(vty, " fd %d call-back %p:", cs->fd, cs->cb);
+		else
+			vty_out(vty, " timer call-back %p:", cs->cb);
+		vty_out(vty, " %" PRIu64 " calls, avg %" PRIu64 " us, max %u us, slow %u%s",
+			cs->count, cs->total_us / cs->count, cs->max_us, cs->slow, VTY_NEWLINE);
+		vty_out_loop_hist(vty, "  ", cs->hist);
+	}
+
+	return CMD_SUCCESS;
+}
+
+DEFUN(main_loop_stats_enable,
+      main_loop_stats_enable_cmd,
+      "main-loop stats enable [<0-60000000>]",
+      MAIN_LOOP_STR
+      "Enable main loop profiling\n"
+      "Log call-backs running longer than this many microseconds, 0 to never log\n")
+{
+	const struct osmo_loop_stats *stats = osmo_loop_stats_get();
+	unsigned int threshold;
+	int rc;
+
+	/* keep the current threshold if profiling is enabled already */
+	if (argc > 0)
+		threshold = atoi(argv[0]);
+	else
+		threshold = stats ? stats->slow_threshold_us : 0;
+
+	rc = osmo_loop_stats_enable(tall_vty_ctx, threshold);
+
+	if (rc < 0) {
+		vty_out(vty, "%% Unable to enable main loop profiling: %s%s",
+			strerror(-rc), VTY_NEWLINE);
+		return CMD_WARNING;
+	}
+
+	return CMD_SUCCESS;
+}
+
+DEFUN(main_loop_stats_disable,
+      main_loop_stats_disable_cmd,
+      "main-loop stats (disable|reset)",
+      MAIN_LOOP_STR
+      "Disable main loop profiling and discard the statistics\n"
+      "Clear the main loop statistics\n")
+{
+	if (!strcmp(argv[0], "disable"))
+		osmo_loop_stats_disable();
+	else
+		osmo_loop_stats_reset();
+
+	return CMD_SUCCESS;
+}
+
 static int asciidoc_handle_counter(struct osmo_counter *counter, void *sctx_)
 {
 	struct vty *vty = sctx_;
@@ -666,4 +764,8 @@ void osmo_stats_vty_add_cmds()
 
 	install_element_ve(&show_stats_asciidoc_table_cmd);
 	install_element_ve(&show_rate_counters_cmd);
+
+	install_element_ve(&show_main_loop_stats_cmd);
+	install_element(ENABLE_NODE, &main_loop_stats_enable_cmd);
+	install_element(ENABLE_NODE, &main_loop_stats_disable_cmd);
 }
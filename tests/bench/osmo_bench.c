@@ -0,0 +1,601 @@
+/* Micro benchmarks of libosmocore hot paths, with JSON output.  Not part
+ * of the testsuite, as its output depends on the machine it is run on;
+ * run it with 'make bench'. */
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <osmocom/core/bits.h>
+#include <osmocom/core/conv.h>
+#include <osmocom/core/crc16.h>
+#include <osmocom/core/crc64gen.h>
+#include <osmocom/core/isdnhdlc.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/msgb.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/codec/codec.h>
+#include <osmocom/gsm/a5.h>
+#include <osmocom/gsm/gsm0503.h>
+#include <osmocom/gsm/gsm_utils.h>
+#include <osmocom/gsm/tlv.h>
+#include <osmocom/gsm/protocol/gsm_04_08.h>
+#include <osmocom/crypt/auth.h>
+#include <osmocom/coding/gsm0503_coding.h>
+#include <osmocom/coding/gsm0503_parity.h>
+
+struct bench {
+	const char *name;
+	/* bytes processed per operation, 0 if not meaningful */
+	unsigned int bytes;
+	void (*setup)(void);
+	void (*run)(unsigned int n);
+	void (*teardown)(void);
+};
+
+/* results are accumulated here, so that the compiler cannot drop the work */
+static volatile unsigned int sink;
+
+static uint8_t bytes_in[1024];
+static ubit_t ubits[1024];
+static sbit_t sbits[1024];
+static uint8_t bytes_out[1024];
+
+static void fill_random(void)
+{
+	unsigned int i;
+
+	srand(0x2342);
+	for (i = 0; i < sizeof(bytes_in); i++)
+		bytes_in[i] = rand();
+	for (i = 0; i < ARRAY_SIZE(ubits); i++)
+		ubits[i] = rand() & 1;
+	for (i = 0; i < ARRAY_SIZE(sbits); i++)
+		sbits[i] = ubits[i] ? -127 : 127;
+}
+
+/* convolutional code, osmo_conv_decode() uses the accelerated decoder */
+
+static void run_conv_decode_xcch(unsigned int n)
+{
+	while (n--)
+		sink += osmo_conv_decode(&gsm0503_xcch, sbits, ubits + 512);
+}
+
+static void run_conv_encode_xcch(unsigned int n)
+{
+	while (n--)
+		sink += osmo_conv_encode(&gsm0503_xcch, ubits, ubits + 512);
+}
+
+/* channel coding */
+
+static void run_gsm0503_xcch_encode(unsigned int n)
+{
+	while (n--)
+		sink += gsm0503_xcch_encode(ubits, bytes_in);
+}
+
+static void run_gsm0503_xcch_decode(unsigned int n)
+{
+	int n_errors, n_bits_total;
+
+	while (n--)
+		sink += gsm0503_xcch_decode(bytes_out, sbits, &n_errors, &n_bits_total);
+}
+
+static void run_gsm0503_tch_fr_encode(unsigned int n)
+{
+	while (n--)
+		sink += gsm0503_tch_fr_encode(ubits, bytes_in, GSM_FR_BYTES, 1);
+}
+
+static void run_gsm0503_tch_fr_decode(unsigned int n)
+{
+	int n_errors, n_bits_total;
+
+	while (n--)
+		sink += gsm0503_tch_fr_decode(bytes_out, sbits, 1, 0, &n_errors, &n_bits_total);
+}
+
+/* bit packing and CRC */
+
+static void run_ubit2pbit(unsigned int n)
+{
+	while (n--)
+		sink += osmo_ubit2pbit(bytes_out, ubits, 456);
+}
+
+static void run_pbit2ubit(unsigned int n)
+{
+	while (n--)
+		sink += osmo_pbit2ubit(ubits + 512, bytes_in, 456);
+}
+
+static void run_crc16(unsigned int n)
+{
+	while (n--)
+		sink += osmo_crc16(0xffff, bytes_in, sizeof(bytes_in));
+}
+
+static void run_crc40_fire_bits(unsigned int n)
+{
+	while (n--)
+		sink += osmo_crc64gen_compute_bits(&gsm0503_fire_crc40, ubits, 184);
+}
+
+/* ciphering and authentication */
+
+static void run_a5_1(unsigned int n)
+{
+	ubit_t dl[114], ul[114];
+	uint32_t fn = 0;
+
+	while (n--)
+		sink += osmo_a5(1, bytes_in, fn++ & 0x3fffff, dl, ul);
+}
+
+static void run_a5_3(unsigned int n)
+{
+	ubit_t dl[114], ul[114];
+	uint32_t fn = 0;
+
+	while (n--)
+		sink += osmo_a5(3, bytes_in, fn++ & 0x3fffff, dl, ul);
+}
+
+static void run_milenage(unsigned int n)
+{
+	struct osmo_sub_auth_data aud = {
+		.type = OSMO_AUTH_TYPE_UMTS,
+		.algo = OSMO_AUTH_ALG_MILENAGE,
+	};
+	struct osmo_auth_vector vec;
+
+	memcpy(aud.u.umts.opc, bytes_in, 16);
+	memcpy(aud.u.umts.k, bytes_in + 16, 16);
+	aud.u.umts.ind_bitlen = 5;
+	while (n--)
+		sink += osmo_auth_gen_vec(&vec, &aud, bytes_in + 32);
+}
+
+/* TLV parsing */
+
+static const struct tlv_definition bench_tlvdef = {
+	.def = {
+		[0x01] = { TLV_TYPE_TV },
+		[0x02] = { TLV_TYPE_FIXED, 4 },
+		[0x03] = { TLV_TYPE_TLV },
+		[0x04] = { TLV_TYPE_TvLV },
+		[0x05] = { TLV_TYPE_TL16V },
+		[0x06] = { TLV_TYPE_TLV },
+	},
+};
+static uint8_t tlv_buf[256];
+static unsigned int tlv_len;
+
+static void setup_tlv_parse(void)
+{
+	uint8_t *p = tlv_buf;
+
+	p = tv_put(p, 0x01, 0x42);
+	p = tv_fixed_put(p, 0x02, 4, bytes_in);
+	p = tlv_put(p, 0x03, 16, bytes_in);
+	p = tvlv_put(p, 0x04, 8, bytes_in);
+	p = tl16v_put(p, 0x05, 32, bytes_in);
+	p = tlv_put(p, 0x06, 2, bytes_in);
+	tlv_len = p - tlv_buf;
+}
+
+static void run_tlv_parse(unsigned int n)
+{
+	struct tlv_parsed tp;
+
+	while (n--)
+		sink += tlv_parse(&tp, &bench_tlvdef, tlv_buf, tlv_len, 0, 0);
+}
+
+/* hexdumps of PDUs in log lines */
+static void run_hexdump(unsigned int n)
+{
+	while (n--)
+		sink += osmo_hexdump(bytes_in, 256)[0];
+}
+
+static void run_hexdump_nospc(unsigned int n)
+{
+	while (n--)
+		sink += osmo_hexdump_nospc(bytes_in, 256)[0];
+}
+
+static char hex_str[2 * 256 + 1];
+
+static void setup_hexparse(void)
+{
+	osmo_strlcpy(hex_str, osmo_hexdump_nospc(bytes_in, 256), sizeof(hex_str));
+}
+
+static void run_hexparse(unsigned int n)
+{
+	while (n--)
+		sink += osmo_hexparse(hex_str, bytes_out, 256);
+}
+
+/* SMS text, GSM 7-bit default alphabet */
+
+static char sms_text[160 + 1];
+static uint8_t sms_coded[140];
+
+static void setup_gsm_7bit(void)
+{
+	static const char charset[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 .,:!?";
+	unsigned int i;
+	int octets;
+
+	for (i = 0; i < sizeof(sms_text) - 1; i++)
+		sms_text[i] = charset[bytes_in[i] % (sizeof(charset) - 1)];
+	sms_text[sizeof(sms_text) - 1] = '\0';
+	gsm_7bit_encode_n(sms_coded, sizeof(sms_coded), sms_text, &octets);
+}
+
+static void run_gsm_7bit_encode(unsigned int n)
+{
+	int octets;
+
+	while (n--)
+		sink += gsm_7bit_encode_n(sms_coded, sizeof(sms_coded), sms_text, &octets);
+}
+
+static void run_gsm_7bit_decode(unsigned int n)
+{
+	char text[sizeof(sms_text)];
+
+	while (n--)
+		sink += gsm_7bit_decode_n(text, sizeof(text), sms_coded, sizeof(sms_text) - 1);
+}
+
+/* ISDN HDLC framing of a 260 byte frame */
+
+#define HDLC_FRAME_LEN	260
+static struct osmo_isdnhdlc_vars hdlc_enc, hdlc_dec;
+static uint8_t hdlc_stream[HDLC_FRAME_LEN * 2 + 8];
+static int hdlc_stream_len;
+
+/* encode one frame including its closing flag, returns the stream length */
+static int hdlc_encode_frame(void)
+{
+	const uint8_t *src = bytes_in;
+	int len = HDLC_FRAME_LEN, count, stream_len = 0;
+
+	while (len > 0) {
+		stream_len += osmo_isdnhdlc_encode(&hdlc_enc, src, len, &count, hdlc_stream + stream_len,
+						   sizeof(hdlc_stream) - stream_len);
+		src += count;
+		len -= count;
+	}
+	stream_len += osmo_isdnhdlc_encode(&hdlc_enc, NULL, 0, &count, hdlc_stream + stream_len, 1);
+	return stream_len;
+}
+
+static void setup_isdnhdlc(void)
+{
+	osmo_isdnhdlc_out_init(&hdlc_enc, OSMO_HDLC_F_BITREVERSE);
+	osmo_isdnhdlc_rcv_init(&hdlc_dec, OSMO_HDLC_F_BITREVERSE);
+	hdlc_stream_len = hdlc_encode_frame();
+}
+
+static void run_isdnhdlc_encode(unsigned int n)
+{
+	while (n--)
+		sink += hdlc_encode_frame();
+}
+
+static void run_isdnhdlc_decode(unsigned int n)
+{
+	uint8_t out[HDLC_FRAME_LEN * 2];
+
+	while (n--) {
+		int offset = 0;
+
+		while (offset < hdlc_stream_len) {
+			int count;
+			sink += osmo_isdnhdlc_decode(&hdlc_dec, hdlc_stream + offset, hdlc_stream_len - offset,
+						     &count, out, sizeof(out));
+			offset += count;
+		}
+	}
+}
+
+/* msgb */
+
+static void run_msgb_alloc_free(unsigned int n)
+{
+	while (n--) {
+		struct msgb *msg = msgb_alloc_headroom(1024, 128, "bench");
+		sink += msgb_tailroom(msg);
+		msgb_free(msg);
+	}
+}
+
+/* timers: reschedule timers within a tree of pending ones */
+
+#define NUM_TIMERS	1024
+static struct osmo_timer_list timers[NUM_TIMERS];
+static int timer_usecs[NUM_TIMERS];
+
+static void timer_cb(void *data)
+{
+}
+
+static void setup_timer(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < NUM_TIMERS; i++) {
+		osmo_timer_setup(&timers[i], timer_cb, NULL);
+		timer_usecs[i] = rand() % 1000000;
+		osmo_timer_schedule(&timers[i], 10, timer_usecs[i]);
+	}
+}
+
+static void run_timer_reschedule(unsigned int n)
+{
+	unsigned int i = 0;
+
+	while (n--) {
+		osmo_timer_schedule(&timers[i], 10, timer_usecs[(i * 7) % NUM_TIMERS]);
+		i = (i + 1) % NUM_TIMERS;
+	}
+}
+
+static void teardown_timer(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < NUM_TIMERS; i++)
+		osmo_timer_del(&timers[i]);
+}
+
+/* select loop: one readable pipe per iteration */
+
+static int pipe_fds[2];
+static struct osmo_fd pipe_ofd;
+
+static int pipe_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	uint8_t c;
+
+	sink += read(ofd->fd, &c, 1);
+	return 0;
+}
+
+static void setup_select(void)
+{
+	OSMO_ASSERT(pipe(pipe_fds) == 0);
+	osmo_fd_setup(&pipe_ofd, pipe_fds[0], OSMO_FD_READ, pipe_cb, NULL, 0);
+	OSMO_ASSERT(osmo_fd_register(&pipe_ofd) == 0);
+}
+
+static void run_select_dispatch(unsigned int n)
+{
+	while (n--) {
+		sink += write(pipe_fds[1], "x", 1);
+		osmo_select_main(1);
+	}
+}
+
+static void teardown_select(void)
+{
+	osmo_fd_unregister(&pipe_ofd);
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+/* logging: a message that is filtered out, and one that is formatted */
+
+enum {
+	DBENCH,
+};
+
+static const struct log_info_cat bench_log_cat[] = {
+	[DBENCH] = {
+		.name = "DBENCH",
+		.loglevel = LOGL_NOTICE,
+		.enabled = 1,
+	},
+};
+
+static const struct log_info bench_log_info = {
+	.cat = bench_log_cat,
+	.num_cat = ARRAY_SIZE(bench_log_cat),
+};
+
+static void log_output(struct log_target *target, unsigned int level, const char *string)
+{
+	sink += string[0];
+}
+
+static void run_logging_filtered(unsigned int n)
+{
+	while (n--)
+		LOGP(DBENCH, LOGL_DEBUG, "filtered message %u\n", n);
+}
+
+static void run_logging_output(unsigned int n)
+{
+	while (n--)
+		LOGP(DBENCH, LOGL_NOTICE, "formatted message %u\n", n);
+}
+
+static const struct bench benches[] = {
+	{ "conv_decode_xcch",		228 / 8,	NULL,		run_conv_decode_xcch },
+	{ "conv_encode_xcch",		228 / 8,	NULL,		run_conv_encode_xcch },
+	{ "gsm0503_xcch_encode",	GSM_MACBLOCK_LEN, NULL,		run_gsm0503_xcch_encode },
+	{ "gsm0503_xcch_decode",	GSM_MACBLOCK_LEN, NULL,		run_gsm0503_xcch_decode },
+	{ "gsm0503_tch_fr_encode",	GSM_FR_BYTES,	NULL,		run_gsm0503_tch_fr_encode },
+	{ "gsm0503_tch_fr_decode",	GSM_FR_BYTES,	NULL,		run_gsm0503_tch_fr_decode },
+	{ "ubit2pbit_456",		57,		NULL,		run_ubit2pbit },
+	{ "pbit2ubit_456",		57,		NULL,		run_pbit2ubit },
+	{ "crc16_1024",			1024,		NULL,		run_crc16 },
+	{ "crc40_fire_184bits",		23,		NULL,		run_crc40_fire_bits },
+	{ "a5_1",			0,		NULL,		run_a5_1 },
+	{ "a5_3",			0,		NULL,		run_a5_3 },
+	{ "milenage_gen_vec",		0,		NULL,		run_milenage },
+	{ "tlv_parse",			0,		setup_tlv_parse, run_tlv_parse },
+	{ "gsm_7bit_encode_160",	160,		setup_gsm_7bit,	run_gsm_7bit_encode },
+	{ "gsm_7bit_decode_160",	160,		setup_gsm_7bit,	run_gsm_7bit_decode },
+	{ "isdnhdlc_encode_260",	HDLC_FRAME_LEN,	setup_isdnhdlc,	run_isdnhdlc_encode },
+	{ "isdnhdlc_decode_260",	HDLC_FRAME_LEN,	setup_isdnhdlc,	run_isdnhdlc_decode },
+	{ "hexdump_256",		256,		NULL,		run_hexdump },
+	{ "hexdump_nospc_256",		256,		NULL,		run_hexdump_nospc },
+	{ "hexparse_256",		256,		setup_hexparse,	run_hexparse },
+	{ "msgb_alloc_free",		0,		NULL,		run_msgb_alloc_free },
+	{ "timer_reschedule_1024",	0,		setup_timer,	run_timer_reschedule, teardown_timer },
+	{ "select_dispatch",		0,		setup_select,	run_select_dispatch, teardown_select },
+	{ "logging_filtered",		0,		NULL,		run_logging_filtered },
+	{ "logging_output",		0,		NULL,		run_logging_output },
+};
+
+static double elapsed(const struct timespec *a, const struct timespec *b)
+{
+	return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1e9;
+}
+
+/* run a benchmark with a doubling number of operations until it takes at
+ * least min_secs, returns the number of operations and their duration */
+static unsigned long run_bench(const struct bench *b, double min_secs, double *secs)
+{
+	struct timespec t0, t1;
+	unsigned long n = 1;
+
+	if (b->setup)
+		b->setup();
+
+	while (1) {
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		b->run(n);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		*secs = elapsed(&t0, &t1);
+		if (*secs >= min_secs || n >= (1UL << 31))
+			break;
+		/* aim a bit beyond min_secs, but grow at most 16 fold */
+		if (*secs * 16 > min_secs * 1.2)
+			n = n * (min_secs * 1.2) / *secs + 1;
+		else
+			n *= 16;
+	}
+
+	if (b->teardown)
+		b->teardown();
+	return n;
+}
+
+static void print_json_str(const char *str)
+{
+	putchar('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			putchar('\\');
+		if ((unsigned char)*str >= 0x20)
+			putchar(*str);
+	}
+	putchar('"');
+}
+
+static void print_help(void)
+{
+	printf("Usage: osmo-bench [-f FILTER] [-t MSECS] [-l LABEL] [-L]\n"
+	       "  -f FILTER   only run benchmarks whose name contains FILTER\n"
+	       "  -t MSECS    minimum run time of each benchmark (default 200)\n"
+	       "  -l LABEL    label to put into the output, e.g. a version\n"
+	       "  -L          list the benchmarks\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = NULL, *label = "";
+	double min_secs = 0.2;
+	struct log_target *tgt;
+	unsigned int i;
+	bool first = true;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:t:l:Lh")) != -1) {
+		switch (opt) {
+		case 'f':
+			filter = optarg;
+			break;
+		case 't':
+			min_secs = atoi(optarg) / 1000.0;
+			break;
+		case 'l':
+			label = optarg;
+			break;
+		case 'L':
+			for (i = 0; i < ARRAY_SIZE(benches); i++)
+				printf("%s\n", benches[i].name);
+			return 0;
+		default:
+			print_help();
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	log_init(&bench_log_info, NULL);
+	tgt = log_target_create();
+	OSMO_ASSERT(tgt);
+	tgt->output = log_output;
+	log_set_all_filter(tgt, 1);
+	log_add_target(tgt);
+
+	fill_random();
+
+	printf("{\n  \"label\": ");
+	print_json_str(label);
+	printf(",\n  \"benchmarks\": [");
+	for (i = 0; i < ARRAY_SIZE(benches); i++) {
+		const struct bench *b = &benches[i];
+		unsigned long n;
+		double secs, ns_per_op;
+
+		if (filter && !strstr(b->name, filter))
+			continue;
+
+		n = run_bench(b, min_secs, &secs);
+		ns_per_op = secs * 1e9 / n;
+
+		printf("%s\n    { \"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f",
+		       first ? "" : ",", b->name, n, ns_per_op, n / secs);
+		if (b->bytes)
+			printf(", \"mbytes_per_sec\": %.2f", b->bytes * (n / secs) / 1e6);
+		printf(" }");
+		fflush(stdout);
+		first = false;
+	}
+	printf("\n  ]\n}\n");
+
+	return 0;
+}
@@ -261,6 +261,59 @@ static void test_bitvec_read_field(void)
 	_bitvec_read_field(8 * 8, 16); /* 16 bits past */
 }
 
+static void test_bitvec_fields_unaligned(void)
+{
+	uint8_t data[10], ref_data[10];
+	struct bitvec bv = { .data_len = sizeof(data), .data = data };
+	struct bitvec ref = { .data_len = sizeof(ref_data), .data = ref_data };
+	const uint64_t val = 0x0123456789abcdefULL;
+	unsigned int offs, i, idx;
+	uint64_t field;
+	int rc;
+
+	for (offs = 0; offs < 8; offs++) {
+		/* a 64 bit field at a non-zero offset spans nine octets */
+		memset(data, 0xff, sizeof(data));
+		idx = offs;
+		OSMO_ASSERT(bitvec_write_field(&bv, &idx, val, 64) == 0);
+		OSMO_ASSERT(idx == offs + 64);
+		idx = offs;
+		field = bitvec_read_field(&bv, &idx, 64);
+		printf("offs=%u: %s -> %016" PRIx64 "\n", offs, osmo_hexdump_nospc(data, sizeof(data)), field);
+		OSMO_ASSERT(field == val);
+
+		/* L/H bits must match the bit by bit encoding */
+		memset(data, 0, sizeof(data));
+		memset(ref_data, 0, sizeof(ref_data));
+		bv.cur_bit = offs;
+		ref.cur_bit = offs;
+		OSMO_ASSERT(bitvec_set_u64(&bv, val, 64, true) == 0);
+		for (i = 0; i < 64; i++)
+			bitvec_set_bit(&ref, (val >> (63 - i)) & 1 ? H : L);
+		OSMO_ASSERT(bv.cur_bit == ref.cur_bit);
+		printf("offs=%u: %s (L/H)\n", offs, osmo_hexdump_nospc(data, sizeof(data)));
+		OSMO_ASSERT(memcmp(data, ref_data, sizeof(data)) == 0);
+
+		/* and read back the same value */
+		bv.cur_bit = offs;
+		OSMO_ASSERT(bitvec_get_u64(&bv, &field, 64, true) == 0);
+		OSMO_ASSERT(bv.cur_bit == offs + 64);
+		OSMO_ASSERT(field == val);
+	}
+
+	/* writing past the end fills up to the end of the vector and fails */
+	memset(data, 0, sizeof(data));
+	idx = sizeof(data) * 8 - 4;
+	rc = bitvec_write_field(&bv, &idx, 0xff, 8);
+	printf("write past end: %d, idx=%u, cur_bit=%u\n", rc, idx, bv.cur_bit);
+	printf("%s\n", osmo_hexdump_nospc(data, sizeof(data)));
+
+	/* reading past the end fails without moving */
+	bv.cur_bit = sizeof(data) * 8 - 4;
+	rc = bitvec_get_u64(&bv, &field, 8, false);
+	printf("read past end: %d, cur_bit=%u\n", rc, bv.cur_bit);
+}
+
 int main(int argc, char **argv)
 {
 	struct bitvec bv;
@@ -373,6 +426,9 @@ int main(int argc, char **argv)
 	printf("\ntest bitvec_read_field():\n");
 	test_bitvec_read_field();
 
+	printf("\ntest unaligned 64 bit fields:\n");
+	test_bitvec_fields_unaligned();
+
 	printf("\nbitvec ok.\n");
 	return 0;
 }
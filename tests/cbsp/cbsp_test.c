@@ -0,0 +1,136 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/msgb.h>
+#include <osmocom/core/talloc.h>
+
+#include <osmocom/gsm/cbsp.h>
+
+static void add_cells(void *ctx, struct osmo_cbsp_cell_list *cl, uint16_t lac, unsigned int num)
+{
+	unsigned int i;
+
+	cl->id_discr = CELL_IDENT_LAC_AND_CI;
+	for (i = 0; i < num; i++) {
+		struct osmo_cbsp_cell_ent *ent = talloc_zero(ctx, struct osmo_cbsp_cell_ent);
+		ent->cell_id.lac_and_ci.lac = lac;
+		ent->cell_id.lac_and_ci.ci = 100 + i;
+		llist_add_tail(&ent->list, &cl->list);
+	}
+}
+
+/* the template must produce the same PDU as osmo_cbsp_encode() for any cell list */
+static void test_write_replace_tmpl(void *ctx, struct osmo_cbsp_decoded *wr)
+{
+	struct osmo_cbsp_write_replace_tmpl *tmpl;
+	struct msgb *ref, *msg;
+	unsigned int i;
+
+	tmpl = osmo_cbsp_write_replace_tmpl_alloc(ctx, &wr->u.write_replace);
+	OSMO_ASSERT(tmpl);
+
+	for (i = 0; i < 3; i++) {
+		/* the entries of the previous list are freed along with wr */
+		INIT_LLIST_HEAD(&wr->u.write_replace.cell_list.list);
+		add_cells(wr, &wr->u.write_replace.cell_list, 1000 + i, i * 2);
+
+		ref = osmo_cbsp_encode(ctx, wr);
+		msg = osmo_cbsp_encode_write_replace_tmpl(ctx, tmpl, &wr->u.write_replace.cell_list);
+		OSMO_ASSERT(ref && msg);
+		printf("%u cells: len=%u %s\n", i * 2, msgb_length(msg),
+		       msgb_length(msg) == msgb_length(ref) &&
+		       !memcmp(msgb_data(msg), msgb_data(ref), msgb_length(ref)) ? "match" : "MISMATCH");
+		if (i == 1)
+			printf("%s\n", msgb_hexdump(msg));
+		msgb_free(ref);
+		msgb_free(msg);
+	}
+
+	talloc_free(tmpl);
+}
+
+static void test_cbs(void *ctx)
+{
+	struct osmo_cbsp_decoded *wr = osmo_cbsp_decoded_alloc(ctx, CBSP_MSGT_WRITE_REPLACE);
+	struct osmo_cbsp_write_replace_tmpl *tmpl;
+	struct osmo_cbsp_content *ce;
+	unsigned int i;
+
+	printf("=> %s\n", __func__);
+
+	wr->u.write_replace.msg_id = 0x1234;
+	wr->u.write_replace.new_serial_nr = 0x5678;
+	wr->u.write_replace.is_cbs = true;
+	wr->u.write_replace.u.cbs.channel_ind = CBSP_CHAN_IND_BASIC;
+	wr->u.write_replace.u.cbs.category = CBSP_CATEG_NORMAL;
+	wr->u.write_replace.u.cbs.rep_period = 5;
+	wr->u.write_replace.u.cbs.num_bcast_req = 0;
+	wr->u.write_replace.u.cbs.dcs = 0x0f;
+	INIT_LLIST_HEAD(&wr->u.write_replace.u.cbs.msg_content);
+	for (i = 0; i < 2; i++) {
+		ce = talloc_zero(wr, struct osmo_cbsp_content);
+		ce->user_len = 82 - i * 40;
+		memset(ce->data, 0x41 + i, sizeof(ce->data));
+		llist_add_tail(&ce->list, &wr->u.write_replace.u.cbs.msg_content);
+	}
+
+	test_write_replace_tmpl(wr, wr);
+
+	/* no pages */
+	INIT_LLIST_HEAD(&wr->u.write_replace.u.cbs.msg_content);
+	tmpl = osmo_cbsp_write_replace_tmpl_alloc(wr, &wr->u.write_replace);
+	printf("no pages: %s (%s)\n", tmpl ? "ok" : "NULL", osmo_cbsp_errstr);
+
+	talloc_free(wr);
+}
+
+static void test_emergency(void *ctx)
+{
+	struct osmo_cbsp_decoded *wr = osmo_cbsp_decoded_alloc(ctx, CBSP_MSGT_WRITE_REPLACE);
+	uint16_t old_serial_nr = 0x5677;
+
+	printf("=> %s\n", __func__);
+
+	wr->u.write_replace.msg_id = 0x1112;
+	wr->u.write_replace.new_serial_nr = 0x5678;
+	wr->u.write_replace.old_serial_nr = &old_serial_nr;
+	wr->u.write_replace.is_cbs = false;
+	wr->u.write_replace.u.emergency.indicator = 1;
+	wr->u.write_replace.u.emergency.warning_type = 0x0100;
+	wr->u.write_replace.u.emergency.warning_period = 60;
+
+	test_write_replace_tmpl(wr, wr);
+
+	talloc_free(wr);
+}
+
+int main(int argc, char **argv)
+{
+	void *ctx = talloc_named_const(NULL, 0, "cbsp_test");
+
+	test_cbs(ctx);
+	test_emergency(ctx);
+
+	OSMO_ASSERT(talloc_total_blocks(ctx) == 1);
+	talloc_free(ctx);
+	return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/talloc.h>
+
+#include <osmocom/codec/codec.h>
+#include <osmocom/codec/ecu.h>
+
+static const char *fr_frames_hex[] = {
+	"d9aa93ae63de00471a91b95b8660471392b4a2daa037628f391c624039258dc723",
+	"d8eb83699a66c036ec89b7246e6034dc8d48948620589b7256e3a6603b2371b8da",
+	"d967abaa1cbe4035238da6ace4c036d46ec69ba600391c4eb8a2b040591c6a3924",
+	"d9ec9be212901f802335598c501f805bad3d4ba01f809b69df5a501f809cd1b4da",
+};
+
+static const char *efr_frame_hex =
+	"c0f5e2b9cc5f1e8f8b3a1ba8a0b74b10a1fb1cd8e6f1c31bb0a2a85c1b6c04";
+
+/* Every channel of a batch must behave exactly like its own single channel ECU */
+static void test_fr_batch(void)
+{
+	enum { NUM_CHANS = 4, NUM_TICKS = 24 };
+	struct osmo_ecu_state *single[NUM_CHANS];
+	struct osmo_ecu_batch *eb;
+	uint8_t frame[GSM_FR_BYTES];
+	uint8_t out[NUM_CHANS][OSMO_ECU_MAX_FRAME_BYTES], ref[OSMO_ECU_MAX_FRAME_BYTES];
+	uint8_t *outp[NUM_CHANS];
+	unsigned int chans[NUM_CHANS], num, i, t, mismatch = 0, concealed = 0;
+	int lens[NUM_CHANS], rc;
+
+	printf("=> Testing FR multi-channel ECU\n");
+
+	eb = osmo_ecu_batch_alloc(NULL, OSMO_ECU_CODEC_FR, NUM_CHANS);
+	OSMO_ASSERT(eb);
+	for (i = 0; i < NUM_CHANS; i++) {
+		single[i] = osmo_ecu_init(NULL, OSMO_ECU_CODEC_FR);
+		OSMO_ASSERT(single[i]);
+		outp[i] = out[i];
+	}
+
+	for (t = 0; t < NUM_TICKS; t++) {
+		/* channel i loses frames in every (i + 2)th tick and in a burst at the end */
+		for (i = 0, num = 0; i < NUM_CHANS; i++) {
+			if (t > 0 && (t % (i + 2) == 0 || t >= NUM_TICKS - 8)) {
+				chans[num++] = i;
+				continue;
+			}
+			osmo_hexparse(fr_frames_hex[(t + i) % ARRAY_SIZE(fr_frames_hex)], frame, sizeof(frame));
+			OSMO_ASSERT(osmo_ecu_batch_frame_in(eb, i, false, frame, sizeof(frame)) == 0);
+			OSMO_ASSERT(osmo_ecu_frame_in(single[i], false, frame, sizeof(frame)) == 0);
+		}
+
+		concealed += osmo_ecu_batch_conceal(eb, chans, num, outp, lens);
+		for (i = 0; i < num; i++) {
+			rc = osmo_ecu_frame_out(single[chans[i]], ref);
+			if (rc != lens[i] || memcmp(ref, out[i], rc))
+				mismatch++;
+		}
+		if (t == NUM_TICKS - 1) {
+			for (i = 0; i < num; i++)
+				printf("chan %u: %s\n", chans[i], osmo_hexdump_nospc(out[i], lens[i]));
+		}
+	}
+
+	printf("concealed %u frames, %u mismatches\n", concealed, mismatch);
+
+	for (i = 0; i < NUM_CHANS; i++)
+		osmo_ecu_destroy(single[i]);
+	osmo_ecu_batch_free(eb);
+}
+
+static void test_efr(void)
+{
+	struct osmo_ecu_state *st;
+	uint8_t frame[GSM_EFR_BYTES];
+	int i, rc;
+
+	printf("=> Testing EFR ECU\n");
+
+	st = osmo_ecu_init(NULL, OSMO_ECU_CODEC_EFR);
+	OSMO_ASSERT(st);
+
+	rc = osmo_ecu_frame_out(st, frame);
+	printf("no good frame yet: %d\n", rc);
+
+	osmo_hexparse(efr_frame_hex, frame, sizeof(frame));
+	OSMO_ASSERT(osmo_ecu_frame_in(st, false, frame, sizeof(frame)) == 0);
+	printf("good: %s\n", osmo_hexdump_nospc(frame, sizeof(frame)));
+
+	for (i = 0; i < 10; i++) {
+		rc = osmo_ecu_frame_out(st, frame);
+		OSMO_ASSERT(rc == GSM_EFR_BYTES);
+		printf("conceal: %02d, result: %s\n", i, osmo_hexdump_nospc(frame, rc));
+	}
+
+	osmo_ecu_destroy(st);
+}
+
+static void test_amr(void)
+{
+	struct osmo_ecu_batch *eb;
+	uint8_t frame[OSMO_ECU_MAX_FRAME_BYTES];
+	uint8_t *outp[] = { frame };
+	unsigned int chan = 1, i;
+	int len, rc;
+
+	printf("=> Testing AMR multi-channel ECU\n");
+
+	eb = osmo_ecu_batch_alloc(NULL, OSMO_ECU_CODEC_AMR, 2);
+	OSMO_ASSERT(eb);
+
+	/* AMR 7.95 frame, CMR 7 */
+	for (i = 0; i < sizeof(frame); i++)
+		frame[i] = i * 7;
+	len = osmo_amr_rtp_enc(frame, 7, AMR_7_95, AMR_GOOD);
+	rc = osmo_ecu_batch_frame_in(eb, chan, false, frame, len);
+	printf("frame_in(AMR 7.95, len=%d): %d\n", len, rc);
+
+	/* bad frames are not used */
+	osmo_amr_rtp_enc(frame, 7, AMR_12_2, AMR_BAD);
+	rc = osmo_ecu_batch_frame_in(eb, chan, false, frame, 33);
+	printf("frame_in(AMR 12.2, Q=0): %d\n", rc);
+
+	for (i = 0; i < 18; i++) {
+		memset(frame, 0, sizeof(frame));
+		rc = osmo_ecu_batch_conceal(eb, &chan, 1, outp, &len);
+		OSMO_ASSERT(rc == 1);
+		printf("conceal: %02u, result: %s\n", i, osmo_hexdump_nospc(frame, len));
+	}
+
+	/* unused and invalid channels */
+	chan = 0;
+	rc = osmo_ecu_batch_conceal(eb, &chan, 1, outp, &len);
+	printf("conceal(chan 0): %d, len=%d\n", rc, len);
+	chan = 2;
+	rc = osmo_ecu_batch_conceal(eb, &chan, 1, outp, &len);
+	printf("conceal(chan 2): %d, len=%d\n", rc, len);
+
+	/* a new call on channel 1 starts without a good frame */
+	chan = 1;
+	osmo_ecu_batch_reset(eb, chan);
+	rc = osmo_ecu_batch_conceal(eb, &chan, 1, outp, &len);
+	printf("conceal(chan 1 after reset): %d, len=%d\n", rc, len);
+
+	osmo_ecu_batch_free(eb);
+
+	printf("HR batch: %s\n", osmo_ecu_batch_alloc(NULL, OSMO_ECU_CODEC_HR, 1) ? "supported" : "not supported");
+}
+
+int main(int argc, char **argv)
+{
+	test_fr_batch();
+	test_efr();
+	test_amr();
+
+	return 0;
+}
@@ -191,6 +191,56 @@ static void test_sid_fr(void)
 }
 
 
+static void test_sid_efr(void)
+{
+	uint8_t frame[GSM_EFR_BYTES];
+
+	/* all bits set, so the SID code word is present */
+	memset(frame, 0xff, sizeof(frame));
+	frame[0] = 0xcf;
+	printf("EFR all 1: %d\n", osmo_efr_check_sid(frame, sizeof(frame)));
+	printf("EFR all 1, short: %d\n", osmo_efr_check_sid(frame, sizeof(frame) - 1));
+
+	/* clear LTP-GAIN 1: b3, which is not part of the SID code word */
+	frame[(4 + 47) >> 3] &= ~(0x80 >> ((4 + 47) & 7));
+	printf("EFR LTP-GAIN 1 b3 cleared: %d\n", osmo_efr_check_sid(frame, sizeof(frame)));
+
+	/* clear LTP-LAG 1: b0, which is */
+	frame[(4 + 46) >> 3] &= ~(0x80 >> ((4 + 46) & 7));
+	printf("EFR LTP-LAG 1 b0 cleared: %d\n", osmo_efr_check_sid(frame, sizeof(frame)));
+
+	memset(frame, 0xff, sizeof(frame));
+	printf("FR signature: %d\n", osmo_efr_check_sid(frame, sizeof(frame)));
+}
+
+static void test_sid_batch(void)
+{
+	const uint8_t *payloads[] = { sid_first, sid_update, sid_fr, fr, sid_hr, hr };
+	const size_t lens[] = { sizeof(sid_first), sizeof(sid_update), sizeof(sid_fr), sizeof(fr),
+				sizeof(sid_hr), sizeof(hr) };
+	bool is_sid[ARRAY_SIZE(payloads)];
+	size_t fr_lens[ARRAY_SIZE(fr_sids)];
+	bool fr_is_sid[ARRAY_SIZE(fr_sids)];
+	int rc, i;
+
+	printf("AMR SID type: %d %d %d\n", osmo_amr_check_sid(sid_first, sizeof(sid_first)),
+	       osmo_amr_check_sid(sid_update, sizeof(sid_update)), osmo_amr_check_sid(sid_update, 6));
+
+	rc = osmo_check_sid_batch(OSMO_SID_CODEC_AMR, payloads, lens, 2, is_sid);
+	printf("AMR batch: %d [%d %d]\n", rc, is_sid[0], is_sid[1]);
+
+	rc = osmo_check_sid_batch(OSMO_SID_CODEC_FR, payloads + 2, lens + 2, 2, is_sid);
+	printf("FR batch: %d [%d %d]\n", rc, is_sid[0], is_sid[1]);
+
+	rc = osmo_check_sid_batch(OSMO_SID_CODEC_HR, payloads + 4, lens + 4, 2, is_sid);
+	printf("HR batch: %d [%d %d]\n", rc, is_sid[0], is_sid[1]);
+
+	/* all of the FR SID samples */
+	for (i = 0; i < ARRAY_SIZE(fr_sids); i++)
+		fr_lens[i] = 33;
+	rc = osmo_check_sid_batch(OSMO_SID_CODEC_FR, fr_sids, fr_lens, ARRAY_SIZE(fr_sids), fr_is_sid);
+	printf("FR SID samples batch: %d\n", rc);
+}
 
 static void test_amr_s_d(void)
 {
@@ -249,6 +299,12 @@ int main(int argc, char **argv)
 	printf("FR RTP payload SID test:\n");
 	test_sid_fr();
 
+	printf("EFR RTP payload SID test:\n");
+	test_sid_efr();
+
+	printf("RTP payload SID batch test:\n");
+	test_sid_batch();
+
 	printf("AMR s/d bit re-ordering test:\n");
 	test_amr_s_d();
 
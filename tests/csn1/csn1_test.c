@@ -0,0 +1,350 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/bitvec.h>
+#include <osmocom/gsm/csn1.h>
+#include <osmocom/gsm/gsm48_rest_octets.h>
+
+/* SI3 Rest Octets (3GPP TS 44.018 Table 10.5.2.34.1), for comparison with gsm48_rest_octets.c */
+struct si3_ro {
+	uint8_t sp_present;
+	uint8_t cbq;
+	uint8_t cell_resel_off;
+	uint8_t temp_offs;
+	uint8_t penalty_time;
+	uint8_t po_present;
+	uint8_t power_offset;
+	uint8_t si2ter_ind;
+	uint8_t early_cm_ctrl;
+	uint8_t sched_present;
+	uint8_t sched_where;
+	uint8_t gprs_present;
+	uint8_t ra_colour;
+	uint8_t si13_position;
+	uint8_t early_cm_restrict_3g;
+	uint8_t si2quater_present;
+	uint8_t si2quater_position;
+};
+
+static const struct osmo_csn1_insn si3_ro_descr[] = {
+	OSMO_CSN1_NEXT_EXIST_LH(struct si3_ro, sp_present, 4),
+	OSMO_CSN1_UINT(struct si3_ro, cbq, 1),
+	OSMO_CSN1_UINT(struct si3_ro, cell_resel_off, 6),
+	OSMO_CSN1_UINT(struct si3_ro, temp_offs, 3),
+	OSMO_CSN1_UINT(struct si3_ro, penalty_time, 5),
+	OSMO_CSN1_NEXT_EXIST_LH(struct si3_ro, po_present, 1),
+	OSMO_CSN1_UINT(struct si3_ro, power_offset, 2),
+	OSMO_CSN1_UINT_LH(struct si3_ro, si2ter_ind, 1),
+	OSMO_CSN1_UINT_LH(struct si3_ro, early_cm_ctrl, 1),
+	OSMO_CSN1_NEXT_EXIST_LH(struct si3_ro, sched_present, 1),
+	OSMO_CSN1_UINT(struct si3_ro, sched_where, 3),
+	OSMO_CSN1_NEXT_EXIST_LH(struct si3_ro, gprs_present, 2),
+	OSMO_CSN1_UINT(struct si3_ro, ra_colour, 3),
+	OSMO_CSN1_UINT(struct si3_ro, si13_position, 1),
+	OSMO_CSN1_UINT_LH(struct si3_ro, early_cm_restrict_3g, 1),
+	OSMO_CSN1_NEXT_EXIST_LH(struct si3_ro, si2quater_present, 1),
+	OSMO_CSN1_UINT(struct si3_ro, si2quater_position, 1),
+	OSMO_CSN1_PADDING,
+	OSMO_CSN1_END
+};
+
+static void si3_ro_to_info(struct osmo_gsm48_si_ro_info *info, const struct si3_ro *ro)
+{
+	memset(info, 0, sizeof(*info));
+	info->selection_params.present = ro->sp_present;
+	info->selection_params.cbq = ro->cbq;
+	info->selection_params.cell_resel_off = ro->cell_resel_off;
+	info->selection_params.temp_offs = ro->temp_offs;
+	info->selection_params.penalty_time = ro->penalty_time;
+	info->power_offset.present = ro->po_present;
+	info->power_offset.power_offset = ro->power_offset;
+	info->si2ter_indicator = ro->si2ter_ind;
+	info->early_cm_ctrl = ro->early_cm_ctrl;
+	info->scheduling.present = ro->sched_present;
+	info->scheduling.where = ro->sched_where;
+	info->gprs_ind.present = ro->gprs_present;
+	info->gprs_ind.ra_colour = ro->ra_colour;
+	info->gprs_ind.si13_position = ro->si13_position;
+	info->early_cm_restrict_3g = ro->early_cm_restrict_3g;
+	info->si2quater_indicator = ro->si2quater_present;
+}
+
+static void test_si3_ro(void)
+{
+	unsigned int i, num_cmp = 0, num_too_long = 0;
+
+	printf("Testing SI3 rest octets\n");
+
+	srandom(42);
+	for (i = 0; i < 2000; i++) {
+		struct si3_ro ro = {
+			.sp_present = random() & 1,
+			.cbq = random() & 1,
+			.cell_resel_off = random() % 64,
+			.temp_offs = random() % 8,
+			.penalty_time = random() % 32,
+			.po_present = random() & 1,
+			.power_offset = random() % 4,
+			.si2ter_ind = random() & 1,
+			.early_cm_ctrl = random() & 1,
+			.sched_present = random() & 1,
+			.sched_where = random() % 8,
+			.gprs_present = random() & 1,
+			.ra_colour = random() % 8,
+			.si13_position = random() & 1,
+			.early_cm_restrict_3g = random() & 1,
+			.si2quater_present = random() & 1,
+		};
+		struct osmo_gsm48_si_ro_info info, dec_info, ref_info;
+		struct si3_ro dec;
+		uint8_t data[4] = {}, ref[4];
+		struct bitvec bv = { .data = data, .data_len = sizeof(data) };
+		int rc;
+
+		/* the hand-written encoder ignores values of absent elements */
+		if (!ro.sp_present)
+			ro.cbq = ro.cell_resel_off = ro.temp_offs = ro.penalty_time = 0;
+		if (!ro.po_present)
+			ro.power_offset = 0;
+		if (!ro.sched_present)
+			ro.sched_where = 0;
+		if (!ro.gprs_present)
+			ro.ra_colour = ro.si13_position = 0;
+
+		rc = osmo_csn1_encode(si3_ro_descr, &bv, &ro);
+		if (rc == -EINVAL) {
+			/* does not fit into four octets */
+			num_too_long++;
+			continue;
+		}
+		OSMO_ASSERT(rc == 0);
+
+		si3_ro_to_info(&info, &ro);
+		osmo_gsm48_rest_octets_si3_encode(ref, &info);
+		if (memcmp(data, ref, sizeof(data))) {
+			printf("%u: csn1 %s != ", i, osmo_hexdump_nospc(data, sizeof(data)));
+			printf("%s\n", osmo_hexdump_nospc(ref, sizeof(ref)));
+		}
+
+		memset(&dec, 0, sizeof(dec));
+		bv.cur_bit = 0;
+		OSMO_ASSERT(osmo_csn1_decode(si3_ro_descr, &bv, &dec) == 0);
+		OSMO_ASSERT(bv.cur_bit == 32);
+		si3_ro_to_info(&dec_info, &dec);
+		osmo_gsm48_rest_octets_si3_decode(&ref_info, data);
+		si3_ro_to_info(&info, &ro);
+		OSMO_ASSERT(memcmp(&dec_info, &ref_info, sizeof(dec_info)) == 0);
+		OSMO_ASSERT(memcmp(&dec_info, &info, sizeof(dec_info)) == 0);
+
+		if (num_cmp++ < 4)
+			printf("%s\n", osmo_hexdump_nospc(data, sizeof(data)));
+	}
+
+	printf("compared %u, too long %u\n", num_cmp, num_too_long);
+}
+
+/* A made up RLC/MAC style control message using all elements of the engine */
+struct test_chan {
+	uint8_t tn;
+	uint8_t has_alpha;
+	uint8_t alpha;
+	uint16_t gamma;
+};
+
+struct test_msg {
+	uint8_t msg_type;
+	uint8_t page_mode;
+	uint8_t id_choice;
+	uint8_t tfi;
+	uint32_t tlli;
+	uint8_t num_chans;
+	struct test_chan chans[4];
+	uint8_t num_arfcns;
+	uint16_t arfcns[8];
+	uint8_t usf[8];
+	uint8_t has_ext;
+	uint16_t ext;
+	uint64_t big;
+};
+
+static const struct osmo_csn1_insn test_chan_descr[] = {
+	OSMO_CSN1_UINT(struct test_chan, tn, 3),
+	OSMO_CSN1_NEXT_EXIST(struct test_chan, has_alpha, 1),
+	OSMO_CSN1_UINT(struct test_chan, alpha, 4),
+	OSMO_CSN1_UINT(struct test_chan, gamma, 5),
+	OSMO_CSN1_END
+};
+
+static const struct osmo_csn1_insn test_msg_descr[] = {
+	OSMO_CSN1_UINT(struct test_msg, msg_type, 6),
+	OSMO_CSN1_UINT(struct test_msg, page_mode, 2),
+	OSMO_CSN1_UNION(struct test_msg, id_choice, 2, 3),
+	OSMO_CSN1_UINT(struct test_msg, tfi, 5),
+	OSMO_CSN1_UINT(struct test_msg, tlli, 32),
+	OSMO_CSN1_NULL,
+	OSMO_CSN1_FIXED(2, 0x1),
+	OSMO_CSN1_REC_TYPE_ARRAY(struct test_msg, chans, num_chans, test_chan_descr),
+	OSMO_CSN1_REC_ARRAY(struct test_msg, arfcns, num_arfcns, 10),
+	OSMO_CSN1_UINT_ARRAY(struct test_msg, usf, 3),
+	OSMO_CSN1_NEXT_EXIST_LH(struct test_msg, has_ext, 2),
+	OSMO_CSN1_UINT_LH(struct test_msg, ext, 12),
+	OSMO_CSN1_UINT(struct test_msg, big, 40),
+	OSMO_CSN1_PADDING,
+	OSMO_CSN1_END
+};
+
+static void test_roundtrip(const struct test_msg *msg)
+{
+	struct test_msg dec;
+	uint8_t data[23] = {};
+	struct bitvec bv = { .data = data, .data_len = sizeof(data) };
+	int rc;
+
+	rc = osmo_csn1_encode(test_msg_descr, &bv, msg);
+	printf("encode: rc=%d cur_bit=%u %s\n", rc, bv.cur_bit, osmo_hexdump_nospc(data, sizeof(data)));
+	OSMO_ASSERT(rc == 0);
+
+	memset(&dec, 0, sizeof(dec));
+	bv.cur_bit = 0;
+	rc = osmo_csn1_decode(test_msg_descr, &bv, &dec);
+	printf("decode: rc=%d cur_bit=%u\n", rc, bv.cur_bit);
+	OSMO_ASSERT(rc == 0);
+	OSMO_ASSERT(memcmp(&dec, msg, sizeof(dec)) == 0);
+}
+
+static void test_msg(void)
+{
+	struct test_msg msg;
+
+	printf("Testing encode/decode round trip\n");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_type = 0x21;
+	msg.page_mode = 2;
+	msg.id_choice = 1;
+	msg.tlli = 0xdeadbeef;
+	msg.num_chans = 2;
+	msg.chans[0].tn = 3;
+	msg.chans[0].gamma = 17;
+	msg.chans[1].tn = 7;
+	msg.chans[1].has_alpha = 1;
+	msg.chans[1].alpha = 10;
+	msg.chans[1].gamma = 31;
+	msg.num_arfcns = 3;
+	msg.arfcns[0] = 1;
+	msg.arfcns[1] = 512;
+	msg.arfcns[2] = 1023;
+	msg.usf[2] = 5;
+	msg.usf[7] = 7;
+	msg.has_ext = 1;
+	msg.ext = 0xabc;
+	msg.big = 0x123456789aULL;
+	test_roundtrip(&msg);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_type = 0x3f;
+	msg.id_choice = 0;
+	msg.tfi = 31;
+	msg.num_chans = 4;
+	msg.chans[3].has_alpha = 1;
+	msg.chans[3].alpha = 15;
+	msg.num_arfcns = 5;
+	msg.arfcns[4] = 0x155;
+	test_roundtrip(&msg);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.id_choice = 2;
+	test_roundtrip(&msg);
+}
+
+struct test_nest {
+	uint8_t more;
+};
+
+extern const struct osmo_csn1_insn test_nest_descr[];
+const struct osmo_csn1_insn test_nest_descr[] = {
+	OSMO_CSN1_NEXT_EXIST(struct test_nest, more, 1),
+	OSMO_CSN1_TYPE(struct test_nest, more, test_nest_descr),
+	OSMO_CSN1_END
+};
+
+/* declares three alternatives, but only two follow */
+static const struct osmo_csn1_insn test_short_union_descr[] = {
+	OSMO_CSN1_UNION(struct test_msg, id_choice, 2, 3),
+	OSMO_CSN1_UINT(struct test_msg, tfi, 5),
+	OSMO_CSN1_UINT(struct test_msg, tlli, 32),
+	OSMO_CSN1_END
+};
+
+static void test_errors(void)
+{
+	struct test_msg msg;
+	struct test_nest nest = { .more = 1 };
+	uint8_t data[23] = {};
+	struct bitvec bv = { .data = data, .data_len = sizeof(data) };
+
+	printf("Testing errors\n");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.id_choice = 3;
+	printf("invalid union selector: %d\n", osmo_csn1_encode(test_msg_descr, &bv, &msg));
+
+	memset(&msg, 0, sizeof(msg));
+	msg.num_arfcns = 9;
+	bv.cur_bit = 0;
+	printf("too many array elements: %d\n", osmo_csn1_encode(test_msg_descr, &bv, &msg));
+
+	memset(&msg, 0, sizeof(msg));
+	bv.cur_bit = 0;
+	OSMO_ASSERT(osmo_csn1_encode(test_msg_descr, &bv, &msg) == 0);
+	bv.data_len = 4;
+	bv.cur_bit = 0;
+	memset(&msg, 0xa5, sizeof(msg));
+	printf("truncated: %d\n", osmo_csn1_decode(test_msg_descr, &bv, &msg));
+	/* the member which did not fit is left untouched */
+	printf("truncated: tlli=0x%08x\n", msg.tlli);
+	bv.data_len = sizeof(data);
+
+	/* break the fixed '01' pattern after the union */
+	data[1] ^= 0x01;
+	bv.cur_bit = 0;
+	printf("fixed pattern mismatch: %d\n", osmo_csn1_decode(test_msg_descr, &bv, &msg));
+
+	bv.cur_bit = 0;
+	printf("nested too deep: %d\n", osmo_csn1_encode(test_nest_descr, &bv, &nest));
+
+	memset(&msg, 0, sizeof(msg));
+	bv.cur_bit = 0;
+	printf("union with missing alternatives: encode %d", osmo_csn1_encode(test_short_union_descr, &bv, &msg));
+	bv.cur_bit = 0;
+	printf(", decode %d\n", osmo_csn1_decode(test_short_union_descr, &bv, &msg));
+}
+
+int main(int argc, char **argv)
+{
+	test_si3_ro();
+	test_msg();
+	test_errors();
+	return EXIT_SUCCESS;
+}
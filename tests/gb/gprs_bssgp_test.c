@@ -17,6 +17,8 @@
 #include <osmocom/core/logging.h>
 #include <osmocom/core/talloc.h>
 #include <osmocom/core/prim.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/timer.h>
 #include <osmocom/gprs/gprs_bssgp.h>
 #include <osmocom/gprs/gprs_ns.h>
 #include <osmocom/gprs/gprs_bssgp_bss.h>
@@ -24,6 +26,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 #include <getopt.h>
 #include <unistd.h>
@@ -64,10 +67,14 @@ int gprs_ns_callback(enum gprs_ns_evt event, struct gprs_nsvc *nsvc,
 }
 
 struct msgb *last_ns_tx_msg = NULL;
+static bool print_ns_tx = false;
 
 /* override */
 int gprs_ns_sendmsg(struct gprs_ns_inst *nsi, struct msgb *msg)
 {
+	if (print_ns_tx)
+		printf("NS tx NSEI=%u BVCI=%u: %s\n", msgb_nsei(msg), msgb_bvci(msg),
+		       osmo_hexdump_nospc(msgb_data(msg), msgb_length(msg)));
 	msgb_free(last_ns_tx_msg);
 	last_ns_tx_msg = msg;
 
@@ -289,6 +296,171 @@ static void test_bssgp_msgb_copy()
 	printf("----- %s END\n", __func__);
 }
 
+struct bssgp_bvc_ctx *btsctx_alloc(uint16_t bvci, uint16_t nsei);
+
+static struct msgb *dl_ud_tx(struct bssgp_dl_ud_par *dup)
+{
+	static const uint8_t llc[] = { 0x01, 0xc0, 0x01, 0x02, 0x03, 0x04 };
+	struct msgb *msg = bssgp_msgb_alloc();
+
+	memcpy(msgb_put(msg, sizeof(llc)), llc, sizeof(llc));
+	msgb_tlli(msg) = 0xc0001234;
+	msgb_bvci(msg) = 0x4242;
+	msgb_nsei(msg) = 0x1234;
+	OSMO_ASSERT(bssgp_tx_dl_ud(msg, 1000, dup) >= 0);
+
+	OSMO_ASSERT(last_ns_tx_msg);
+	msg = last_ns_tx_msg;
+	last_ns_tx_msg = NULL;
+	return msg;
+}
+
+static void test_bssgp_dl_ud_tmpl(void)
+{
+	struct bssgp_bvc_ctx *bctx;
+	struct bssgp_dl_ud_tmpl tmpl = {};
+	uint8_t ra_cap[] = { 0x13, 0x37, 0x42 };
+	uint32_t old_tlli = 0xc0005678;
+	struct bssgp_dl_ud_par dup = {
+		.imsi = "001010123456789",
+		.drx_parms = 0x1234,
+		.ms_ra_cap = { .len = sizeof(ra_cap), .v = ra_cap },
+		.qos_profile = { 0x00, 0x00, 0x21 },
+	};
+	struct msgb *ref, *msg;
+	int i;
+
+	printf("----- %s START\n", __func__);
+
+	bctx = btsctx_alloc(0x4242, 0x1234);
+	OSMO_ASSERT(bctx);
+
+	for (i = 0; i < 5; i++) {
+		switch (i) {
+		case 2:
+			dup.imsi = "001010123456780";
+			break;
+		case 3:
+			ra_cap[1] = 0x38;
+			break;
+		case 4:
+			dup.tlli = &old_tlli;
+			break;
+		}
+
+		dup.tmpl = NULL;
+		ref = dl_ud_tx(&dup);
+		dup.tmpl = &tmpl;
+		msg = dl_ud_tx(&dup);
+		printf("DL-UD: %s (%s)\n", osmo_hexdump_nospc(msgb_data(msg), msgb_length(msg)),
+		       msgb_length(msg) == msgb_length(ref) &&
+		       !memcmp(msgb_data(msg), msgb_data(ref), msgb_length(ref)) ? "match" : "MISMATCH");
+		msgb_free(ref);
+		msgb_free(msg);
+	}
+
+	/* a too long MS RA capability is encoded without the template */
+	{
+		uint8_t long_ra_cap[95] = {};
+		dup.tlli = NULL;
+		dup.imsi = NULL;
+		dup.ms_ra_cap.v = long_ra_cap;
+		dup.ms_ra_cap.len = sizeof(long_ra_cap);
+		msg = dl_ud_tx(&dup);
+		printf("long MS RA capability: len=%u, template len=%u\n", msgb_length(msg), tmpl.len);
+		msgb_free(msg);
+	}
+
+	bssgp_bvc_ctx_free(bctx);
+
+	printf("----- %s END\n", __func__);
+}
+
+static void test_bssgp_paging_fanout(void)
+{
+	struct bssgp_paging_fanout *pf;
+	const struct bssgp_paging_dest dest[] = {
+		{ .nsei = 1, .ns_bvci = 0 },
+		{ .nsei = 1, .ns_bvci = 10 },
+		{ .nsei = 1, .ns_bvci = 11 },
+		{ .nsei = 2, .ns_bvci = 20 },
+	};
+	const struct bssgp_paging_dest dest2[] = {
+		{ .nsei = 1, .ns_bvci = 10 },
+		{ .nsei = 1, .ns_bvci = 0 },
+		{ .nsei = 1, .ns_bvci = 11 },
+		{ .nsei = 1, .ns_bvci = 12 },
+	};
+	struct bssgp_paging_info pinfo = {
+		.mode = BSSGP_PAGING_PS,
+		.scope = BSSGP_PAGING_BVCI,
+		.bvci = 0,
+		.imsi = "001010123456789",
+		.drx_params = 0x1234,
+		.qos = { 0x01, 0x02, 0x03 },
+	};
+	struct rate_ctr *ctr;
+	unsigned int i;
+	int rc;
+
+	printf("----- %s START\n", __func__);
+
+	osmo_clock_override_enable(CLOCK_MONOTONIC, true);
+	pf = bssgp_paging_fanout_alloc(NULL, 0, 100, 3);
+	OSMO_ASSERT(pf);
+	ctr = pf->ctrg->ctr;
+
+	print_ns_tx = true;
+	printf("first page, one PDU per destination:\n");
+	rc = bssgp_paging_fanout_tx(pf, dest, ARRAY_SIZE(dest), &pinfo);
+	printf("sent %d\n", rc);
+
+	printf("same page again within the window:\n");
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 50 * 1000000);
+	rc = bssgp_paging_fanout_tx(pf, dest, ARRAY_SIZE(dest), &pinfo);
+	printf("sent %d\n", rc);
+
+	printf("same page again after the window, NSE 1 out of tokens:\n");
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 60 * 1000000);
+	rc = bssgp_paging_fanout_tx(pf, dest, ARRAY_SIZE(dest), &pinfo);
+	printf("sent %d\n", rc);
+
+	printf("other subscriber, NSE 1 refilled one token:\n");
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 400 * 1000000);
+	pinfo.imsi = "001010123456780";
+	pinfo.scope = BSSGP_PAGING_ROUTEING_AREA;
+	pinfo.raid = (struct gprs_ra_id){ .mcc = 1, .mnc = 1, .lac = 0x1234, .rac = 5 };
+	rc = bssgp_paging_fanout_tx(pf, dest, ARRAY_SIZE(dest), &pinfo);
+	printf("sent %d\n", rc);
+	print_ns_tx = false;
+
+	for (i = 0; i < pf->ctrg->desc->num_ctr; i++)
+		printf("%s: %" PRIu64 "\n", pf->ctrg->desc->ctr_desc[i].name, ctr[i].current);
+
+	bssgp_paging_fanout_free(pf);
+
+	/* longer window, so that the rate limit refills within it */
+	pf = bssgp_paging_fanout_alloc(NULL, 0, 1000, 3);
+	OSMO_ASSERT(pf);
+	pinfo.scope = BSSGP_PAGING_BVCI;
+
+	print_ns_tx = true;
+	printf("signalling BVC after a PTP BVC, fourth PDU rate limited:\n");
+	rc = bssgp_paging_fanout_tx(pf, dest2, ARRAY_SIZE(dest2), &pinfo);
+	printf("sent %d\n", rc);
+
+	printf("same page again within the window, NSE 1 refilled one token:\n");
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 400 * 1000000);
+	rc = bssgp_paging_fanout_tx(pf, dest2, ARRAY_SIZE(dest2), &pinfo);
+	printf("sent %d\n", rc);
+	print_ns_tx = false;
+
+	bssgp_paging_fanout_free(pf);
+	osmo_clock_override_enable(CLOCK_MONOTONIC, false);
+
+	printf("----- %s END\n", __func__);
+}
+
 static struct log_info info = {};
 
 int main(int argc, char **argv)
@@ -317,6 +489,8 @@ int main(int argc, char **argv)
 	test_bssgp_bad_reset();
 	test_bssgp_flow_control_bvc();
 	test_bssgp_msgb_copy();
+	test_bssgp_dl_ud_tmpl();
+	test_bssgp_paging_fanout();
 	printf("===== BSSGP test END\n\n");
 
 	exit(EXIT_SUCCESS);
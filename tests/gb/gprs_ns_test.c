@@ -35,6 +35,8 @@
 #define SGSN_NSEI 0x0100
 
 static int sent_pdu_type = 0;
+static int sent_port = 0;
+static bool quiet = false;
 
 static int gprs_process_message(struct gprs_ns_inst *nsi, const char *text,
 				struct sockaddr_in *peer, const unsigned char* data,
@@ -221,8 +223,11 @@ ssize_t sendto(int sockfd, const void *buf, size_t len, int flags,
 		real_sendto = dlsym(RTLD_NEXT, "sendto");
 
 	sent_pdu_type = len > 0 ? ((uint8_t *)buf)[0] : -1;
+	sent_port = ntohs(((struct sockaddr_in *)dest_addr)->sin_port);
 
-	if (dest_host == REMOTE_BSS_ADDR)
+	if (quiet && (dest_host == REMOTE_BSS_ADDR || dest_host == REMOTE_SGSN_ADDR))
+		return len;
+	else if (dest_host == REMOTE_BSS_ADDR)
 		printf("MESSAGE to BSS, msg length %zu\n%s\n\n", len, osmo_hexdump(buf, len));
 	else if (dest_host == REMOTE_SGSN_ADDR)
 		printf("MESSAGE to SGSN, msg length %zu\n%s\n\n", len, osmo_hexdump(buf, len));
@@ -246,7 +251,9 @@ int gprs_ns_sendmsg(struct gprs_ns_inst *nsi, struct msgb *msg)
 	if (!real_gprs_ns_sendmsg)
 		real_gprs_ns_sendmsg = dlsym(RTLD_NEXT, "gprs_ns_sendmsg");
 
-	if (nsei == SGSN_NSEI)
+	if (quiet)
+		return real_gprs_ns_sendmsg(nsi, msg);
+	else if (nsei == SGSN_NSEI)
 		printf("NS UNITDATA MESSAGE to SGSN, BVCI 0x%04x, msg length %zu\n%s\n\n",
 		       bvci, len, osmo_hexdump(buf, len));
 	else
@@ -314,6 +321,10 @@ static int test_signal(unsigned int subsys, unsigned int signal,
 		       gprs_ns_ll_str(nssd->old_nsvc));
 		break;
 
+	case S_SNS_CONFIGURED:
+		printf("==> got signal SNS_CONFIGURED\n");
+		break;
+
 	case S_NS_MISMATCH:
 		printf("==> got signal NS_MISMATCH: 0x%04x/%s pdu=%d, ie=%d\n",
 		       nssd->nsvc->nsvci, gprs_ns_ll_str(nssd->nsvc),
@@ -344,13 +355,15 @@ static int gprs_process_message(struct gprs_ns_inst *nsi, const char *text, stru
 	msg->l2h = msg->data;
 	msgb_put(msg, data_len);
 
-	printf("PROCESSING %s from 0x%08x:%d\n%s\n\n",
-	       text, ntohl(peer->sin_addr.s_addr), ntohs(peer->sin_port),
-	       osmo_hexdump(data, data_len));
+	if (!quiet)
+		printf("PROCESSING %s from 0x%08x:%d\n%s\n\n",
+		       text, ntohl(peer->sin_addr.s_addr), ntohs(peer->sin_port),
+		       osmo_hexdump(data, data_len));
 
 	ret = gprs_ns_rcvmsg(nsi, msg, peer, GPRS_NS_LL_UDP);
 
-	printf("result (%s) = %d\n\n", text, ret);
+	if (!quiet)
+		printf("result (%s) = %d\n\n", text, ret);
 
 	msgb_free(msg);
 
@@ -892,6 +905,288 @@ static void test_sgsn_output()
 }
 
 
+/* send a user data PDU for each TLLI, record the UDP port it was sent to */
+static void send_ls_pdus(struct gprs_ns_inst *nsi, const uint32_t *tllis, int *ports, unsigned int num)
+{
+	unsigned int i;
+
+	quiet = true;
+	for (i = 0; i < num; i++) {
+		struct msgb *msg = gprs_ns_msgb_alloc();
+		msgb_put(msg, 4);
+		msgb_nsei(msg) = SGSN_NSEI;
+		msgb_bvci(msg) = 0x0102;
+		msgb_tlli(msg) = tllis[i];
+		sent_port = 0;
+		gprs_ns_sendmsg(nsi, msg);
+		ports[i] = sent_port;
+	}
+	quiet = false;
+}
+
+static void test_load_sharing()
+{
+	enum { NUM_NSVC = 3, NUM_TLLI = 1024 };
+	static const uint8_t data_weight[NUM_NSVC] = { 1, 2, 1 };
+	struct gprs_ns_inst *nsi = gprs_ns_instantiate(gprs_ns_callback, NULL);
+	struct sockaddr_in sgsn_peer[NUM_NSVC];
+	struct gprs_nsvc *nsvc[NUM_NSVC];
+	uint32_t tllis[NUM_TLLI];
+	int ports[NUM_TLLI], prev[NUM_TLLI];
+	unsigned int i, j, count[NUM_NSVC], moved;
+
+	printf("--- Setup %d NS-VCs to SGSN ---\n\n", NUM_NSVC);
+
+	quiet = true;
+	for (i = 0; i < NUM_NSVC; i++) {
+		memset(&sgsn_peer[i], 0, sizeof(sgsn_peer[i]));
+		sgsn_peer[i].sin_family = AF_INET;
+		sgsn_peer[i].sin_port = htons(32000 + i);
+		sgsn_peer[i].sin_addr.s_addr = htonl(REMOTE_SGSN_ADDR);
+
+		nsvc[i] = gprs_ns_nsip_connect(nsi, &sgsn_peer[i], SGSN_NSEI, SGSN_NSEI + 1 + i);
+		nsvc[i]->data_weight = data_weight[i];
+		send_ns_reset_ack(nsi, &sgsn_peer[i], SGSN_NSEI + 1 + i, SGSN_NSEI);
+		send_ns_alive_ack(nsi, &sgsn_peer[i]);
+		send_ns_unblock_ack(nsi, &sgsn_peer[i]);
+	}
+	quiet = false;
+	gprs_dump_nsi(nsi);
+
+	for (i = 0; i < NUM_TLLI; i++)
+		tllis[i] = 0xc0000000 | (i * 0x10001);
+
+#define COUNT_PORTS(p) do { \
+		memset(count, 0, sizeof(count)); \
+		for (i = 0; i < NUM_TLLI; i++) \
+			for (j = 0; j < NUM_NSVC; j++) \
+				if ((p)[i] == 32000 + j) \
+					count[j]++; \
+		printf("PDUs per NS-VC: %u %u %u\n", count[0], count[1], count[2]); \
+	} while (0)
+
+	printf("--- Send PDUs, weights %u:%u:%u ---\n", data_weight[0], data_weight[1], data_weight[2]);
+	send_ls_pdus(nsi, tllis, prev, NUM_TLLI);
+	COUNT_PORTS(prev);
+
+	send_ls_pdus(nsi, tllis, ports, NUM_TLLI);
+	printf("same NS-VC for the same TLLI: %s\n\n", memcmp(ports, prev, sizeof(ports)) ? "no" : "yes");
+
+	printf("--- Block NS-VC 0x%04x ---\n", nsvc[1]->nsvci);
+	quiet = true;
+	gprs_ns_tx_block(nsvc[1], NS_CAUSE_OM_INTERVENTION);
+	quiet = false;
+	send_ls_pdus(nsi, tllis, ports, NUM_TLLI);
+	COUNT_PORTS(ports);
+	for (i = 0, moved = 0; i < NUM_TLLI; i++)
+		if (prev[i] != 32001 && ports[i] != prev[i])
+			moved++;
+	printf("TLLIs moved away from the other NS-VCs: %u\n\n", moved);
+	memcpy(prev, ports, sizeof(prev));
+
+	printf("--- Unblock NS-VC 0x%04x ---\n", nsvc[1]->nsvci);
+	quiet = true;
+	send_ns_unblock(nsi, &sgsn_peer[1]);
+	quiet = false;
+	send_ls_pdus(nsi, tllis, ports, NUM_TLLI);
+	COUNT_PORTS(ports);
+	for (i = 0, moved = 0; i < NUM_TLLI; i++)
+		if (ports[i] != prev[i] && ports[i] != 32001)
+			moved++;
+	printf("TLLIs moved to other than the unblocked NS-VC: %u\n\n", moved);
+
+	printf("--- Signalling weight 0 on all but NS-VC 0x%04x ---\n", nsvc[2]->nsvci);
+	nsvc[0]->sig_weight = nsvc[1]->sig_weight = 0;
+	quiet = true;
+	gprs_ns_tx_block(nsvc[2], NS_CAUSE_OM_INTERVENTION);
+	send_ns_unblock(nsi, &sgsn_peer[2]);
+	quiet = false;
+	gprs_send_message(nsi, "BSSGP RESET", SGSN_NSEI, 0,
+			  gprs_bssgp_reset+4, sizeof(gprs_bssgp_reset)-4);
+	printf("sent to port %d\n\n", sent_port);
+
+#undef COUNT_PORTS
+
+	gprs_ns_destroy(nsi);
+	nsi = NULL;
+}
+
+
+/* SNS PDU with NSEI, transaction id and the given TLVs */
+static void send_sns(struct gprs_ns_inst *nsi, const char *text, struct sockaddr_in *src_addr,
+		     uint8_t pdu_type, uint8_t trans_id, const uint8_t *tlvs, size_t tlvs_len)
+{
+	uint8_t msg[256] = { pdu_type, NS_IE_NSEI, 0x82, SGSN_NSEI >> 8, SGSN_NSEI & 0xff, trans_id };
+
+	OSMO_ASSERT(tlvs_len <= sizeof(msg) - 6);
+	memcpy(msg + 6, tlvs, tlvs_len);
+	gprs_process_message(nsi, text, src_addr, msg, tlvs_len + 6);
+}
+
+/* Is nsvc (which may have been freed already) still in the remote address cache? */
+static bool rem_addr_cached(const struct gprs_ns_inst *nsi, const void *nsvc)
+{
+	unsigned int i;
+
+	/* 1 << NS_REM_ADDR_CACHE_BITS slots */
+	for (i = 0; i < 1024; i++) {
+		if (nsi->rem_addr_cache[i] == nsvc)
+			return true;
+	}
+	return false;
+}
+
+/* Does every remote address cache entry point to an existing NS-VC? */
+static bool rem_addr_cache_valid(const struct gprs_ns_inst *nsi)
+{
+	struct gprs_nsvc *nsvc;
+	unsigned int i, num = 0;
+
+	for (i = 0; i < 1024; i++) {
+		if (nsi->rem_addr_cache[i])
+			num++;
+	}
+	llist_for_each_entry(nsvc, &nsi->gprs_nsvcs, list) {
+		if (rem_addr_cached(nsi, nsvc))
+			num--;
+	}
+	return num == 0;
+}
+
+static void test_sns_endpoints()
+{
+	struct gprs_ns_inst *nsi = gprs_ns_instantiate(gprs_ns_callback, NULL);
+	struct sockaddr_in sgsn_peer = {0};
+	/* end flag, NSEI, 2x IPv4 (5.6.7.8:23000/23001), 1x IPv6 ([2001:db8::1]:23000) */
+	static const uint8_t config[] = {
+		SNS_PDUT_CONFIG, 0x01, NS_IE_NSEI, 0x82, SGSN_NSEI >> 8, SGSN_NSEI & 0xff,
+		NS_IE_IPv4_LIST, 0x80 | 16,
+			0x05, 0x06, 0x07, 0x08, 0x59, 0xd8, 0x01, 0x01,
+			0x05, 0x06, 0x07, 0x08, 0x59, 0xd9, 0x01, 0x01,
+		NS_IE_IPv6_LIST, 0x80 | 20,
+			0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01,
+			0x59, 0xd8, 0x01, 0x01,
+	};
+	static const uint8_t add2[] = {
+		NS_IE_IPv4_LIST, 0x80 | 16,
+			0x05, 0x06, 0x07, 0x09, 0x59, 0xd8, 0x01, 0x01,
+			0x05, 0x06, 0x07, 0x09, 0x59, 0xd9, 0x01, 0x01,
+	};
+	static const uint8_t add_too_many[] = {
+		NS_IE_IPv4_LIST, 0x80 | 8,
+			0x05, 0x06, 0x07, 0x0a, 0x59, 0xd8, 0x01, 0x01,
+	};
+	static const uint8_t add_ip6[] = {
+		NS_IE_IPv6_LIST, 0x80 | 20,
+			0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02,
+			0x59, 0xd8, 0x01, 0x01,
+	};
+	static const uint8_t change_weight_zero[] = {
+		NS_IE_IPv4_LIST, 0x80 | 32,
+			0x05, 0x06, 0x07, 0x08, 0x59, 0xd8, 0x00, 0x01,
+			0x05, 0x06, 0x07, 0x08, 0x59, 0xd9, 0x00, 0x01,
+			0x05, 0x06, 0x07, 0x09, 0x59, 0xd8, 0x00, 0x01,
+			0x05, 0x06, 0x07, 0x09, 0x59, 0xd9, 0x00, 0x01,
+		NS_IE_IPv6_LIST, 0x80 | 20,
+			0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01,
+			0x59, 0xd8, 0x00, 0x01,
+	};
+	static const uint8_t change_weight[] = {
+		NS_IE_IPv4_LIST, 0x80 | 8,
+			0x05, 0x06, 0x07, 0x09, 0x59, 0xd9, 0x03, 0x05,
+	};
+	static const uint8_t delete_ep[] = {
+		NS_IE_IPv4_LIST, 0x80 | 8,
+			0x05, 0x06, 0x07, 0x08, 0x59, 0xd9, 0x01, 0x01,
+	};
+	static const uint8_t delete_ip4[] = {
+		NS_IE_IP_ADDR, 0x01, 0x05, 0x06, 0x07, 0x09,
+	};
+	static const uint8_t delete_ip6[] = {
+		NS_IE_IP_ADDR, 0x02, 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01,
+	};
+	const uint8_t size_ack[] = { SNS_PDUT_SIZE_ACK, NS_IE_NSEI, 0x82, SGSN_NSEI >> 8, SGSN_NSEI & 0xff };
+	const uint8_t config_ack[] = { SNS_PDUT_CONFIG_ACK, NS_IE_NSEI, 0x82, SGSN_NSEI >> 8, SGSN_NSEI & 0xff };
+
+	sgsn_peer.sin_family = AF_INET;
+	sgsn_peer.sin_port = htons(32000);
+	sgsn_peer.sin_addr.s_addr = htonl(REMOTE_SGSN_ADDR);
+	nsi->nsip.local_ip = REMOTE_BSS_ADDR;
+	nsi->nsip.local_port = 23000;
+
+	printf("--- Setup IP-SNS connection to SGSN ---\n\n");
+
+	gprs_ns_nsip_connect_sns(nsi, &sgsn_peer, SGSN_NSEI, SGSN_NSEI+1);
+	gprs_process_message(nsi, "SNS-SIZE-ACK", &sgsn_peer, size_ack, sizeof(size_ack));
+	gprs_process_message(nsi, "SNS-CONFIG-ACK", &sgsn_peer, config_ack, sizeof(config_ack));
+	gprs_process_message(nsi, "SNS-CONFIG", &sgsn_peer, config, sizeof(config));
+	gprs_dump_nsi(nsi);
+
+	printf("--- SNS-ADD ---\n\n");
+
+	send_sns(nsi, "SNS-ADD", &sgsn_peer, SNS_PDUT_ADD, 1, add2, sizeof(add2));
+	send_sns(nsi, "SNS-ADD (duplicate)", &sgsn_peer, SNS_PDUT_ADD, 2, add2, sizeof(add2));
+	send_sns(nsi, "SNS-ADD (too many IPv4)", &sgsn_peer, SNS_PDUT_ADD, 3, add_too_many, sizeof(add_too_many));
+	send_sns(nsi, "SNS-ADD (IPv6)", &sgsn_peer, SNS_PDUT_ADD, 4, add_ip6, sizeof(add_ip6));
+	gprs_dump_nsi(nsi);
+
+	printf("--- SNS-CHANGE-WEIGHT ---\n\n");
+
+	send_sns(nsi, "SNS-CHANGE-WEIGHT (all zero)", &sgsn_peer, SNS_PDUT_CHANGE_WEIGHT, 5,
+		 change_weight_zero, sizeof(change_weight_zero));
+	send_sns(nsi, "SNS-CHANGE-WEIGHT", &sgsn_peer, SNS_PDUT_CHANGE_WEIGHT, 6,
+		 change_weight, sizeof(change_weight));
+	gprs_dump_nsi(nsi);
+
+	printf("--- SNS-DELETE ---\n\n");
+
+	send_sns(nsi, "SNS-DELETE", &sgsn_peer, SNS_PDUT_DELETE, 7, delete_ep, sizeof(delete_ep));
+	send_sns(nsi, "SNS-DELETE (unknown)", &sgsn_peer, SNS_PDUT_DELETE, 8, delete_ep, sizeof(delete_ep));
+	send_sns(nsi, "SNS-DELETE (IPv4 address)", &sgsn_peer, SNS_PDUT_DELETE, 9, delete_ip4, sizeof(delete_ip4));
+	send_sns(nsi, "SNS-DELETE (IPv6 address)", &sgsn_peer, SNS_PDUT_DELETE, 10, delete_ip6, sizeof(delete_ip6));
+	gprs_dump_nsi(nsi);
+	printf("remote address cache valid: %d\n\n", rem_addr_cache_valid(nsi));
+
+	gprs_ns_destroy(nsi);
+	nsi = NULL;
+}
+
+
+static void test_rem_addr_cache()
+{
+	struct gprs_ns_inst *nsi = gprs_ns_instantiate(gprs_ns_callback, NULL);
+	struct sockaddr_in peer = { .sin_family = AF_INET };
+	struct gprs_nsvc *nsvc;
+	const void *deleted;
+
+	printf("--- Remote address cache ---\n\n");
+
+	peer.sin_port = htons(1111);
+	peer.sin_addr.s_addr = htonl(REMOTE_BSS_ADDR);
+
+	/* an NS-VC without address yet (0.0.0.0:0), deleted before it gets one */
+	nsvc = gprs_nsvc_create2(nsi, 0x1001, 1, 1);
+	OSMO_ASSERT(nsvc);
+	printf("new NS-VC cached: %d\n", rem_addr_cached(nsi, nsvc));
+	deleted = nsvc;
+	gprs_nsvc_delete(nsvc);
+	printf("deleted NS-VC cached: %d\n\n", rem_addr_cached(nsi, deleted));
+
+	/* an NS-VC whose address is modified by the user after it was cached */
+	send_ns_reset(nsi, &peer, NS_CAUSE_OM_INTERVENTION, 0x1002, 0x1000);
+	send_ns_alive(nsi, &peer);
+	nsvc = gprs_nsvc_by_nsvci(nsi, 0x1002);
+	OSMO_ASSERT(nsvc);
+	printf("NS-VC cached after ALIVE: %d\n", rem_addr_cached(nsi, nsvc));
+	nsvc->ip.bts_addr.sin_port = htons(2222);
+	deleted = nsvc;
+	gprs_nsvc_delete(nsvc);
+	printf("deleted NS-VC with modified address cached: %d\n\n", rem_addr_cached(nsi, deleted));
+
+	gprs_ns_destroy(nsi);
+	nsi = NULL;
+}
+
 int bssgp_prim_cb(struct osmo_prim_hdr *oph, void *ctx)
 {
 	return -1;
@@ -920,6 +1215,9 @@ int main(int argc, char **argv)
 	test_sgsn_reset();
 	test_sgsn_reset_invalid_state();
 	test_sgsn_output();
+	test_load_sharing();
+	test_sns_endpoints();
+	test_rem_addr_cache();
 	printf("===== NS protocol test END\n\n");
 
 	exit(EXIT_SUCCESS);
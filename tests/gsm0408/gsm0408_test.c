@@ -28,6 +28,7 @@
 #include <osmocom/gsm/gsm48_ie.h>
 #include <osmocom/gsm/gsm48.h>
 #include <osmocom/gsm/gsm48_arfcn_range_encode.h>
+#include <osmocom/gsm/gsm48_rest_octets.h>
 #include <osmocom/gsm/gsm_utils.h>
 #include <osmocom/gsm/mncc.h>
 #include <osmocom/core/backtrace.h>
@@ -1400,6 +1401,51 @@ static int range512[] = {
 			__FILE__, __LINE__, (int) res, # cmp, (int) wanted);	\
 	}
 
+static void test_range_enc_freq_lists()
+{
+	static const int unsorted[] = { 391, 17, 1023, 127, 31, 113, 45 };
+	struct osmo_gsm48_range_enc_list lists[ARRAY_SIZE(arfcn_test_ranges) + 2];
+	unsigned int i, j, num = 0, num_ok;
+
+	printf("Testing bulk range encoding\n");
+
+	for (i = 0; arfcn_test_ranges[i].arfcns_num > 0; i++) {
+		lists[num].arfcns = arfcn_test_ranges[i].arfcns;
+		lists[num++].size = arfcn_test_ranges[i].arfcns_num;
+	}
+	/* an unsorted list, passed twice */
+	lists[num].arfcns = unsorted;
+	lists[num++].size = ARRAY_SIZE(unsorted);
+	lists[num].arfcns = unsorted;
+	lists[num++].size = ARRAY_SIZE(unsorted);
+
+	num_ok = osmo_gsm48_range_enc_freq_lists(lists, num);
+	printf("encoded %u of %u lists\n", num_ok, num);
+
+	for (i = 0; i < num; i++) {
+		struct gsm_sysinfo_freq dec_freq[1024] = {{0}};
+		uint8_t chan_list[16];
+		int dec_num = 0;
+
+		printf("list %u: rc=%d chan_list=%s\n", i, lists[i].rc,
+		       osmo_hexdump(lists[i].chan_list, sizeof(lists[i].chan_list)));
+		if (lists[i].rc < 0)
+			continue;
+
+		VERIFY(osmo_gsm48_range_enc_freq_list(chan_list, lists[i].arfcns, lists[i].size), ==, lists[i].rc);
+		VERIFY(memcmp(chan_list, lists[i].chan_list, sizeof(chan_list)), ==, 0);
+
+		VERIFY(gsm48_decode_freq_list(dec_freq, lists[i].chan_list, sizeof(lists[i].chan_list), 0xfe, 1), ==, 0);
+		for (j = 0; j < ARRAY_SIZE(dec_freq); j++) {
+			if (dec_freq[j].mask)
+				dec_num++;
+		}
+		VERIFY(dec_num, ==, lists[i].size);
+		for (j = 0; j < lists[i].size; j++)
+			VERIFY(dec_freq[lists[i].arfcns[j]].mask, !=, 0);
+	}
+}
+
 static void test_arfcn_filter()
 {
 	int arfcns[50], i, res, f0_included;
@@ -1539,6 +1585,104 @@ static void test_power_ctrl()
 	VERIFY(rc, <, 0);
 }
 
+static void test_si_ro_cache()
+{
+	static const uint16_t uarfcn_list[] = {
+		10564, 10564, 10564, 10564, 10564, 10564, 10564, 10564,
+		10588, 10588, 10588, 10588, 10588, 10588, 10588, 10588,
+		10612, 10612, 10612, 10612, 10612, 10612, 10612, 10612,
+	};
+	static uint16_t scramble_list[] = {
+		1, 2, 3, 4, 5, 6, 7, 8,
+		20, 30, 40, 50, 60, 70, 80, 90,
+		100, 110, 120, 130, 140, 150, 160, 170,
+	};
+	static uint16_t earfcns[] = { 1350, 1750, 2850, 6200, 6300, 9260 };
+	static uint8_t meas_bw[] = { OSMO_EARFCN_MEAS_INVALID, 2, OSMO_EARFCN_MEAS_INVALID, 3, 1, 0 };
+	struct osmo_earfcn_si2q earfcn_list = {
+		.arfcn = earfcns,
+		.meas_bw = meas_bw,
+		.length = ARRAY_SIZE(earfcns),
+		.thresh_hi = 5,
+		.prio = 2,
+		.prio_valid = true,
+	};
+	struct osmo_gsm48_si_ro_info si3 = {
+		.selection_params = { .present = 1, .cell_resel_off = 3 },
+		.gprs_ind = { .present = 1, .ra_colour = 5 },
+		.si2quater_indicator = true,
+	};
+	uint16_t uarfcn_copy[ARRAY_SIZE(uarfcn_list)], scramble_copy[ARRAY_SIZE(scramble_list)];
+	uint16_t earfcn_copy[ARRAY_SIZE(earfcns)];
+	uint8_t meas_bw_copy[ARRAY_SIZE(meas_bw)];
+	struct osmo_earfcn_si2q earfcn_list_copy;
+	struct osmo_gsm48_si_ro_cache cache[3];
+	struct osmo_gsm48_si_ro_cache *caches[] = { &cache[0], &cache[1], &cache[2] };
+	uint8_t ro[20];
+	size_t u_offset = 0, e_offset = 0;
+	int i, rc;
+
+	printf("Testing SI rest octets cache\n");
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		osmo_gsm48_si_ro_cache_init(&cache[i]);
+		osmo_gsm48_si_ro_cache_set_si2quater(&cache[i], uarfcn_list, scramble_list,
+						     ARRAY_SIZE(uarfcn_list), &earfcn_list);
+		osmo_gsm48_si_ro_cache_set_si3(&cache[i], &si3);
+	}
+	/* second cell with a copy of the same lists, which is encoded only once */
+	memcpy(uarfcn_copy, uarfcn_list, sizeof(uarfcn_copy));
+	memcpy(scramble_copy, scramble_list, sizeof(scramble_copy));
+	memcpy(earfcn_copy, earfcns, sizeof(earfcn_copy));
+	memcpy(meas_bw_copy, meas_bw, sizeof(meas_bw_copy));
+	earfcn_list_copy = earfcn_list;
+	earfcn_list_copy.arfcn = earfcn_copy;
+	earfcn_list_copy.meas_bw = meas_bw_copy;
+	osmo_gsm48_si_ro_cache_set_si2quater(&cache[1], uarfcn_copy, scramble_copy,
+					     ARRAY_SIZE(uarfcn_copy), &earfcn_list_copy);
+	/* last cell without neighbours */
+	osmo_gsm48_si_ro_cache_set_si2quater(&cache[2], NULL, NULL, 0, NULL);
+
+	rc = osmo_gsm48_si_ro_cache_encode_bulk(caches, ARRAY_SIZE(caches));
+	printf("bulk encode: %d\n", rc);
+	VERIFY(rc, ==, 3 * _NUM_OSMO_GSM48_SI_RO_PART);
+
+	/* compare against encoding without the cache */
+	printf("SI2quater count: %u\n", cache[0].si2quater.count);
+	for (i = 0; i < cache[0].si2quater.count; i++) {
+		memset(ro, 0, sizeof(ro));
+		osmo_gsm48_rest_octets_si2quater_encode(ro, i, cache[0].si2quater.count - 1, uarfcn_list, &u_offset,
+							ARRAY_SIZE(uarfcn_list), scramble_list, &earfcn_list,
+							&e_offset);
+		printf("SI2quater[%d]: %s\n", i, osmo_hexdump(cache[0].si2quater.ro[i], sizeof(ro)));
+		VERIFY(memcmp(ro, cache[0].si2quater.ro[i], sizeof(ro)), ==, 0);
+		VERIFY(memcmp(ro, cache[1].si2quater.ro[i], sizeof(ro)), ==, 0);
+	}
+	VERIFY(u_offset, ==, ARRAY_SIZE(uarfcn_list));
+	VERIFY(e_offset, ==, ARRAY_SIZE(earfcns));
+	printf("SI2quater without neighbours: %s\n", osmo_hexdump(cache[2].si2quater.ro[0], sizeof(ro)));
+	VERIFY(cache[2].si2quater.count, ==, 1);
+
+	osmo_gsm48_rest_octets_si3_encode(ro, &si3);
+	printf("SI3: %s\n", osmo_hexdump(cache[0].si3.ro, sizeof(cache[0].si3.ro)));
+	VERIFY(memcmp(ro, cache[0].si3.ro, sizeof(cache[0].si3.ro)), ==, 0);
+
+	/* nothing changed: nothing to re-encode */
+	osmo_gsm48_si_ro_cache_set_si3(&cache[0], &si3);
+	rc = osmo_gsm48_si_ro_cache_encode(&cache[0]);
+	VERIFY(rc, ==, 0);
+
+	/* only the changed part is re-encoded */
+	si3.power_offset.present = 1;
+	si3.power_offset.power_offset = 2;
+	osmo_gsm48_si_ro_cache_set_si3(&cache[0], &si3);
+	rc = osmo_gsm48_si_ro_cache_encode(&cache[0]);
+	VERIFY(rc, ==, 1);
+	osmo_gsm48_rest_octets_si3_encode(ro, &si3);
+	printf("SI3: %s\n", osmo_hexdump(cache[0].si3.ro, sizeof(cache[0].si3.ro)));
+	VERIFY(memcmp(ro, cache[0].si3.ro, sizeof(cache[0].si3.ro)), ==, 0);
+}
+
 int main(int argc, char **argv)
 {
 	test_bearer_cap();
@@ -1555,7 +1699,9 @@ int main(int argc, char **argv)
 	test_arfcn_filter();
 	test_print_encoding();
 	test_range_encoding();
+	test_range_enc_freq_lists();
 	test_power_ctrl();
+	test_si_ro_cache();
 
 	return EXIT_SUCCESS;
 }
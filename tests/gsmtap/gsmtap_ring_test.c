@@ -0,0 +1,114 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <osmocom/core/application.h>
+#include <osmocom/core/gsmtap.h>
+#include <osmocom/core/gsmtap_util.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/rate_ctr.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/socket.h>
+#include <osmocom/core/utils.h>
+#include <osmocom/core/msgb.h>
+
+static int sink_fd;
+
+static void recv_all(void)
+{
+	uint8_t buf[256];
+	int rc;
+
+	while ((rc = recv(sink_fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+		printf("rx: %s\n", osmo_hexdump_nospc(buf, rc));
+}
+
+static void print_ctrs(const struct gsmtap_inst *gti)
+{
+	unsigned int i;
+
+	for (i = 0; i < gti->ctrg->desc->num_ctr; i++)
+		printf("%s: %" PRIu64 "\n", gti->ctrg->desc->ctr_desc[i].name, gti->ctrg->ctr[i].current);
+}
+
+static void test_ring(uint16_t port)
+{
+	struct gsmtap_inst *gti;
+	uint8_t data[64];
+	unsigned int i;
+	int rc;
+
+	printf("=> Testing GSMTAP ring\n");
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = i;
+
+	gti = gsmtap_source_init_ring("127.0.0.1", port, 3, 32);
+	OSMO_ASSERT(gti);
+
+	/* drop ARFCN 10, sample every second other Um message */
+	OSMO_ASSERT(gsmtap_ring_add_rule(gti, GSMTAP_TYPE_UM, 10, 0) == 0);
+	OSMO_ASSERT(gsmtap_ring_add_rule(gti, GSMTAP_TYPE_UM, -1, 2) == 0);
+
+	for (i = 0; i < 6; i++)
+		gsmtap_send(gti, 20, 1, GSMTAP_CHANNEL_SDCCH4, 0, i, -60, 10, data, 4);
+	gsmtap_send(gti, 10 | GSMTAP_ARFCN_F_UPLINK, 1, GSMTAP_CHANNEL_SDCCH4, 0, 6, -60, 10, data, 4);
+	gsmtap_send_ex(gti, GSMTAP_TYPE_ABIS, 0, 0, GSMTAP_CHANNEL_BCCH, 0, 7, 0, 0, data, sizeof(data));
+	gsmtap_send_ex(gti, GSMTAP_TYPE_ABIS, 0, 0, GSMTAP_CHANNEL_BCCH, 0, 8, 0, 0, data, 2);
+	/* the ring of 4 slots is full now */
+	gsmtap_send_ex(gti, GSMTAP_TYPE_ABIS, 0, 0, GSMTAP_CHANNEL_BCCH, 0, 9, 0, 0, data, 2);
+
+	rc = gsmtap_ring_flush(gti);
+	printf("flushed %d\n", rc);
+	recv_all();
+
+	/* pre-built messages are copied into the ring and sent from the select loop */
+	gsmtap_sendmsg(gti, gsmtap_makemsg_ex(GSMTAP_TYPE_ABIS, 0, 0, GSMTAP_CHANNEL_BCCH, 0, 10, 0, 0, data, 3));
+	printf("write pending: %d\n", !!(gti->wq.bfd.when & OSMO_FD_WRITE));
+	osmo_select_main(1);
+	printf("write pending: %d\n", !!(gti->wq.bfd.when & OSMO_FD_WRITE));
+	recv_all();
+
+	print_ctrs(gti);
+}
+
+static const struct log_info info = {};
+
+int main(int argc, char **argv)
+{
+	struct sockaddr_in sin;
+	socklen_t sin_len = sizeof(sin);
+
+	osmo_init_logging2(NULL, &info);
+
+	sink_fd = osmo_sock_init(AF_INET, SOCK_DGRAM, IPPROTO_UDP, "127.0.0.1", 0, OSMO_SOCK_F_BIND);
+	OSMO_ASSERT(sink_fd >= 0);
+	OSMO_ASSERT(getsockname(sink_fd, (struct sockaddr *)&sin, &sin_len) == 0);
+
+	test_ring(ntohs(sin.sin_port));
+
+	close(sink_fd);
+	return 0;
+}
@@ -386,6 +386,31 @@ static void test_unused_subchan(void)
 	osmo_i460_subchan_del(&ts->schan[0]);
 }
 
+/* output buffer size not a multiple of the bits per input byte */
+static void test_odd_bufsize_subchan(void)
+{
+	struct osmo_i460_timeslot _ts, *ts = &_ts;
+	struct osmo_i460_schan_desc scd = scd32_0;
+
+	/* Initialization */
+	printf("\n==> %s\n", __func__);
+	osmo_i460_ts_init(ts);
+	scd.demux.num_bits = 7;
+	scd.demux.user_data = "32k_0_odd";
+	osmo_i460_subchan_add(NULL, ts, &scd);
+	scd = scd16_4;
+	scd.demux.num_bits = 3;
+	scd.demux.user_data = "16k_4_odd";
+	osmo_i460_subchan_add(NULL, ts, &scd);
+
+	/* demux */
+	const uint8_t sequence[] = { 0x1e, 0x23, 0xf7, 0x08, 0x5a, 0x30, 0xc1 };
+	osmo_i460_demux_in(ts, sequence, sizeof(sequence));
+
+	osmo_i460_subchan_del(&ts->schan[0]);
+	osmo_i460_subchan_del(&ts->schan[1]);
+}
+
 int main(int argc, char **argv)
 {
 	test_no_subchan();
@@ -394,4 +419,5 @@ int main(int argc, char **argv)
 	test_16k_subchan();
 	test_8k_subchan();
 	test_unused_subchan();
+	test_odd_bufsize_subchan();
 }
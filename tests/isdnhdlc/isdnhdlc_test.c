@@ -0,0 +1,140 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <osmocom/core/utils.h>
+#include <osmocom/core/isdnhdlc.h>
+
+#define MAX_FRAME_LEN	64
+
+/* simple deterministic pseudo-random byte generator */
+static uint32_t lcg_state;
+
+static uint8_t lcg_byte(void)
+{
+	lcg_state = lcg_state * 1103515245 + 12345;
+	return lcg_state >> 16;
+}
+
+/* generate a test frame; some frames consist of bytes which are heavy in
+ * '1' bits to exercise the bit stuffing */
+static void gen_frame(uint8_t *frame, unsigned int len, unsigned int idx)
+{
+	static const uint8_t ones_heavy[] = { 0xff, 0x7e, 0x3f, 0xfc, 0x7f, 0xfe, 0xbf, 0xf7 };
+	unsigned int i;
+
+	for (i = 0; i < len; i++) {
+		if (idx & 1)
+			frame[i] = ones_heavy[lcg_byte() % ARRAY_SIZE(ones_heavy)];
+		else
+			frame[i] = lcg_byte();
+	}
+}
+
+/* encode a single frame followed by a few bytes of inter-frame fill */
+static int encode_frame(struct osmo_isdnhdlc_vars *enc, const uint8_t *frame, unsigned int len,
+			uint8_t *out, int out_size)
+{
+	int count, rc, out_len = 0;
+
+	while (len > 0) {
+		rc = osmo_isdnhdlc_encode(enc, frame, len, &count, out + out_len, out_size - out_len);
+		OSMO_ASSERT(rc > 0 || count > 0);
+		frame += count;
+		len -= count;
+		out_len += rc;
+	}
+
+	rc = osmo_isdnhdlc_encode(enc, NULL, 0, &count, out + out_len, 3);
+	out_len += rc;
+
+	return out_len;
+}
+
+/* decode a stream in chunks of chunk_len bytes, print all frames / errors */
+static void decode_stream(uint32_t features, const uint8_t *stream, int stream_len, int chunk_len,
+			  int dsize)
+{
+	struct osmo_isdnhdlc_vars dec;
+	uint8_t out[MAX_FRAME_LEN * 2];
+	int offset = 0;
+
+	OSMO_ASSERT(dsize <= sizeof(out));
+	osmo_isdnhdlc_rcv_init(&dec, features);
+
+	while (offset < stream_len) {
+		int slen = OSMO_MIN(chunk_len, stream_len - offset);
+		while (slen > 0) {
+			int count, rc;
+			rc = osmo_isdnhdlc_decode(&dec, stream + offset, slen, &count, out, dsize);
+			offset += count;
+			slen -= count;
+			if (rc > 0)
+				printf("  frame at %d (%d): %s\n", offset, rc, osmo_hexdump_nospc(out, rc));
+			else if (rc < 0)
+				printf("  error at %d: %d\n", offset, rc);
+		}
+	}
+}
+
+static void test_features(const char *name, uint32_t features)
+{
+	struct osmo_isdnhdlc_vars enc;
+	uint8_t stream[16 * (MAX_FRAME_LEN * 2 + 8)];
+	uint8_t frame[MAX_FRAME_LEN];
+	int stream_len = 0, len, i;
+
+	printf("==> %s\n", name);
+	lcg_state = 0x23421337;
+
+	osmo_isdnhdlc_out_init(&enc, features);
+
+	for (i = 0; i < 16; i++) {
+		int frame_len = 1 + (i * 7) % MAX_FRAME_LEN;
+
+		gen_frame(frame, frame_len, i);
+		printf(" in (%d): %s\n", frame_len, osmo_hexdump_nospc(frame, frame_len));
+		len = encode_frame(&enc, frame, frame_len, stream + stream_len, sizeof(stream) - stream_len);
+		printf(" enc (%d): %s\n", len, osmo_hexdump_nospc(stream + stream_len, len));
+		stream_len += len;
+	}
+
+	printf(" decode in one go\n");
+	decode_stream(features, stream, stream_len, stream_len, MAX_FRAME_LEN * 2);
+	printf(" decode in chunks of 5 bytes\n");
+	decode_stream(features, stream, stream_len, 5, MAX_FRAME_LEN * 2);
+	printf(" decode with small destination buffer\n");
+	decode_stream(features, stream, stream_len, stream_len, 16);
+
+	/* flip some bits in the middle of the stream */
+	stream[stream_len / 3] ^= 0x10;
+	stream[stream_len / 2] ^= 0x81;
+	printf(" decode corrupted stream\n");
+	decode_stream(features, stream, stream_len, stream_len, MAX_FRAME_LEN * 2);
+}
+
+int main(int argc, char **argv)
+{
+	test_features("B-channel", 0);
+	test_features("B-channel, bit-reverse", OSMO_HDLC_F_BITREVERSE);
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <osmocom/core/application.h>
+#include <osmocom/core/logging.h>
+#include <osmocom/core/loop_stats.h>
+#include <osmocom/core/select.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+
+static struct osmo_fd pipe_ofd;
+static struct osmo_timer_list slow_timer;
+
+/* pretend each read takes 300us */
+static int pipe_cb(struct osmo_fd *ofd, unsigned int what)
+{
+	uint8_t b;
+
+	OSMO_ASSERT(read(ofd->fd, &b, 1) == 1);
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 300 * 1000);
+	return 0;
+}
+
+/* and the timer 5ms */
+static void slow_timer_cb(void *data)
+{
+	osmo_clock_override_add(CLOCK_MONOTONIC, 0, 5000 * 1000);
+}
+
+static const char *cb_name(const struct osmo_loop_cb_stats *cs)
+{
+	if (cs->cb == (const void *)pipe_cb)
+		return "pipe_cb";
+	if (cs->cb == (const void *)slow_timer_cb)
+		return "slow_timer_cb";
+	return "unknown";
+}
+
+static void print_hist(const uint32_t *hist)
+{
+	unsigned int i;
+
+	for (i = 0; i < OSMO_LOOP_STATS_HIST_BUCKETS; i++) {
+		if (hist[i])
+			printf(" [%u]=%u", i, hist[i]);
+	}
+	printf("\n");
+}
+
+static void print_stats(void)
+{
+	const struct osmo_loop_stats *ls = osmo_loop_stats_get();
+	unsigned int i;
+
+	printf("iterations=%" PRIu64 " busy=%" PRIu64 " busy_max=%u wait=%" PRIu64 " slow=%" PRIu64 " untracked=%" PRIu64 "\n",
+	       ls->iterations, ls->busy_us, ls->busy_max_us, ls->wait_us, ls->slow, ls->untracked);
+	printf("busy hist:");
+	print_hist(ls->busy_hist);
+
+	for (i = 0; i < OSMO_LOOP_STATS_MAX_CBS; i++) {
+		const struct osmo_loop_cb_stats *cs = &ls->cbs[i];
+		if (!cs->count)
+			continue;
+		printf("%s %s%s: count=%" PRIu64 " total=%" PRIu64 " max=%u slow=%u hist:",
+		       cs->type == OSMO_LOOP_CB_FD ? "fd" : "timer", cb_name(cs),
+		       cs->type == OSMO_LOOP_CB_FD && cs->fd == pipe_ofd.fd ? " (pipe)" : "",
+		       cs->count, cs->total_us, cs->max_us, cs->slow);
+		print_hist(cs->hist);
+	}
+}
+
+static void test_loop_stats(void)
+{
+	int fds[2], i;
+
+	printf("=> Testing main loop profiling\n");
+
+	osmo_clock_override_enable(CLOCK_MONOTONIC, true);
+	osmo_gettimeofday_override = true;
+	osmo_gettimeofday_override_time = (struct timeval){ 1000, 0 };
+
+	OSMO_ASSERT(pipe(fds) == 0);
+	osmo_fd_setup(&pipe_ofd, fds[0], OSMO_FD_READ, pipe_cb, NULL, 0);
+	OSMO_ASSERT(osmo_fd_register(&pipe_ofd) == 0);
+	osmo_timer_setup(&slow_timer, slow_timer_cb, NULL);
+
+	/* nothing is recorded while disabled */
+	OSMO_ASSERT(write(fds[1], "x", 1) == 1);
+	osmo_select_main(1);
+	printf("disabled: %s\n", osmo_loop_stats_get() ? "stats" : "no stats");
+
+	OSMO_ASSERT(osmo_loop_stats_enable(NULL, 1000) == 0);
+	OSMO_ASSERT(osmo_loop_stats_enabled());
+
+	for (i = 0; i < 3; i++) {
+		OSMO_ASSERT(write(fds[1], "x", 1) == 1);
+		if (i == 1)
+			osmo_timer_schedule(&slow_timer, 0, 0);
+		osmo_select_main(1);
+	}
+	/* an idle iteration */
+	osmo_select_main(1);
+	print_stats();
+
+	printf("reset\n");
+	osmo_loop_stats_reset();
+	OSMO_ASSERT(write(fds[1], "x", 1) == 1);
+	osmo_select_main(1);
+	print_stats();
+
+	osmo_loop_stats_disable();
+	OSMO_ASSERT(!osmo_loop_stats_enabled());
+	OSMO_ASSERT(write(fds[1], "x", 1) == 1);
+	osmo_select_main(1);
+	printf("disabled again: %s\n", osmo_loop_stats_get() ? "stats" : "no stats");
+
+	osmo_fd_unregister(&pipe_ofd);
+	close(fds[0]);
+	close(fds[1]);
+}
+
+static const struct log_info info = {};
+
+int main(int argc, char **argv)
+{
+	osmo_init_logging2(NULL, &info);
+
+	test_loop_stats();
+
+	return 0;
+}
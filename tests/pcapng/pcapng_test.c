@@ -0,0 +1,141 @@
+/*
+ * (C) 2026 by sysmocom - s.f.m.c. GmbH <info@sysmocom.de>
+ *
+ * All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+
+#include <osmocom/core/gsmtap.h>
+#include <osmocom/core/gsmtap_util.h>
+#include <osmocom/core/pcapng.h>
+#include <osmocom/core/talloc.h>
+#include <osmocom/core/timer.h>
+#include <osmocom/core/utils.h>
+
+static char dir[] = "/tmp/pcapng_test.XXXXXX";
+
+/* print and remove a capture file */
+static void dump_file(const char *name)
+{
+	char path[256];
+	uint8_t buf[512];
+	int fd, rc, i;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("%s: missing\n", name);
+		return;
+	}
+	rc = read(fd, buf, sizeof(buf));
+	close(fd);
+	unlink(path);
+
+	printf("%s: %d bytes\n", name, rc);
+	/* 16 bytes per line */
+	for (i = 0; i < rc; i += 16)
+		printf("  %s\n", osmo_hexdump_nospc(buf + i, rc - i < 16 ? rc - i : 16));
+}
+
+static void print_stats(struct osmo_pcapng_writer *w)
+{
+	struct osmo_pcapng_stats st;
+
+	osmo_pcapng_writer_get_stats(w, &st);
+	printf("packets=%" PRIu64 " bytes=%" PRIu64 " dropped=%" PRIu64 " write_errors=%" PRIu64 " files=%u\n",
+	       st.packets, st.bytes, st.dropped, st.write_errors, st.files);
+}
+
+static void test_rotation(void)
+{
+	const struct sockaddr_in src = {
+		.sin_family = AF_INET,
+		.sin_port = htons(23000),
+		.sin_addr.s_addr = htonl(0x0a000001),
+	};
+	const struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(23001),
+		.sin_addr.s_addr = htonl(0x0a000002),
+	};
+	const uint8_t ns_alive[] = { 0x0a };
+	const uint8_t raw[] = { 0xde, 0xad, 0xbe, 0xef, 0x42 };
+	struct osmo_pcapng_writer *w;
+	char path[256];
+	int i;
+
+	printf("=> Testing file rotation\n");
+
+	snprintf(path, sizeof(path), "%s/rot.pcapng", dir);
+	/* room for the headers and two packets per file, keep two files */
+	w = osmo_pcapng_writer_alloc(NULL, path, 28 + 2 * 20 + 2 * 64, 2);
+	OSMO_ASSERT(w);
+
+	for (i = 0; i < 3; i++) {
+		OSMO_ASSERT(osmo_pcapng_write_udp4(w, &src, &dst, ns_alive, sizeof(ns_alive)) == 0);
+		OSMO_ASSERT(osmo_pcapng_write(w, 147, raw, sizeof(raw)) == 0);
+		osmo_gettimeofday_override_add(0, 1000);
+		osmo_pcapng_writer_sync(w);
+	}
+	print_stats(w);
+	osmo_pcapng_writer_free(w);
+
+	dump_file("rot.pcapng.0");
+	dump_file("rot.pcapng.1");
+	dump_file("rot.pcapng.2");
+}
+
+static void test_gsmtap(void)
+{
+	struct gsmtap_inst *gti;
+	const uint8_t data[] = { 0x01, 0x02, 0x03 };
+	char path[256];
+
+	printf("=> Testing GSMTAP into PCAP-NG\n");
+
+	snprintf(path, sizeof(path), "%s/gsmtap.pcapng", dir);
+	gti = gsmtap_source_init_pcapng(path, 0, 0);
+	OSMO_ASSERT(gti);
+	printf("fd: %d\n", gsmtap_inst_fd(gti));
+
+	gsmtap_send(gti, 42, 3, GSMTAP_CHANNEL_SDCCH8, 1, 1234, -70, 20, data, sizeof(data));
+	print_stats(gti->pcapng);
+	osmo_pcapng_writer_free(gti->pcapng);
+	talloc_free(gti);
+
+	dump_file("gsmtap.pcapng");
+}
+
+int main(int argc, char **argv)
+{
+	OSMO_ASSERT(mkdtemp(dir));
+
+	osmo_gettimeofday_override = true;
+	osmo_gettimeofday_override_time = (struct timeval){ .tv_sec = 1700000000, .tv_usec = 0 };
+
+	test_rotation();
+	test_gsmtap();
+
+	rmdir(dir);
+	return 0;
+}
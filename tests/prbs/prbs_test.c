@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <osmocom/core/utils.h>
 #include <osmocom/core/prbs.h>
 
 static void dump_bits(const ubit_t *bits, unsigned int num_bits)
@@ -36,6 +37,90 @@ static void test_prbs(const struct osmo_prbs *prbs)
 	printf("\n");
 }
 
+static void test_prbs_pbits(const struct osmo_prbs *prbs)
+{
+	static const unsigned int lengths[] = { 1, 7, 8, 63, 64, 65, 200, 1000 };
+	struct osmo_prbs_state st_u, st_p;
+	unsigned int i, j;
+
+	printf("Testing packed PRBS sequence generation '%s'\n", prbs->name);
+	osmo_prbs_state_init(&st_u, prbs);
+	osmo_prbs_state_init(&st_p, prbs);
+
+	for (i = 0; i < ARRAY_SIZE(lengths); i++) {
+		unsigned int num_bits = lengths[i];
+		ubit_t ubits[num_bits];
+		pbit_t expected[(num_bits + 7) / 8];
+		pbit_t pbits[(num_bits + 7) / 8];
+
+		for (j = 0; j < 3; j++) {
+			osmo_prbs_get_ubits(ubits, num_bits, &st_u);
+			memset(expected, 0, sizeof(expected));
+			osmo_ubit2pbit(expected, ubits, num_bits);
+			memset(pbits, 0xff, sizeof(pbits));
+			osmo_prbs_get_pbits(pbits, num_bits, &st_p);
+			if (memcmp(pbits, expected, sizeof(pbits)))
+				printf("%u bits: mismatch\n", num_bits);
+		}
+	}
+	OSMO_ASSERT(st_u.state == st_p.state);
+	printf("\n");
+}
+
+static void print_ber(const struct osmo_prbs_ber *ber)
+{
+	printf(" locked=%d bits=%llu errors=%llu sync_loss=%u\n", ber->locked,
+	       (unsigned long long)ber->num_bits, (unsigned long long)ber->num_errors,
+	       ber->num_sync_loss);
+}
+
+static void test_prbs_ber(const struct osmo_prbs *prbs)
+{
+	struct osmo_prbs_state st;
+	struct osmo_prbs_ber ber, ber_u;
+	pbit_t pbits[1024];
+	ubit_t ubits[sizeof(pbits) * 8];
+	unsigned int i;
+
+	printf("Testing PRBS BER checker '%s'\n", prbs->name);
+	osmo_prbs_state_init(&st, prbs);
+	osmo_prbs_ber_init(&ber, prbs);
+	osmo_prbs_ber_init(&ber_u, prbs);
+
+	/* start somewhere in the middle of the sequence */
+	for (i = 0; i < 1234; i++)
+		osmo_prbs_get_ubit(&st);
+
+	printf("error-free:\n");
+	osmo_prbs_get_pbits(pbits, sizeof(pbits) * 8, &st);
+	/* misaligned length, to get the checker off byte boundaries */
+	osmo_prbs_ber_rx_pbits(&ber, pbits, 8 * 100 + 3);
+	osmo_prbs_ber_rx_pbits(&ber, pbits, 0);
+	print_ber(&ber);
+
+	printf("bit errors:\n");
+	osmo_prbs_get_pbits(pbits, sizeof(pbits) * 8, &st);
+	pbits[10] ^= 0x01;
+	pbits[500] ^= 0x81;
+	pbits[1000] ^= 0xff;
+	osmo_pbit2ubit(ubits, pbits, sizeof(ubits));
+	osmo_prbs_ber_rx_pbits(&ber_u, pbits, 0);
+	osmo_prbs_ber_rx_ubits(&ber_u, ubits, sizeof(ubits));
+	print_ber(&ber_u);
+
+	printf("all-zero input:\n");
+	memset(pbits, 0, sizeof(pbits));
+	osmo_prbs_ber_rx_pbits(&ber_u, pbits, sizeof(pbits) * 8);
+	print_ber(&ber_u);
+
+	printf("resynchronization:\n");
+	osmo_prbs_get_pbits(pbits, sizeof(pbits) * 8, &st);
+	osmo_prbs_ber_rx_pbits(&ber_u, pbits, sizeof(pbits) * 8);
+	print_ber(&ber_u);
+
+	printf("\n");
+}
+
 int main(int argc, char **argv)
 {
 	test_prbs(&osmo_prbs7);
@@ -43,5 +128,15 @@ int main(int argc, char **argv)
 	test_prbs(&osmo_prbs11);
 	test_prbs(&osmo_prbs15);
 
+	test_prbs_pbits(&osmo_prbs7);
+	test_prbs_pbits(&osmo_prbs9);
+	test_prbs_pbits(&osmo_prbs11);
+	test_prbs_pbits(&osmo_prbs15);
+
+	test_prbs_ber(&osmo_prbs7);
+	test_prbs_ber(&osmo_prbs9);
+	test_prbs_ber(&osmo_prbs11);
+	test_prbs_ber(&osmo_prbs15);
+
 	exit(0);
 }
@@ -268,6 +268,52 @@ static void test_gen_oa(void)
 	printf("Result: len(%d) data(%s)\n", len, osmo_hexdump(oa, len));
 }
 
+static void test_ucs2(void)
+{
+	uint8_t ucs2[32];
+	char text[16];
+	int len;
+
+	printf("Testing UCS2 detection and transcoding\n");
+
+	printf("septets(\"test1234\"): %d\n", gsm_septet_count("test1234"));
+	printf("septets(\"a{b}\"): %d\n", gsm_septet_count("a{b}"));
+	printf("septets(\"\\xb5m\"): %d\n", gsm_septet_count("\xb5m"));
+
+	len = gsm_ucs2_encode_n(ucs2, sizeof(ucs2), "\xb5m OK");
+	printf("Result: len(%d) data(%s)\n", len, osmo_hexdump(ucs2, len));
+	len = gsm_ucs2_encode_n(ucs2, 5, "\xb5m OK");
+	printf("Result: len(%d) data(%s)\n", len, osmo_hexdump(ucs2, len));
+
+	/* U+20AC EURO SIGN is not part of latin1 */
+	memcpy(ucs2 + 4, "\x20\xac", 2);
+	len = gsm_ucs2_decode_n(text, sizeof(text), ucs2, 8);
+	printf("Decoded: len(%d) text(%s)\n", len, osmo_quote_str(text, len));
+	len = gsm_ucs2_decode_n(text, 3, ucs2, 8);
+	printf("Decoded: len(%d) text(%s)\n", len, osmo_quote_str(text, len));
+}
+
+/* packing must not be limited to 255 septets */
+static void test_long_encode(void)
+{
+	char input[301], result[301];
+	uint8_t coded[300];
+	int i, oct, septets, nchars;
+
+	printf("Testing encoding of long texts\n");
+
+	for (i = 0; i < 300; i++)
+		input[i] = 'a' + i % 26;
+	input[300] = '\0';
+
+	septets = gsm_7bit_encode_n(coded, sizeof(coded), input, &oct);
+	printf("SEPTETS: %d OCTETS: %d\n", septets, oct);
+	OSMO_ASSERT(septets == 300 && oct == (300 * 7 + 7) / 8);
+
+	nchars = gsm_7bit_decode_n(result, sizeof(result), coded, 255);
+	OSMO_ASSERT(nchars == 255 && memcmp(result, input, nchars) == 0);
+}
+
 int main(int argc, char** argv)
 {
 	printf("SMS testing\n");
@@ -396,6 +442,8 @@ int main(int argc, char** argv)
 
 	test_octet_return();
 	test_gen_oa();
+	test_ucs2();
+	test_long_encode();
 
 	printf("OK\n");
 	return 0;
@@ -23,6 +23,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <errno.h>
 
 #include <sys/socket.h>
 #include <arpa/inet.h>
@@ -75,6 +76,39 @@ static int test_sockinit(void)
 	return 0;
 }
 
+static void test_sockinit_reuseport(void)
+{
+	struct sockaddr_in sin;
+	socklen_t sin_len = sizeof(sin);
+	int fd, fd2, fd3, rc;
+
+	printf("Checking for OSMO_SOCK_F_REUSEPORT\n");
+	fd = osmo_sock_init(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+			    "127.0.0.1", 0, OSMO_SOCK_F_BIND|OSMO_SOCK_F_REUSEPORT);
+	OSMO_ASSERT(fd >= 0);
+	OSMO_ASSERT(getsockname(fd, (struct sockaddr *)&sin, &sin_len) == 0);
+
+	/* a second socket can be bound to the same port */
+	fd2 = osmo_sock_init2(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+			      "127.0.0.1", ntohs(sin.sin_port), NULL, 0,
+			      OSMO_SOCK_F_BIND|OSMO_SOCK_F_REUSEPORT);
+	OSMO_ASSERT(fd2 >= 0);
+
+	/* and another one through osmo_sock_init_sa() */
+	fd3 = osmo_sock_init_sa((struct sockaddr *)&sin, SOCK_DGRAM, IPPROTO_UDP,
+				OSMO_SOCK_F_BIND|OSMO_SOCK_F_REUSEPORT);
+	OSMO_ASSERT(fd3 >= 0);
+
+	/* not applicable to unix domain sockets */
+	rc = osmo_sock_unix_init(SOCK_DGRAM, 0, "/tmp/osmo_sock_reuseport_test",
+				 OSMO_SOCK_F_BIND|OSMO_SOCK_F_REUSEPORT);
+	OSMO_ASSERT(rc == -EINVAL);
+
+	close(fd3);
+	close(fd2);
+	close(fd);
+}
+
 static int test_sockinit2(void)
 {
 	int fd, rc;
@@ -143,6 +177,7 @@ int main(int argc, char *argv[])
 
 	test_sockinit();
 	test_sockinit2();
+	test_sockinit_reuseport();
 
 	return EXIT_SUCCESS;
 }
@@ -22,6 +22,9 @@
 
 #include <osmocom/gsm/ipa.h>
 #include <osmocom/gsm/protocol/ipaccess.h>
+#include <osmocom/gsm/gsm_utils.h>
+#include <osmocom/gsm/gsm48.h>
+#include <osmocom/gsm/gsup.h>
 
 #include <osmocom/core/logging.h>
 #include <osmocom/core/utils.h>
@@ -34,6 +37,8 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <limits.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 static void hexdump_test(void)
 {
@@ -1357,6 +1362,308 @@ static void osmo_strnchr_test(void)
 	}
 }
 
+static void rand_test(void)
+{
+	uint8_t a[16], b[16], bulk[4096], zero[sizeof(bulk)] = {};
+	int fds[2];
+	pid_t pid;
+	int rc;
+
+	printf("\n%s\n", __func__);
+
+	rc = osmo_get_rand_id(a, sizeof(a));
+	printf("osmo_get_rand_id(16) = %d\n", rc);
+	rc = osmo_get_rand_id(a, OSMO_MAX_RAND_ID_LEN + 1);
+	printf("osmo_get_rand_id(17) = %s\n", rc == -E2BIG ? "-E2BIG" : "unexpected");
+
+	/* the bulk output spans several refills of the keystream buffer */
+	rc = osmo_get_rand(bulk, sizeof(bulk));
+	printf("osmo_get_rand(%zu) = %d\n", sizeof(bulk), rc);
+	OSMO_ASSERT(memcmp(bulk, zero, sizeof(bulk)) != 0);
+	OSMO_ASSERT(memcmp(bulk, bulk + sizeof(bulk) / 2, sizeof(bulk) / 2) != 0);
+
+	/* parent and child must not produce the same output after fork() */
+	OSMO_ASSERT(pipe(fds) == 0);
+	pid = fork();
+	OSMO_ASSERT(pid >= 0);
+	if (pid == 0) {
+		OSMO_ASSERT(osmo_get_rand_id(a, sizeof(a)) == 0);
+		OSMO_ASSERT(write(fds[1], a, sizeof(a)) == sizeof(a));
+		_exit(0);
+	}
+	OSMO_ASSERT(osmo_get_rand_id(a, sizeof(a)) == 0);
+	OSMO_ASSERT(read(fds[0], b, sizeof(b)) == sizeof(b));
+	waitpid(pid, NULL, 0);
+	close(fds[0]);
+	close(fds[1]);
+	printf("parent and child output differ: %s\n", memcmp(a, b, sizeof(a)) ? "yes" : "no");
+}
+
+static const char *vs_ref_name(const struct value_string *vs, uint32_t val)
+{
+	for (; vs->value || vs->str; vs++) {
+		if (vs->value == val)
+			return vs->str;
+	}
+	return NULL;
+}
+
+static int vs_ref_value(const struct value_string *vs, const char *str)
+{
+	for (; vs->value || vs->str; vs++) {
+		if (!strcasecmp(vs->str, str))
+			return vs->value;
+	}
+	return -EINVAL;
+}
+
+/* compare the indexed lookups against a linear search for values 0..max_val and all strings */
+static unsigned int vs_check(const struct value_string *vs, uint32_t max_val)
+{
+	const struct value_string *e;
+	unsigned int mismatch = 0;
+	uint32_t v;
+
+	for (v = 0; v <= max_val; v++) {
+		if (get_value_string_or_null(vs, v) != vs_ref_name(vs, v))
+			mismatch++;
+	}
+	for (e = vs; e->value || e->str; e++) {
+		if (get_value_string_or_null(vs, e->value) != vs_ref_name(vs, e->value))
+			mismatch++;
+		if (get_string_value(vs, e->str) != vs_ref_value(vs, e->str))
+			mismatch++;
+	}
+	return mismatch;
+}
+
+static void value_string_index_test(void)
+{
+	static const struct value_string dense[] = {
+		{ 3, "three" }, { 1, "one" }, { 2, "two" }, { 4, "four" },
+		{ 5, "five" }, { 6, "six" }, { 7, "seven" }, { 2, "two again" },
+		{ 9, "nine" }, { 10, "ten" }, { 12, "Twelve" }, { 13, "twelve" },
+		{ 0, "zero" },
+		{ 0, NULL }
+	};
+	static const struct value_string sparse[] = {
+		{ 0xffffffff, "max" }, { 1, "one" }, { 100, "hundred" }, { 0x10000, "64k" },
+		{ 7, "seven" }, { 1000, "thousand" }, { 100, "another hundred" }, { 0x7fffffff, "int max" },
+		{ 50, "fifty" },
+		{ 0, NULL }
+	};
+	static const struct value_string small[] = {
+		{ 1, "one" }, { 2, "two" },
+		{ 0, NULL }
+	};
+	struct value_string regen[16];
+	unsigned int i;
+
+	printf("\n%s\n", __func__);
+
+	printf("index dense: %d, sparse: %d, small: %d, again: %d, NULL: %d\n", value_string_index(dense),
+	       value_string_index(sparse), value_string_index(small), value_string_index(dense),
+	       value_string_index(NULL));
+
+	printf("indexed dense: %d, small: %d, regen: %d\n", value_string_indexed(dense),
+	       value_string_indexed(small), value_string_indexed(regen));
+
+	/* the name tables of the libraries are indexed when they are loaded */
+	printf("indexed gsm48_rr_msgtype_names: %d, osmo_gsup_message_type_names: %d\n",
+	       value_string_indexed(gsm48_rr_msgtype_names), value_string_indexed(osmo_gsup_message_type_names));
+	printf("gsm48_rr_msgtype_names: %u mismatches, osmo_gsup_message_type_names: %u mismatches\n",
+	       vs_check(gsm48_rr_msgtype_names, 0x100), vs_check(osmo_gsup_message_type_names, 0x100));
+	printf("%s, %s\n", gsm48_pdisc_msgtype_name(GSM48_PDISC_RR, GSM48_MT_RR_PAG_REQ_1),
+	       osmo_gsup_message_type_name(OSMO_GSUP_MSGT_UPDATE_LOCATION_REQUEST));
+
+	printf("dense: %u mismatches\n", vs_check(dense, 20));
+	printf("sparse: %u mismatches\n", vs_check(sparse, 2000));
+	printf("small: %u mismatches\n", vs_check(small, 4));
+
+	printf("dense 2: %s, 11: %s, 0: %s\n", get_value_string(dense, 2), get_value_string(dense, 11),
+	       get_value_string(dense, 0));
+	printf("sparse 100: %s, 0xffffffff: %s, 0x10001: %s\n", get_value_string(sparse, 100),
+	       get_value_string(sparse, 0xffffffff), get_value_string(sparse, 0x10001));
+	printf("\"TWELVE\" = %d, \"Two Again\" = %d, \"eleven\" = %d\n", get_string_value(dense, "TWELVE"),
+	       get_string_value(dense, "Two Again"), get_string_value(dense, "eleven"));
+	printf("\"64K\" = %d, \"none\" = %d\n", get_string_value(sparse, "64K"), get_string_value(sparse, "none"));
+	printf("NULL array: %s\n", get_value_string_or_null(NULL, 1) ? "found" : "NULL");
+
+	/* an array that is not indexed may be re-generated at the same address */
+	for (i = 0; i < 10; i++)
+		regen[i] = (struct value_string){ i + 1, dense[i].str };
+	regen[10] = (struct value_string){ 0, NULL };
+	printf("regen: %u mismatches\n", vs_check(regen, 20));
+	regen[4].value = 15;
+	printf("regen with changed value: %u mismatches\n", vs_check(regen, 20));
+	regen[10] = (struct value_string){ 11, "eleven" };
+	regen[11] = (struct value_string){ 0, NULL };
+	printf("regen with more entries: %u mismatches, 11: %s\n", vs_check(regen, 20),
+	       get_value_string(regen, 11));
+	regen[3] = (struct value_string){ 0, NULL };
+	printf("regen with fewer entries: %u mismatches, 11: %s\n", vs_check(regen, 20),
+	       get_value_string(regen, 11));
+}
+
+/* the byte-at-a-time implementations, as reference for the accelerated ones */
+static const char *ref_hexdump_buf(char *out_buf, size_t out_buf_size, const unsigned char *buf, int len,
+				   const char *delim, bool delim_after_last)
+{
+	static const char hex_chars[] = "0123456789abcdef";
+	int i;
+	char *cur = out_buf;
+	size_t delim_len;
+
+	if (!out_buf || !out_buf_size)
+		return "";
+
+	delim = delim ? : "";
+	delim_len = strlen(delim);
+
+	for (i = 0; i < len; i++) {
+		const char *delimp = delim;
+		int len_remain = out_buf_size - (cur - out_buf) - 1;
+		if (len_remain < (2 + delim_len)
+		    && !(!delim_after_last && i == (len - 1) && len_remain >= 2))
+			break;
+
+		*cur++ = hex_chars[buf[i] >> 4];
+		*cur++ = hex_chars[buf[i] & 0xf];
+
+		if (i == (len - 1) && !delim_after_last)
+			break;
+
+		while (len_remain > 1 && *delimp) {
+			*cur++ = *delimp++;
+			len_remain--;
+		}
+	}
+	*cur = '\0';
+	return out_buf;
+}
+
+static int ref_hexparse(const char *str, uint8_t *b, int max_len)
+{
+	char c;
+	uint8_t v;
+	const char *strpos;
+	unsigned int nibblepos = 0;
+
+	memset(b, 0x00, max_len);
+
+	for (strpos = str; (c = *strpos); strpos++) {
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+			continue;
+		if (nibblepos >= (max_len << 1))
+			return -1;
+		if (c >= '0' && c <= '9')
+			v = c - '0';
+		else if (c >= 'a' && c <= 'f')
+			v = 10 + (c - 'a');
+		else if (c >= 'A' && c <= 'F')
+			v = 10 + (c - 'A');
+		else
+			return -1;
+		b[nibblepos >> 1] |= v << (nibblepos & 1 ? 0 : 4);
+		nibblepos ++;
+	}
+	if (nibblepos & 1)
+		return -1;
+	return nibblepos >> 1;
+}
+
+static uint32_t hex_accel_rand_state = 1;
+
+static uint32_t hex_accel_rand(void)
+{
+	hex_accel_rand_state = hex_accel_rand_state * 1103515245 + 12345;
+	return hex_accel_rand_state >> 8;
+}
+
+static void hex_accel_test(void)
+{
+	static const char *delims[] = { NULL, "", " ", ":", " - " };
+	static const char noise[] = "0aF \t\n\rgG:x\x80\xff";
+	uint8_t data[300], parsed[300], ref_parsed[300];
+	char out[1024], ref_out[1024], str[1024];
+	unsigned int len, d, i, dump_mismatch = 0, parse_mismatch = 0, ubit_mismatch = 0, cases = 0;
+
+	printf("\n%s\n", __func__);
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = hex_accel_rand();
+
+	for (len = 0; len < 200; len++) {
+		for (d = 0; d < ARRAY_SIZE(delims); d++) {
+			size_t sizes[] = { 1, 2, 3, 2 * len, 2 * len + 1, 3 * len, 3 * len + 1, 3 * len + 2,
+					   5 * len + 1, sizeof(out), hex_accel_rand() % sizeof(out) + 1 };
+			unsigned int k, dal;
+
+			for (k = 0; k < ARRAY_SIZE(sizes); k++) {
+				if (!sizes[k] || sizes[k] > sizeof(out))
+					continue;
+				for (dal = 0; dal < 2; dal++) {
+					memset(out, 'X', sizeof(out));
+					memset(ref_out, 'X', sizeof(ref_out));
+					osmo_hexdump_buf(out, sizes[k], data, len, delims[d], dal);
+					ref_hexdump_buf(ref_out, sizes[k], data, len, delims[d], dal);
+					if (memcmp(out, ref_out, sizeof(out)))
+						dump_mismatch++;
+					cases++;
+				}
+			}
+		}
+
+		/* parse dumps of all kinds, some with upper case digits or a noise character inserted */
+		for (d = 0; d < 8; d++) {
+			int max_len = (d == 7) ? len / 2 : len + (d & 1);
+			int rc, ref_rc;
+
+			osmo_hexdump_buf(str, sizeof(str), data, len, d & 2 ? " " : "", false);
+			if (d & 4) {
+				for (i = 0; str[i]; i++) {
+					if (hex_accel_rand() % 3 == 0)
+						str[i] = toupper(str[i]);
+				}
+			}
+			if (d == 5 && len) {
+				i = hex_accel_rand() % strlen(str);
+				str[i] = noise[hex_accel_rand() % (sizeof(noise) - 1)];
+			}
+			memset(parsed, 0xaa, sizeof(parsed));
+			memset(ref_parsed, 0xaa, sizeof(ref_parsed));
+			rc = osmo_hexparse(str, parsed, max_len);
+			ref_rc = ref_hexparse(str, ref_parsed, max_len);
+			if (rc != ref_rc || memcmp(parsed, ref_parsed, sizeof(parsed)))
+				parse_mismatch++;
+			cases++;
+		}
+
+		/* unpacked bits */
+		{
+			uint8_t bits[200];
+			for (i = 0; i < len; i++)
+				bits[i] = (i % 7 == 3) ? data[i] : data[i] & 1;
+			bits[len / 2] = 0xff;
+			for (d = 1; d < len + 3; d += 1 + d / 4) {
+				memset(out, 'X', sizeof(out));
+				osmo_ubit_dump_buf(out, d, bits, len);
+				for (i = 0; i < len && i < d - 1; i++) {
+					char c = bits[i] == 0 ? '0' : bits[i] == 1 ? '1' : bits[i] == 0xff ? '?' : 'E';
+					if (out[i] != c)
+						break;
+				}
+				if (i != OSMO_MIN(len, d - 1) || out[i] != '\0')
+					ubit_mismatch++;
+				cases++;
+			}
+		}
+	}
+
+	printf("%s cases: hexdump %u, hexparse %u, ubit_dump %u mismatches\n", cases > 10000 ? ">10000" : "few",
+	       dump_mismatch, parse_mismatch, ubit_mismatch);
+}
+
 int main(int argc, char **argv)
 {
 	static const struct log_info log_info = {};
@@ -1382,5 +1689,8 @@ int main(int argc, char **argv)
 	name_c_impl_test();
 	osmo_print_n_test();
 	osmo_strnchr_test();
+	rand_test();
+	value_string_index_test();
+	hex_accel_test();
 	return 0;
 }